@@ -1,75 +1,936 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // for mremap
+#endif
+
 #include "./Vec.h"
+#include <limits.h>  // for CHAR_BIT
+#include <malloc.h>  // for malloc_usable_size
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "./panic.h"
 
+// Buffers of at least VEC_MMAP_THRESHOLD bytes live in their own anonymous
+// mapping so that growing them is a page remap rather than a copy.
+static bool vec_buf_is_mapped(size_t capacity) {
+#ifdef VEC_DISABLE_MMAP
+  (void)capacity;
+  return false;
+#else
+  return capacity * sizeof(ptr_t) >= VEC_MMAP_THRESHOLD;
+#endif
+}
+
+static ptr_t* vec_buf_alloc(size_t capacity) {
+  if (capacity == 0 || capacity > SIZE_MAX / sizeof(ptr_t)) {
+    return NULL;
+  }
+
+  if (!vec_buf_is_mapped(capacity)) {
+    return (ptr_t*)malloc(capacity * sizeof(ptr_t));
+  }
+
+  void* mem = mmap(NULL, capacity * sizeof(ptr_t), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return mem == MAP_FAILED ? NULL : (ptr_t*)mem;
+}
+
+static void vec_buf_free(ptr_t* data, size_t capacity) {
+  if (data == NULL) {
+    return;
+  }
+
+  if (vec_buf_is_mapped(capacity)) {
+    munmap(data, capacity * sizeof(ptr_t));
+  } else {
+    free(data);
+  }
+}
+
+// Moves the first `length` elements of `data` (sized for old_capacity) into a
+// buffer that can hold new_capacity elements. Returns NULL on failure, in
+// which case `data` is left untouched.
+static ptr_t* vec_buf_realloc(ptr_t* data,
+                              size_t length,
+                              size_t old_capacity,
+                              size_t new_capacity) {
+  if (new_capacity > SIZE_MAX / sizeof(ptr_t)) {
+    return NULL;
+  }
+
+  bool old_mapped = vec_buf_is_mapped(old_capacity);
+  bool new_mapped = vec_buf_is_mapped(new_capacity);
+
+  if (data != NULL && old_mapped && new_mapped) {
+    void* mem = mremap(data, old_capacity * sizeof(ptr_t),
+                       new_capacity * sizeof(ptr_t), MREMAP_MAYMOVE);
+    return mem == MAP_FAILED ? NULL : (ptr_t*)mem;
+  }
+
+  if (!old_mapped && !new_mapped) {
+    // realloc can often extend the block in place
+    return (ptr_t*)realloc(data, new_capacity * sizeof(ptr_t));
+  }
+
+  ptr_t* new_data = vec_buf_alloc(new_capacity);
+  if (new_data == NULL) {
+    return NULL;
+  }
+
+  if (length > 0) {
+    memcpy(new_data, data, length * sizeof(ptr_t));
+  }
+  vec_buf_free(data, old_capacity);
+  return new_data;
+}
+
+// Returns how many elements the buffer backing `capacity` elements can
+// really hold. Never crosses VEC_MMAP_THRESHOLD, since the capacity is also
+// what tells vec_buf_free how the buffer was allocated.
+static size_t vec_buf_usable(ptr_t* data, size_t capacity) {
+  if (data == NULL) {
+    return capacity;
+  }
+
+  size_t usable = capacity;
+  if (vec_buf_is_mapped(capacity)) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    size_t bytes = capacity * sizeof(ptr_t);
+    usable = ((bytes + page_size - 1) / page_size * page_size) / sizeof(ptr_t);
+  } else {
+    usable = malloc_usable_size(data) / sizeof(ptr_t);
+    if (vec_buf_is_mapped(usable)) {
+      usable = capacity;
+    }
+  }
+
+  return usable > capacity ? usable : capacity;
+}
+
+// Makes room for at least `needed` elements with at most one reallocation,
+// growing as the vector's policy says.
+static void vec_reserve(Vec* self, size_t needed) {
+  if (needed <= self->capacity) {
+    return;
+  }
+
+  vec_resize(self, growth_next_capacity(&self->policy, self->capacity, needed,
+                                        sizeof(ptr_t)));
+}
+
+// Cleans up n contiguous elements. A batch destructor gets the whole span
+// in one call. `free` is special cased so the loop calls it directly rather
+// than through the function pointer.
+static void destroy_elems(ptr_dtor_fn ele_dtor_fn,
+                          ptr_batch_dtor_fn batch_dtor_fn,
+                          ptr_t* elems,
+                          size_t n) {
+  if (n == 0) {
+    return;
+  }
+
+  if (batch_dtor_fn != NULL) {
+    batch_dtor_fn(elems, n);
+  } else if (ele_dtor_fn == free) {
+    for (size_t i = 0; i < n; i++) {
+      free(elems[i]);
+    }
+  } else if (ele_dtor_fn != NULL) {
+    for (size_t i = 0; i < n; i++) {
+      ele_dtor_fn(elems[i]);
+    }
+  }
+}
+
+// Runs the element destructor over data[start, end).
+static void vec_destroy_span(Vec* self, size_t start, size_t end) {
+  destroy_elems(self->ele_dtor_fn, self->ele_batch_dtor_fn, &self->data[start],
+                end - start);
+}
+
 Vec vec_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn) {
-  // TODO: implement me
+  return vec_new_with_policy(initial_capacity, ele_dtor_fn, GROWTH_DOUBLE);
+}
+
+Vec vec_new_batched(size_t initial_capacity, ptr_batch_dtor_fn batch_dtor_fn) {
+  Vec vec = vec_new(initial_capacity, NULL);
+  vec.ele_batch_dtor_fn = batch_dtor_fn;
+  return vec;
+}
+
+Vec vec_new_with_allocator(size_t initial_capacity,
+                           ptr_dtor_fn ele_dtor_fn,
+                           const Allocator* allocator) {
+  Vec vec = vec_new(0, ele_dtor_fn);
+  vec.allocator = allocator;
+  vec_resize(&vec, initial_capacity);
+  return vec;
+}
+
+Vec vec_new_in_arena(size_t initial_capacity, size_t chunk_size) {
+  Vec vec = vec_new(0, NULL);
+  vec.arena = arena_new(chunk_size);
+  vec_resize(&vec, initial_capacity);
+  return vec;
+}
+
+Vec vec_new_with_policy(size_t initial_capacity,
+                        ptr_dtor_fn ele_dtor_fn,
+                        growth_policy policy) {
   Vec vec;
-  vec.data = (ptr_t*)malloc(initial_capacity * sizeof(ptr_t));
+  vec.data = vec_buf_alloc(initial_capacity);
   if (vec.data == NULL && initial_capacity > 0) {
     panic("Memory allocation failed in vec_new");
   }
 
   vec.length = 0;
   vec.capacity = initial_capacity;
+  if (policy.use_usable_size && initial_capacity > 0) {
+    vec.capacity = vec_buf_usable(vec.data, initial_capacity);
+  }
   vec.ele_dtor_fn = ele_dtor_fn;
+  vec.ele_batch_dtor_fn = NULL;
+  vec.policy = policy;
+  vec.arena = NULL;
+  vec.allocator = NULL;
   return vec;
 }
 
-// TODO: the rest of the vector functions
-
 void vec_destroy(Vec* self) {
   if (self == NULL) {
     return;
   }
 
-  if (self->ele_dtor_fn != NULL) {
-    for (size_t i = 0; i < self->length; i++) {
-      self->ele_dtor_fn(self->data[i]);
-    }
+  if (self->arena != NULL) {
+    // elements and storage all belong to the arena
+    arena_destroy(self->arena);
+    self->arena = NULL;
+  } else if (self->allocator != NULL) {
+    vec_clear(self);
+    self->allocator->free_fn(self->allocator->ctx, self->data,
+                             self->capacity * sizeof(ptr_t));
+  } else {
+    vec_clear(self);
+    vec_buf_free(self->data, self->capacity);
   }
 
-  free(self->data);
   self->data = NULL;
   self->length = 0;
   self->capacity = 0;
   self->ele_dtor_fn = NULL;
-  printf("CAC\n");
+  self->ele_batch_dtor_fn = NULL;
+  self->allocator = NULL;
 }
 
-ptr_t vec_get (Vec *self, size_t index) {
-  return NULL;
+ptr_t vec_get(Vec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in vec_get");
+  }
+
+  return self->data[index];
 }
 
-void vec_set (Vec* self, size_t index, ptr_t new_ele) {
-  return ;
+void vec_set(Vec* self, size_t index, ptr_t new_ele) {
+  if (index >= self->length) {
+    panic("Index out of bounds in vec_set");
+  }
+
+  vec_destroy_span(self, index, index + 1);
+  self->data[index] = new_ele;
 }
 
 void vec_push_back(Vec* self, ptr_t new_ele) {
-  if (self->length == self->capacity) {
-    size_t new_capacity = self->capacity == 0 ? 1 : self->capacity*2;
-    vec_resize(self, new_capacity);
-  }
-  
+  vec_reserve(self, self->length + 1);
   self->data[self->length++] = new_ele;
 }
 
 bool vec_pop_back(Vec* self) {
-  return false;
+  if (self->length == 0) {
+    return false;
+  }
+
+  self->length--;
+  vec_destroy_span(self, self->length, self->length + 1);
+  return true;
 }
 
 void vec_insert(Vec* self, size_t index, ptr_t new_ele) {
-  return ;
+  if (index > self->length) {
+    panic("Index out of bounds in vec_insert");
+  }
+
+  vec_reserve(self, self->length + 1);
+  memmove(&self->data[index + 1], &self->data[index],
+          (self->length - index) * sizeof(ptr_t));
+  self->data[index] = new_ele;
+  self->length++;
+}
+
+void vec_erase(Vec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in vec_erase");
+  }
+
+  vec_destroy_span(self, index, index + 1);
+  memmove(&self->data[index], &self->data[index + 1],
+          (self->length - index - 1) * sizeof(ptr_t));
+  self->length--;
 }
 
-void vec_erase(Vec* self, size_t index){
-  return ;
+void vec_extend(Vec* self, const ptr_t* elems, size_t n) {
+  vec_insert_range(self, self->length, elems, n);
+}
+
+void vec_insert_range(Vec* self, size_t index, const ptr_t* elems, size_t n) {
+  if (index > self->length) {
+    panic("Index out of bounds in vec_insert_range");
+  }
+  if (n == 0) {
+    return;
+  }
+  if (n > SIZE_MAX - self->length) {
+    panic("Length overflow in vec_insert_range");
+    return;
+  }
+
+  vec_reserve(self, self->length + n);
+  memmove(&self->data[index + n], &self->data[index],
+          (self->length - index) * sizeof(ptr_t));
+  memcpy(&self->data[index], elems, n * sizeof(ptr_t));
+  self->length += n;
+}
+
+void vec_erase_range(Vec* self, size_t index, size_t count) {
+  if (index > self->length || count > self->length - index) {
+    panic("Range out of bounds in vec_erase_range");
+  }
+  if (count == 0) {
+    return;
+  }
+
+  vec_destroy_span(self, index, index + count);
+  memmove(&self->data[index], &self->data[index + count],
+          (self->length - index - count) * sizeof(ptr_t));
+  self->length -= count;
+}
+
+void vec_truncate(Vec* self, size_t new_length) {
+  if (new_length >= self->length) {
+    return;
+  }
+
+  vec_destroy_span(self, new_length, self->length);
+  self->length = new_length;
+}
+
+void vec_swap_remove(Vec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in vec_swap_remove");
+  }
+
+  vec_destroy_span(self, index, index + 1);
+  self->length--;
+  self->data[index] = self->data[self->length];
+}
+
+void vec_retain(Vec* self, ptr_pred_fn pred, void* ctx) {
+  // swapping each kept element down gathers the removed ones in
+  // data[kept, length), so they are destructed as one span
+  size_t kept = 0;
+  for (size_t i = 0; i < self->length; i++) {
+    ptr_t ele = self->data[i];
+    if (pred(ele, ctx)) {
+      self->data[i] = self->data[kept];
+      self->data[kept++] = ele;
+    }
+  }
+  vec_destroy_span(self, kept, self->length);
+  self->length = kept;
 }
 
 void vec_resize(Vec* self, size_t new_capacity) {
-  return ;
+  if (new_capacity <= self->length || new_capacity == self->capacity) {
+    return;
+  }
+
+  ptr_t* new_data = NULL;
+  bool custom = self->arena != NULL || self->allocator != NULL;
+  if (custom && new_capacity > SIZE_MAX / sizeof(ptr_t)) {
+    panic("Memory allocation failed in vec_resize");
+    return;
+  }
+
+  if (self->arena != NULL) {
+    new_data = (ptr_t*)arena_realloc(self->arena, self->data,
+                                     self->length * sizeof(ptr_t),
+                                     new_capacity * sizeof(ptr_t));
+  } else if (self->allocator != NULL) {
+    new_data = (ptr_t*)self->allocator->realloc_fn(
+        self->allocator->ctx, self->data, self->capacity * sizeof(ptr_t),
+        new_capacity * sizeof(ptr_t));
+  } else {
+    new_data = vec_buf_realloc(self->data, self->length, self->capacity,
+                               new_capacity);
+  }
+  if (new_data == NULL) {
+    panic("Memory allocation failed in vec_resize");
+    return;
+  }
+
+  self->data = new_data;
+  self->capacity = new_capacity;
+  if (self->policy.use_usable_size && !custom) {
+    self->capacity = vec_buf_usable(new_data, new_capacity);
+  }
 }
 
 void vec_clear(Vec* self) {
-  return ;
+  vec_truncate(self, 0);
+}
+
+// The element storage currently in use by a SmallVec.
+static ptr_t* svec_data(SmallVec* self) {
+  return svec_is_spilled(self) ? self->heap_data : self->inline_data;
+}
+
+SmallVec svec_new(ptr_dtor_fn ele_dtor_fn) {
+  SmallVec vec;
+  vec.length = 0;
+  vec.capacity = VEC_SMALL_CAPACITY;
+  vec.ele_dtor_fn = ele_dtor_fn;
+  return vec;
+}
+
+ptr_t svec_get(SmallVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in svec_get");
+  }
+
+  return svec_data(self)[index];
+}
+
+void svec_set(SmallVec* self, size_t index, ptr_t new_ele) {
+  if (index >= self->length) {
+    panic("Index out of bounds in svec_set");
+  }
+
+  ptr_t* data = svec_data(self);
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(data[index]);
+  }
+  data[index] = new_ele;
+}
+
+void svec_push_back(SmallVec* self, ptr_t new_ele) {
+  if (self->length == self->capacity) {
+    size_t new_capacity = self->capacity * 2;
+    ptr_t* new_data = NULL;
+
+    if (svec_is_spilled(self)) {
+      new_data = vec_buf_realloc(self->heap_data, self->length,
+                                 self->capacity, new_capacity);
+    } else {
+      new_data = vec_buf_alloc(new_capacity);
+      if (new_data != NULL) {
+        memcpy(new_data, self->inline_data, self->length * sizeof(ptr_t));
+      }
+    }
+
+    if (new_data == NULL) {
+      panic("Memory allocation failed in svec_push_back");
+      return;
+    }
+
+    self->heap_data = new_data;
+    self->capacity = new_capacity;
+  }
+
+  svec_data(self)[self->length++] = new_ele;
+}
+
+bool svec_pop_back(SmallVec* self) {
+  if (self->length == 0) {
+    return false;
+  }
+
+  self->length--;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(svec_data(self)[self->length]);
+  }
+  return true;
+}
+
+void svec_clear(SmallVec* self) {
+  destroy_elems(self->ele_dtor_fn, NULL, svec_data(self), self->length);
+  self->length = 0;
+}
+
+void svec_destroy(SmallVec* self) {
+  if (self == NULL) {
+    return;
+  }
+
+  svec_clear(self);
+
+  if (svec_is_spilled(self)) {
+    vec_buf_free(self->heap_data, self->capacity);
+  }
+  self->capacity = VEC_SMALL_CAPACITY;
+  self->ele_dtor_fn = NULL;
+}
+
+// Physical slot of logical index `index`.
+static size_t vdq_slot(const VecDeque* self, size_t index) {
+  return (self->head + index) & (self->capacity - 1);
+}
+
+// Doubles the capacity of a full deque. The buffer is grown in place (or
+// remapped), then any elements that had wrapped around to the start are
+// moved up past the old end so the contents are contiguous modulo the new
+// capacity again.
+static void vdq_grow(VecDeque* self) {
+  size_t old_capacity = self->capacity;
+  size_t new_capacity = old_capacity == 0 ? 1 : old_capacity * 2;
+  if (new_capacity < old_capacity) {
+    panic("Capacity overflow in VecDeque");
+    return;
+  }
+
+  ptr_t* new_data =
+      vec_buf_realloc(self->data, old_capacity, old_capacity, new_capacity);
+  if (new_data == NULL) {
+    panic("Memory allocation failed in VecDeque");
+    return;
+  }
+
+  if (self->head + self->length > old_capacity) {
+    size_t wrapped = self->head + self->length - old_capacity;
+    memcpy(&new_data[old_capacity], new_data, wrapped * sizeof(ptr_t));
+  }
+
+  self->data = new_data;
+  self->capacity = new_capacity;
+}
+
+VecDeque vdq_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn) {
+  size_t capacity = 0;
+  if (initial_capacity > 0) {
+    capacity = 1;
+    while (capacity < initial_capacity && capacity != 0) {
+      capacity <<= 1U;
+    }
+  }
+  if (initial_capacity > 0 && capacity == 0) {
+    panic("Capacity overflow in vdq_new");
+  }
+
+  VecDeque deque;
+  deque.data = capacity > 0 ? vec_buf_alloc(capacity) : NULL;
+  if (deque.data == NULL && capacity > 0) {
+    panic("Memory allocation failed in vdq_new");
+  }
+
+  deque.head = 0;
+  deque.length = 0;
+  deque.capacity = capacity;
+  deque.ele_dtor_fn = ele_dtor_fn;
+  return deque;
+}
+
+ptr_t vdq_get(VecDeque* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in vdq_get");
+  }
+
+  return self->data[vdq_slot(self, index)];
+}
+
+void vdq_set(VecDeque* self, size_t index, ptr_t new_ele) {
+  if (index >= self->length) {
+    panic("Index out of bounds in vdq_set");
+  }
+
+  size_t slot = vdq_slot(self, index);
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(self->data[slot]);
+  }
+  self->data[slot] = new_ele;
+}
+
+void vdq_push_back(VecDeque* self, ptr_t new_ele) {
+  if (self->length == self->capacity) {
+    vdq_grow(self);
+  }
+
+  self->data[vdq_slot(self, self->length)] = new_ele;
+  self->length++;
+}
+
+void vdq_push_front(VecDeque* self, ptr_t new_ele) {
+  if (self->length == self->capacity) {
+    vdq_grow(self);
+  }
+
+  self->head = (self->head - 1) & (self->capacity - 1);
+  self->data[self->head] = new_ele;
+  self->length++;
+}
+
+bool vdq_pop_back(VecDeque* self) {
+  if (self->length == 0) {
+    return false;
+  }
+
+  self->length--;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(self->data[vdq_slot(self, self->length)]);
+  }
+  return true;
+}
+
+bool vdq_pop_front(VecDeque* self) {
+  if (self->length == 0) {
+    return false;
+  }
+
+  ptr_t ele = self->data[self->head];
+  self->head = (self->head + 1) & (self->capacity - 1);
+  self->length--;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(ele);
+  }
+  return true;
+}
+
+void vdq_as_slices(VecDeque* self, VecSlice* first, VecSlice* second) {
+  size_t to_end = self->capacity - self->head;
+
+  first->data = self->data == NULL ? NULL : &self->data[self->head];
+  if (self->length <= to_end) {
+    first->length = self->length;
+    second->data = self->data;
+    second->length = 0;
+  } else {
+    first->length = to_end;
+    second->data = self->data;
+    second->length = self->length - to_end;
+  }
+}
+
+void vdq_clear(VecDeque* self) {
+  VecSlice first;
+  VecSlice second;
+  vdq_as_slices(self, &first, &second);
+  destroy_elems(self->ele_dtor_fn, NULL, first.data, first.length);
+  destroy_elems(self->ele_dtor_fn, NULL, second.data, second.length);
+  self->head = 0;
+  self->length = 0;
+}
+
+void vdq_destroy(VecDeque* self) {
+  if (self == NULL) {
+    return;
+  }
+
+  vdq_clear(self);
+
+  vec_buf_free(self->data, self->capacity);
+  self->data = NULL;
+  self->capacity = 0;
+  self->ele_dtor_fn = NULL;
+}
+
+_Static_assert(SEGVEC_FIRST_SEGMENT > 0 &&
+                   (SEGVEC_FIRST_SEGMENT & (SEGVEC_FIRST_SEGMENT - 1)) == 0,
+               "SEGVEC_FIRST_SEGMENT must be a power of two");
+
+// Splits an index into the segment holding it and the offset within that
+// segment. With F = SEGVEC_FIRST_SEGMENT, segment k covers indices
+// [F * (2^k - 1), F * (2^(k+1) - 1)), i.e. exactly those for which the
+// highest set bit of index + F is bit log2(F) + k.
+static void segvec_locate(size_t index, size_t* segment, size_t* offset) {
+  if (index > SIZE_MAX - SEGVEC_FIRST_SEGMENT) {
+    panic("Index too large for SegVec");
+  }
+  size_t pos = index + SEGVEC_FIRST_SEGMENT;
+  unsigned high = (unsigned)(sizeof(unsigned long long) * CHAR_BIT - 1 -
+                             __builtin_clzll((unsigned long long)pos));
+  unsigned first_high = (unsigned)__builtin_ctzll(SEGVEC_FIRST_SEGMENT);
+  *segment = high - first_high;
+  *offset = pos - ((size_t)1 << high);
+}
+
+static size_t segvec_segment_size(size_t segment) {
+  return (size_t)SEGVEC_FIRST_SEGMENT << segment;
+}
+
+// Allocates the next segment.
+static void segvec_grow(SegVec* self) {
+  size_t size = segvec_segment_size(self->num_segments);
+  if (self->num_segments == SEGVEC_MAX_SEGMENTS ||
+      self->capacity > SIZE_MAX - size) {
+    panic("Capacity overflow in SegVec");
+    return;
+  }
+
+  ptr_t* segment = vec_buf_alloc(size);
+  if (segment == NULL) {
+    panic("Memory allocation failed in SegVec");
+    return;
+  }
+  self->segments[self->num_segments++] = segment;
+  self->capacity += size;
+}
+
+SegVec segvec_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn) {
+  SegVec vec;
+  for (size_t i = 0; i < SEGVEC_MAX_SEGMENTS; i++) {
+    vec.segments[i] = NULL;
+  }
+  vec.num_segments = 0;
+  vec.length = 0;
+  vec.capacity = 0;
+  vec.ele_dtor_fn = ele_dtor_fn;
+  segvec_reserve(&vec, initial_capacity);
+  return vec;
+}
+
+ptr_t* segvec_at(SegVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in segvec_at");
+  }
+
+  size_t segment = 0;
+  size_t offset = 0;
+  segvec_locate(index, &segment, &offset);
+  return &self->segments[segment][offset];
+}
+
+ptr_t segvec_get(SegVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in segvec_get");
+  }
+
+  return *segvec_at(self, index);
+}
+
+void segvec_set(SegVec* self, size_t index, ptr_t new_ele) {
+  if (index >= self->length) {
+    panic("Index out of bounds in segvec_set");
+  }
+
+  ptr_t* slot = segvec_at(self, index);
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(*slot);
+  }
+  *slot = new_ele;
+}
+
+void segvec_push_back(SegVec* self, ptr_t new_ele) {
+  if (self->length == self->capacity) {
+    segvec_grow(self);
+  }
+
+  self->length++;
+  *segvec_at(self, self->length - 1) = new_ele;
+}
+
+bool segvec_pop_back(SegVec* self) {
+  if (self->length == 0) {
+    return false;
+  }
+
+  ptr_t ele = *segvec_at(self, self->length - 1);
+  self->length--;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(ele);
+  }
+  return true;
+}
+
+void segvec_reserve(SegVec* self, size_t capacity) {
+  while (self->capacity < capacity) {
+    segvec_grow(self);
+  }
+}
+
+void segvec_clear(SegVec* self) {
+  size_t remaining = self->length;
+  for (size_t i = 0; i < self->num_segments && remaining > 0; i++) {
+    size_t size = segvec_segment_size(i);
+    size_t count = remaining < size ? remaining : size;
+    destroy_elems(self->ele_dtor_fn, NULL, self->segments[i], count);
+    remaining -= count;
+  }
+  self->length = 0;
+}
+
+void segvec_destroy(SegVec* self) {
+  if (self == NULL) {
+    return;
+  }
+
+  segvec_clear(self);
+
+  for (size_t i = 0; i < self->num_segments; i++) {
+    vec_buf_free(self->segments[i], segvec_segment_size(i));
+    self->segments[i] = NULL;
+  }
+  self->num_segments = 0;
+  self->capacity = 0;
+  self->ele_dtor_fn = NULL;
+}
+
+static size_t gbuf_gap(const GapBuf* self) {
+  return self->gap_end - self->gap_start;
+}
+
+// Doubles the capacity of a gap buffer whose gap is empty. The elements
+// after the gap move to the end of the new buffer, so the new slots all
+// end up in the gap.
+static void gbuf_grow(GapBuf* self) {
+  size_t old_capacity = self->capacity;
+  size_t new_capacity = old_capacity == 0 ? 1 : old_capacity * 2;
+  if (new_capacity < old_capacity) {
+    panic("Capacity overflow in GapBuf");
+    return;
+  }
+
+  ptr_t* new_data =
+      vec_buf_realloc(self->data, old_capacity, old_capacity, new_capacity);
+  if (new_data == NULL) {
+    panic("Memory allocation failed in GapBuf");
+    return;
+  }
+
+  size_t after = old_capacity - self->gap_end;
+  if (after > 0) {
+    memmove(&new_data[new_capacity - after], &new_data[self->gap_end],
+            after * sizeof(ptr_t));
+  }
+
+  self->data = new_data;
+  self->gap_end = new_capacity - after;
+  self->capacity = new_capacity;
+}
+
+GapBuf gbuf_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn) {
+  GapBuf buf;
+  buf.data = vec_buf_alloc(initial_capacity);
+  if (buf.data == NULL && initial_capacity > 0) {
+    panic("Memory allocation failed in gbuf_new");
+  }
+
+  buf.gap_start = 0;
+  buf.gap_end = initial_capacity;
+  buf.capacity = initial_capacity;
+  buf.ele_dtor_fn = ele_dtor_fn;
+  return buf;
+}
+
+ptr_t gbuf_get(GapBuf* self, size_t index) {
+  if (index >= gbuf_len(self)) {
+    panic("Index out of bounds in gbuf_get");
+  }
+
+  return self->data[index < self->gap_start ? index : index + gbuf_gap(self)];
+}
+
+void gbuf_set(GapBuf* self, size_t index, ptr_t new_ele) {
+  if (index >= gbuf_len(self)) {
+    panic("Index out of bounds in gbuf_set");
+  }
+
+  size_t slot = index < self->gap_start ? index : index + gbuf_gap(self);
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(self->data[slot]);
+  }
+  self->data[slot] = new_ele;
+}
+
+void gbuf_move_to(GapBuf* self, size_t cursor) {
+  if (cursor > gbuf_len(self)) {
+    panic("Cursor out of bounds in gbuf_move_to");
+  }
+
+  if (cursor < self->gap_start) {
+    size_t count = self->gap_start - cursor;
+    memmove(&self->data[self->gap_end - count], &self->data[cursor],
+            count * sizeof(ptr_t));
+    self->gap_start -= count;
+    self->gap_end -= count;
+  } else if (cursor > self->gap_start) {
+    size_t count = cursor - self->gap_start;
+    memmove(&self->data[self->gap_start], &self->data[self->gap_end],
+            count * sizeof(ptr_t));
+    self->gap_start += count;
+    self->gap_end += count;
+  }
+}
+
+void gbuf_insert(GapBuf* self, ptr_t new_ele) {
+  if (self->gap_start == self->gap_end) {
+    gbuf_grow(self);
+  }
+
+  self->data[self->gap_start++] = new_ele;
+}
+
+bool gbuf_erase_before(GapBuf* self) {
+  if (self->gap_start == 0) {
+    return false;
+  }
+
+  self->gap_start--;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(self->data[self->gap_start]);
+  }
+  return true;
+}
+
+bool gbuf_erase_after(GapBuf* self) {
+  if (self->gap_end == self->capacity) {
+    return false;
+  }
+
+  ptr_t ele = self->data[self->gap_end];
+  self->gap_end++;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(ele);
+  }
+  return true;
+}
+
+void gbuf_as_slices(GapBuf* self, VecSlice* before, VecSlice* after) {
+  before->data = self->data;
+  before->length = self->gap_start;
+  after->data = self->data == NULL ? NULL : &self->data[self->gap_end];
+  after->length = self->capacity - self->gap_end;
+}
+
+void gbuf_clear(GapBuf* self) {
+  VecSlice before;
+  VecSlice after;
+  gbuf_as_slices(self, &before, &after);
+  destroy_elems(self->ele_dtor_fn, NULL, before.data, before.length);
+  destroy_elems(self->ele_dtor_fn, NULL, after.data, after.length);
+  self->gap_start = 0;
+  self->gap_end = self->capacity;
+}
+
+void gbuf_destroy(GapBuf* self) {
+  if (self == NULL) {
+    return;
+  }
+
+  gbuf_clear(self);
+
+  vec_buf_free(self->data, self->capacity);
+  self->data = NULL;
+  self->gap_start = 0;
+  self->gap_end = 0;
+  self->capacity = 0;
+  self->ele_dtor_fn = NULL;
 }
@@ -3,15 +3,37 @@
 
 #include <stdbool.h>
 #include <stddef.h>  // for size_t
+#include "./allocator.h"
+#include "./arena.h"
+#include "./growth_policy.h"
 
 typedef void* ptr_t;
 typedef void (*ptr_dtor_fn)(ptr_t);
+typedef void (*ptr_batch_dtor_fn)(ptr_t* elems, size_t n);
+typedef bool (*ptr_pred_fn)(ptr_t ele, void* ctx);
+
+/* Element buffers of at least this many bytes are backed by their own
+ * anonymous mmap instead of malloc, and growing them is done with
+ * mremap(MREMAP_MAYMOVE). The kernel moves the page table entries rather than
+ * the elements, so doubling a multi-gigabyte Vec neither copies it nor briefly
+ * needs twice its memory.
+ *
+ * Can be overridden at compile time with -DVEC_MMAP_THRESHOLD=<bytes>,
+ * or the mode can be turned off entirely with -DVEC_DISABLE_MMAP.
+ */
+#ifndef VEC_MMAP_THRESHOLD
+#define VEC_MMAP_THRESHOLD ((size_t)1 << 20)
+#endif
 
 typedef struct vec_st {
   ptr_t* data;
   size_t length;
   size_t capacity;
   ptr_dtor_fn ele_dtor_fn;
+  ptr_batch_dtor_fn ele_batch_dtor_fn;
+  growth_policy policy;
+  Arena* arena;  // non NULL if data comes from (and is owned by) an arena
+  const Allocator* allocator;  // NULL for the built in malloc/mmap storage
 } Vec;
 
 /*!
@@ -32,6 +54,91 @@ typedef struct vec_st {
  */
 Vec vec_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn);
 
+/*!
+ * Creates a new empty Vec(tor) like vec_new, but with a growth policy other
+ * than the default doubling (see growth_policy.h). For example:
+ *
+ *   Vec v = vec_new_with_policy(0, free, GROWTH_1_5X);
+ *
+ * @param initial_capacity the initial capacity of the newly created vector.
+ * If the policy uses usable size, the capacity may end up larger.
+ * @param ele_dtor_fn      the element destructor, same as in vec_new
+ * @param policy           how the vector grows when it runs out of capacity
+ * @returns a newly created vector with at least the specified capacity,
+ * 0 length, the specified element destructor and growth policy.
+ * @post if memory allocation fails, the function will panic.
+ */
+Vec vec_new_with_policy(size_t initial_capacity,
+                        ptr_dtor_fn ele_dtor_fn,
+                        growth_policy policy);
+
+/*!
+ * Creates a new empty Vec(tor) whose elements are cleaned up in batches.
+ *
+ * Instead of one call per element, batch_dtor_fn is called once for every
+ * contiguous span of elements that is removed: by vec_clear, vec_destroy,
+ * vec_truncate and vec_erase_range. Single element removals
+ * (vec_set, vec_pop_back, vec_erase, ...) call it with n == 1.
+ *
+ * For the common case of elements that just need to be free()'d there is no
+ * need for this, passing `free` as the ele_dtor_fn of vec_new is already
+ * special cased to free spans without going through a function pointer.
+ *
+ * @param initial_capacity the initial capacity of the newly created vector
+ * @param batch_dtor_fn    a function that cleans up the n elements starting
+ *                         at elems. It must not keep the pointer.
+ * @returns a newly created vector with specified capacity, 0 length, no
+ * per element destructor and the specified batch destructor.
+ * @post if memory allocation fails, the function will panic.
+ */
+Vec vec_new_batched(size_t initial_capacity, ptr_batch_dtor_fn batch_dtor_fn);
+
+/*!
+ * Creates a new empty Vec(tor) whose element storage is managed by the given
+ * allocator (see allocator.h) instead of the built in malloc/mmap storage.
+ * Every growth, shrink and destroy of the storage goes through it.
+ *
+ *   Pool* pool = pool_new();
+ *   Vec v = vec_new_with_allocator(0, NULL, pool_allocator(pool));
+ *   ...
+ *   vec_destroy(&v);
+ *   pool_destroy(pool);
+ *
+ * @param initial_capacity the initial capacity of the newly created vector
+ * @param ele_dtor_fn      the element destructor, same as in vec_new
+ * @param allocator        the allocator to use, must outlive the vector
+ * @returns a newly created vector with specified capacity, 0 length, the
+ * specified element destructor and allocator.
+ * @post if memory allocation fails, the function will panic.
+ */
+Vec vec_new_with_allocator(size_t initial_capacity,
+                           ptr_dtor_fn ele_dtor_fn,
+                           const Allocator* allocator);
+
+/*!
+ * Creates a new empty Vec(tor) that owns an arena (see arena.h). The element
+ * storage is allocated from the arena, and so should the objects the
+ * elements point to:
+ *
+ *   Vec v = vec_new_in_arena(16, 0);
+ *   char* str = arena_alloc(v.arena, 32);
+ *   vec_push_back(&v, str);
+ *   ...
+ *   vec_destroy(&v);  // releases the storage and every string at once
+ *
+ * An arena Vec has no element destructor. Removing elements does not clean
+ * them up, their memory is only reclaimed when the vector is destroyed.
+ * vec_destroy releases the whole arena in one go instead of visiting every
+ * element.
+ *
+ * @param initial_capacity the initial capacity of the newly created vector
+ * @param chunk_size       the arena chunk size, 0 for the default
+ * @returns a newly created vector with specified capacity, 0 length, no
+ * element destructor and its own arena in the `arena` field.
+ * @post if memory allocation fails, the function will panic.
+ */
+Vec vec_new_in_arena(size_t initial_capacity, size_t chunk_size);
+
 /* Returns the current capacity of the Vec
  * Written as a function-like macro
  *
@@ -85,9 +192,11 @@ void vec_set(Vec* self, size_t index, ptr_t new_ele);
  * @post If a resize is needed and it fails, then this function will panic()
  * @post If after the operation the new length is greater than the old capacity
  * then a reallocation takes place and all elements are copied over.
- * Capacity is doubled. If initial capacity is zero, it is resized to
- * capacity 1. Any pointers to elements prior to this reallocation are
- * invalidated.
+ * Capacity grows as specified by the vector's growth policy. With the
+ * default policy it is doubled, and if the initial capacity is zero, it is
+ * resized to capacity 1. Any pointers to elements prior to this reallocation are
+ * invalidated. Once the buffer is VEC_MMAP_THRESHOLD bytes or more, the
+ * reallocation remaps pages in place of copying them.
  */
 void vec_push_back(Vec* self, ptr_t new_ele);
 
@@ -112,8 +221,9 @@ bool vec_pop_back(Vec* self);
  * @pre Assumes self points to a valid vector. If the index is > self->length
  * then this function will panic().
  * @post If after the operation the new length is greater than the old capacity
- * then a reallocation takes place and all elements are copied over. Capacity is
- * doubled. Any pointers to elements prior to this reallocation are invalidated.
+ * then a reallocation takes place and all elements are copied over. Capacity
+ * grows as specified by the vector's growth policy (doubled by default). Any
+ * pointers to elements prior to this reallocation are invalidated.
  */
 void vec_insert(Vec* self, size_t index, ptr_t new_ele);
 
@@ -127,15 +237,100 @@ void vec_insert(Vec* self, size_t index, ptr_t new_ele);
  */
 void vec_erase(Vec* self, size_t index);
 
+/* Appends n elements, copied from the array elems, to the end of the Vec
+ *
+ * @param self  a pointer to the vector we are appending to
+ * @param elems the elements to append, in order. May be NULL if n is 0.
+ * @param n     the number of elements in elems
+ * @pre Assumes self points to a valid vector and that elems does not point
+ * into self's own storage.
+ * @post At most one reallocation takes place, growing the capacity as
+ * specified by the growth policy until all n elements fit. If it fails,
+ * this function will panic(). Any pointers to elements prior to the
+ * reallocation are invalidated.
+ */
+void vec_extend(Vec* self, const ptr_t* elems, size_t n);
+
+/* Inserts n elements, copied from the array elems, at the specified location
+ *
+ * @param self  a pointer to the vector we want to insert into.
+ * @param index the index to insert at. Elements at this index and after it
+ *              are "shifted" up n positions with a single memmove. If index
+ *              is equal to the length, this is the same as vec_extend.
+ * @param elems the elements to insert, in order. May be NULL if n is 0.
+ * @param n     the number of elements in elems
+ * @pre Assumes self points to a valid vector and that elems does not point
+ * into self's own storage. If the index is > self->length then this function
+ * will panic().
+ * @post Same reallocation behaviour as vec_extend.
+ */
+void vec_insert_range(Vec* self, size_t index, const ptr_t* elems, size_t n);
+
+/* Erases count elements starting at the specified location
+ *
+ * @param self  a pointer to the vector we want to erase from.
+ * @param index the index of the first element to erase.
+ * @param count the number of elements to erase. Elements after the erased
+ *              range are "shifted" down count positions with a single
+ *              memmove.
+ * @pre Assumes self points to a valid vector. If index + count is
+ * > self->length then this function will panic().
+ * @post The removed elements are destructed (cleaned up) in one pass.
+ * Capacity is unchanged.
+ */
+void vec_erase_range(Vec* self, size_t index, size_t count);
+
+/* Shortens the Vec to new_length elements, destroying the rest.
+ * Does nothing if new_length >= self->length.
+ *
+ * @param self       a pointer to the vector we want to truncate.
+ * @param new_length the length of the vector afterwards.
+ * @pre Assumes self points to a valid vector.
+ * @post The removed elements are destructed (cleaned up) in one pass.
+ * Capacity is unchanged.
+ */
+void vec_truncate(Vec* self, size_t new_length);
+
+/* Erases an element at the specified valid location in O(1) by moving the
+ * last element into its place. Does not preserve the order of elements.
+ *
+ * @param self    a pointer to the vector we want to erase from.
+ * @param index   the index of the element we want to erase.
+ * @pre Assumes self points to a valid vector. If the index is >= self->length
+ * then this function will panic().
+ * @post The removed element is destructed (cleaned up).
+ */
+void vec_swap_remove(Vec* self, size_t index);
+
+/* Keeps only the elements for which pred returns true, in a single linear
+ * pass. The kept elements stay in their original order and are compacted to
+ * the front of the vector.
+ *
+ * @param self a pointer to the vector we want to filter.
+ * @param pred called once on every element, in order, with ctx passed
+ *             through. An element is kept iff pred returns true.
+ * @param ctx  any extra state pred needs, may be NULL.
+ * @pre Assumes self points to a valid vector and that pred does not modify
+ * it.
+ * @post The removed elements are destructed (cleaned up) after pred has seen
+ * every element, as one span for a batch destructor. Capacity is unchanged.
+ */
+void vec_retain(Vec* self, ptr_pred_fn pred, void* ctx);
+
 /* Resizes the container to a new specified capacity.
  * Does nothing if new_capacity <= self->length
+ * If the growth policy uses usable size, the resulting capacity can be
+ * larger than new_capacity when the allocator handed back a bigger block.
  *
  * @param self         a pointer to the vector we want to resize.
  * @param new_capacity the new capacity of the vector.
  * @pre Assumes self points to a valid vector.
  * @post If a resize takes place, then a reallocation takes place and all
- * elements are copied over. Any pointers to elements prior to this
+ * elements are copied over, unless both the old and new buffers are at least
+ * VEC_MMAP_THRESHOLD bytes, in which case the mapping is grown or shrunk with
+ * mremap() and no elements are copied. Any pointers to elements prior to this
  * reallocation are invalidated.
+ * @post If the allocation fails, then this function will panic()
  * @post The removed elements are destructed (cleaned up).
  */
 void vec_resize(Vec* self, size_t new_capacity);
@@ -153,6 +348,9 @@ void vec_clear(Vec* self);
 /* Destruct the vector.
  * All elements are destructed and storage is deallocated.
  * Must set capacity and length to zero. Data is set to NULL.
+ * For a vector created by vec_new_in_arena, the arena is destroyed, which
+ * releases the storage and everything else allocated from it in O(1)
+ * rather than O(length).
  *
  * @param self a pointer to the vector we want to destruct.
  * @pre Assumes self points to a valid vector.
@@ -161,4 +359,465 @@ void vec_clear(Vec* self);
  */
 void vec_destroy(Vec* self);
 
+/* Number of elements a SmallVec stores inline before it spills to the heap.
+ * Can be overridden at compile time with -DVEC_SMALL_CAPACITY=<n>.
+ */
+#ifndef VEC_SMALL_CAPACITY
+#define VEC_SMALL_CAPACITY 8
+#endif
+
+/* A Vec with small buffer optimization: the first VEC_SMALL_CAPACITY
+ * elements are stored inside the struct itself, so a SmallVec that never
+ * grows past that never touches the heap. Once it outgrows the inline slots
+ * the elements are moved to a heap buffer, which then grows like a Vec's.
+ *
+ * While capacity == VEC_SMALL_CAPACITY the elements live in inline_data,
+ * afterwards in heap_data. Because nothing points into the struct itself a
+ * SmallVec can be returned and copied by value, like a Vec. Only one copy
+ * may be used afterwards, though.
+ */
+typedef struct small_vec_st {
+  union {
+    ptr_t inline_data[VEC_SMALL_CAPACITY];
+    ptr_t* heap_data;
+  };
+  size_t length;
+  size_t capacity;
+  ptr_dtor_fn ele_dtor_fn;
+} SmallVec;
+
+/*!
+ * Creates a new empty SmallVec with the specified element destructor.
+ * Does not allocate, capacity starts at VEC_SMALL_CAPACITY.
+ *
+ * @param ele_dtor_fn the element destructor, same as in vec_new
+ * @returns a newly created small vector with 0 length.
+ */
+SmallVec svec_new(ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the current capacity of the SmallVec
+ *
+ * @param vec, a pointer to the small vector we want to grab the capacity of.
+ */
+#define svec_capacity(vec) ((vec)->capacity)
+
+/* Returns the current length of the SmallVec
+ *
+ * @param vec, a pointer to the small vector we want to grab the len of.
+ */
+#define svec_len(vec) ((vec)->length)
+
+/* Checks if the SmallVec is empty
+ *
+ * @param vec, a pointer to the small vector we want to check emptiness of.
+ */
+#define svec_is_empty(vec) ((vec)->length == 0)
+
+/* Returns true if the SmallVec has moved its elements to the heap.
+ *
+ * @param vec, a pointer to the small vector we want to check.
+ */
+#define svec_is_spilled(vec) ((vec)->capacity > VEC_SMALL_CAPACITY)
+
+/* Gets the specified element of the SmallVec
+ * Same as vec_get, panics if index >= self->length
+ */
+ptr_t svec_get(SmallVec* self, size_t index);
+
+/* Sets the specified element of the SmallVec to the specified value
+ * Same as vec_set: the replaced element is destructed and this panics if
+ * index >= self->length
+ */
+void svec_set(SmallVec* self, size_t index, ptr_t new_ele);
+
+/* Appends the given element to the end of the SmallVec
+ *
+ * @param self      a pointer to the small vector we are pushing onto
+ * @param new_ele   the value we want to add to the end of the container
+ * @pre Assumes self points to a valid small vector.
+ * @post If a resize is needed and it fails, then this function will panic()
+ * @post The first time the length exceeds VEC_SMALL_CAPACITY, the elements
+ * are moved to a heap buffer of twice that capacity. After that, capacity is
+ * doubled whenever it runs out. Either way any pointers to elements prior to
+ * the move are invalidated.
+ */
+void svec_push_back(SmallVec* self, ptr_t new_ele);
+
+/* Removes and destroys the last element of the SmallVec
+ * Same as vec_pop_back, the capacity stays the same (it does not move back
+ * inline).
+ *
+ * @returns true iff an element was removed.
+ */
+bool svec_pop_back(SmallVec* self);
+
+/* Erases all elements from the SmallVec, destructing them.
+ * Capacity is unchanged.
+ */
+void svec_clear(SmallVec* self);
+
+/* Destruct the SmallVec.
+ * All elements are destructed and any heap storage is deallocated.
+ * Afterwards self is an empty SmallVec with only the inline capacity and no
+ * element destructor.
+ */
+void svec_destroy(SmallVec* self);
+
+/* A contiguous run of elements, e.g. one half of a VecDeque.
+ */
+typedef struct vec_slice_st {
+  ptr_t* data;
+  size_t length;
+} VecSlice;
+
+/* A double ended queue with the Vec element model. Elements are stored in a
+ * circular buffer whose capacity is always zero or a power of two, so pushing
+ * and popping at either end is O(1) and never shifts other elements.
+ *
+ * Logical element i lives at data[(head + i) & (capacity - 1)]. The contents
+ * may wrap around the end of the buffer, see vdq_as_slices.
+ */
+typedef struct vec_deque_st {
+  ptr_t* data;
+  size_t head;
+  size_t length;
+  size_t capacity;
+  ptr_dtor_fn ele_dtor_fn;
+} VecDeque;
+
+/*!
+ * Creates a new empty VecDeque with at least the specified initial_capacity
+ * and specified function to clean up elements in the deque.
+ *
+ * @param initial_capacity the minimum initial capacity, rounded up to a power
+ *                         of two (0 stays 0)
+ * @param ele_dtor_fn      the element destructor, same as in vec_new
+ * @returns a newly created deque with 0 length.
+ * @post if memory allocation fails, the function will panic.
+ */
+VecDeque vdq_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the current capacity of the VecDeque
+ *
+ * @param vec, a pointer to the deque we want to grab the capacity of.
+ */
+#define vdq_capacity(vec) ((vec)->capacity)
+
+/* Returns the current length of the VecDeque
+ *
+ * @param vec, a pointer to the deque we want to grab the len of.
+ */
+#define vdq_len(vec) ((vec)->length)
+
+/* Checks if the VecDeque is empty
+ *
+ * @param vec, a pointer to the deque we want to check emptiness of.
+ */
+#define vdq_is_empty(vec) ((vec)->length == 0)
+
+/* Gets the element at the specified logical index of the VecDeque
+ * Index 0 is the front.
+ *
+ * @pre Assumes self points to a valid deque. If the index is >= self->length
+ * then this function will panic()
+ */
+ptr_t vdq_get(VecDeque* self, size_t index);
+
+/* Sets the element at the specified logical index of the VecDeque
+ * The replaced element is destructed.
+ *
+ * @pre Assumes self points to a valid deque. If the index is >= self->length
+ * then this function will panic()
+ */
+void vdq_set(VecDeque* self, size_t index, ptr_t new_ele);
+
+/* Appends the given element to the back of the VecDeque
+ *
+ * @pre Assumes self points to a valid deque.
+ * @post If the deque is full, capacity is doubled (0 becomes 1). If the
+ * reallocation fails, then this function will panic(). Any pointers to
+ * elements prior to this reallocation are invalidated.
+ */
+void vdq_push_back(VecDeque* self, ptr_t new_ele);
+
+/* Prepends the given element to the front of the VecDeque
+ * Same reallocation behaviour as vdq_push_back.
+ */
+void vdq_push_front(VecDeque* self, ptr_t new_ele);
+
+/* Removes and destroys the last element of the VecDeque
+ *
+ * @returns true iff an element was removed.
+ * @post The capacity stays the same. The removed element is destructed.
+ */
+bool vdq_pop_back(VecDeque* self);
+
+/* Removes and destroys the first element of the VecDeque
+ *
+ * @returns true iff an element was removed.
+ * @post The capacity stays the same. The removed element is destructed.
+ */
+bool vdq_pop_front(VecDeque* self);
+
+/* Exposes the contents of the VecDeque as at most two contiguous slices,
+ * so that they can be processed in bulk without going through vdq_get.
+ * Visiting first and then second gives the elements front to back.
+ *
+ * @param self   a pointer to the deque
+ * @param first  set to the elements from the front up to the end of the
+ *               buffer, or all of them if they don't wrap around
+ * @param second set to the elements that wrapped around to the start of the
+ *               buffer. Its length is 0 if nothing wrapped.
+ * @post The slices are invalidated by any operation that modifies the deque.
+ */
+void vdq_as_slices(VecDeque* self, VecSlice* first, VecSlice* second);
+
+/* Erases all elements from the VecDeque, destructing them.
+ * Capacity is unchanged.
+ */
+void vdq_clear(VecDeque* self);
+
+/* Destruct the VecDeque.
+ * All elements are destructed and storage is deallocated.
+ * Capacity and length are set to zero and data is set to NULL.
+ */
+void vdq_destroy(VecDeque* self);
+
+/* Size of the first segment of a SegVec. Every following segment is twice
+ * the size of the one before. Must be a power of two. Can be overridden at
+ * compile time with -DSEGVEC_FIRST_SEGMENT=<n>.
+ */
+#ifndef SEGVEC_FIRST_SEGMENT
+#define SEGVEC_FIRST_SEGMENT 8
+#endif
+
+/* Number of entries in the segment directory of a SegVec, one per bit of an
+ * index, which is more than any index can need.
+ */
+#define SEGVEC_MAX_SEGMENTS 64
+
+/* A vector whose elements never move. Elements are stored in segments of
+ * SEGVEC_FIRST_SEGMENT, 2 * SEGVEC_FIRST_SEGMENT, 4 * SEGVEC_FIRST_SEGMENT,
+ * ... slots, and growing only allocates the next segment. Nothing is copied
+ * and a pointer to an element (see segvec_at) stays valid until the element
+ * is removed or the SegVec is destroyed.
+ *
+ * The segment holding index i is found in O(1) from the position of the
+ * highest set bit of i + SEGVEC_FIRST_SEGMENT.
+ *
+ * segments[0 .. num_segments) are allocated, the rest are NULL. Because
+ * nothing points into the struct itself, a SegVec can be returned and copied
+ * by value like a Vec. Only one copy may be used afterwards, though.
+ */
+typedef struct seg_vec_st {
+  ptr_t* segments[SEGVEC_MAX_SEGMENTS];
+  size_t num_segments;
+  size_t length;
+  size_t capacity;
+  ptr_dtor_fn ele_dtor_fn;
+} SegVec;
+
+/*!
+ * Creates a new empty SegVec with room for at least initial_capacity
+ * elements and the specified element destructor.
+ *
+ * @param initial_capacity the minimum initial capacity, 0 does not allocate
+ * @param ele_dtor_fn      the element destructor, same as in vec_new
+ * @returns a newly created segmented vector with 0 length.
+ * @post if memory allocation fails, the function will panic.
+ */
+SegVec segvec_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the current capacity of the SegVec
+ *
+ * @param vec, a pointer to the segmented vector we want to grab the capacity
+ * of.
+ */
+#define segvec_capacity(vec) ((vec)->capacity)
+
+/* Returns the current length of the SegVec
+ *
+ * @param vec, a pointer to the segmented vector we want to grab the len of.
+ */
+#define segvec_len(vec) ((vec)->length)
+
+/* Checks if the SegVec is empty
+ *
+ * @param vec, a pointer to the segmented vector we want to check emptiness
+ * of.
+ */
+#define segvec_is_empty(vec) ((vec)->length == 0)
+
+/* Gets the specified element of the SegVec
+ * Same as vec_get, panics if index >= self->length
+ */
+ptr_t segvec_get(SegVec* self, size_t index);
+
+/* Returns the address of the specified element of the SegVec. It stays
+ * valid across pushes, until the element is popped or cleared or the SegVec
+ * is destroyed.
+ * Panics if index >= self->length
+ */
+ptr_t* segvec_at(SegVec* self, size_t index);
+
+/* Sets the specified element of the SegVec to the specified value
+ * Same as vec_set: the replaced element is destructed and this panics if
+ * index >= self->length
+ */
+void segvec_set(SegVec* self, size_t index, ptr_t new_ele);
+
+/* Appends the given element to the end of the SegVec
+ *
+ * @param self      a pointer to the segmented vector we are pushing onto
+ * @param new_ele   the value we want to add to the end of the container
+ * @pre Assumes self points to a valid segmented vector.
+ * @post If the SegVec is full the next segment, twice the size of the last
+ * one, is allocated. If that fails, this function will panic(). Existing
+ * elements are never moved.
+ */
+void segvec_push_back(SegVec* self, ptr_t new_ele);
+
+/* Removes and destroys the last element of the SegVec
+ * Same as vec_pop_back, the capacity stays the same.
+ *
+ * @returns true iff an element was removed.
+ */
+bool segvec_pop_back(SegVec* self);
+
+/* Allocates segments until the capacity is at least `capacity`.
+ * Existing elements are never moved.
+ *
+ * @post If the allocation fails, then this function will panic()
+ */
+void segvec_reserve(SegVec* self, size_t capacity);
+
+/* Erases all elements from the SegVec, destructing them.
+ * Capacity is unchanged.
+ */
+void segvec_clear(SegVec* self);
+
+/* Destruct the SegVec.
+ * All elements are destructed and every segment is deallocated.
+ * Capacity and length are set to zero.
+ */
+void segvec_destroy(SegVec* self);
+
+/* A gap buffer with the Vec element model, for inserts and erases that
+ * cluster around a cursor, like the text of an editor. The elements are
+ * stored in one buffer with a gap of free slots at the cursor:
+ *
+ *   data[0 .. gap_start)         elements before the cursor
+ *   data[gap_start .. gap_end)   the gap
+ *   data[gap_end .. capacity)    elements after the cursor
+ *
+ * Inserting or erasing at the cursor only moves the edge of the gap, so it
+ * is O(1) (amortized, for inserts that grow the buffer). Moving the cursor
+ * moves the elements it passes over across the gap, so it costs the
+ * distance moved rather than the length. Logical element i is
+ * data[i] before the gap and data[i + gap size] after it.
+ */
+typedef struct gap_buf_st {
+  ptr_t* data;
+  size_t gap_start;
+  size_t gap_end;
+  size_t capacity;
+  ptr_dtor_fn ele_dtor_fn;
+} GapBuf;
+
+/*!
+ * Creates a new empty GapBuf with the specified initial_capacity and element
+ * destructor. The cursor is at 0.
+ *
+ * @param initial_capacity the initial capacity, 0 does not allocate
+ * @param ele_dtor_fn      the element destructor, same as in vec_new
+ * @returns a newly created gap buffer with 0 length.
+ * @post if memory allocation fails, the function will panic.
+ */
+GapBuf gbuf_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the current capacity of the GapBuf
+ *
+ * @param vec, a pointer to the gap buffer we want to grab the capacity of.
+ */
+#define gbuf_capacity(vec) ((vec)->capacity)
+
+/* Returns the current length of the GapBuf
+ *
+ * @param vec, a pointer to the gap buffer we want to grab the len of.
+ */
+#define gbuf_len(vec) ((vec)->capacity - ((vec)->gap_end - (vec)->gap_start))
+
+/* Checks if the GapBuf is empty
+ *
+ * @param vec, a pointer to the gap buffer we want to check emptiness of.
+ */
+#define gbuf_is_empty(vec) (gbuf_len(vec) == 0)
+
+/* Returns the position of the cursor: the number of elements before it.
+ *
+ * @param vec, a pointer to the gap buffer we want to grab the cursor of.
+ */
+#define gbuf_cursor(vec) ((vec)->gap_start)
+
+/* Gets the element at the specified logical index of the GapBuf
+ * Same as vec_get, panics if index >= gbuf_len(self)
+ */
+ptr_t gbuf_get(GapBuf* self, size_t index);
+
+/* Sets the element at the specified logical index of the GapBuf
+ * Same as vec_set: the replaced element is destructed and this panics if
+ * index >= gbuf_len(self)
+ */
+void gbuf_set(GapBuf* self, size_t index, ptr_t new_ele);
+
+/* Moves the cursor to just before logical index `cursor`, i.e. so that
+ * `cursor` elements are before it. Moves the elements between the old and
+ * the new position across the gap, no others.
+ *
+ * @pre cursor <= gbuf_len(self), otherwise this function will panic()
+ */
+void gbuf_move_to(GapBuf* self, size_t cursor);
+
+/* Inserts the given element at the cursor. The cursor ends up after it, so
+ * consecutive inserts keep their order.
+ *
+ * @post If the gap is empty, the capacity is doubled (0 becomes 1) and the
+ * elements after the gap are moved to the end of the new buffer. If the
+ * reallocation fails, then this function will panic().
+ */
+void gbuf_insert(GapBuf* self, ptr_t new_ele);
+
+/* Removes and destroys the element just before the cursor, like backspace.
+ *
+ * @returns true iff an element was removed, false if the cursor is at 0.
+ */
+bool gbuf_erase_before(GapBuf* self);
+
+/* Removes and destroys the element just after the cursor, like delete.
+ *
+ * @returns true iff an element was removed, false if the cursor is at the
+ * end.
+ */
+bool gbuf_erase_after(GapBuf* self);
+
+/* Exposes the contents of the GapBuf as the two contiguous slices on either
+ * side of the gap. Visiting before and then after gives the elements in
+ * order.
+ *
+ * @post The slices are invalidated by any operation that modifies the gap
+ * buffer or moves its cursor.
+ */
+void gbuf_as_slices(GapBuf* self, VecSlice* before, VecSlice* after);
+
+/* Erases all elements from the GapBuf, destructing them.
+ * Capacity is unchanged and the cursor goes back to 0.
+ */
+void gbuf_clear(GapBuf* self);
+
+/* Destruct the GapBuf.
+ * All elements are destructed and storage is deallocated.
+ * Capacity and length are set to zero and data is set to NULL.
+ */
+void gbuf_destroy(GapBuf* self);
+
 #endif  // VEC_H_
@@ -0,0 +1,172 @@
+#include "./allocator.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./panic.h"
+
+// --- libc ---
+
+static void* libc_alloc(void* ctx, size_t size) {
+  (void)ctx;
+  return malloc(size);
+}
+
+static void* libc_realloc(void* ctx,
+                          void* ptr,
+                          size_t old_size,
+                          size_t new_size) {
+  (void)ctx;
+  (void)old_size;
+  return realloc(ptr, new_size);
+}
+
+static void libc_free(void* ctx, void* ptr, size_t size) {
+  (void)ctx;
+  (void)size;
+  free(ptr);
+}
+
+const Allocator allocator_libc = {libc_alloc, libc_realloc, libc_free, NULL};
+
+// --- pool ---
+
+#define POOL_NUM_CLASSES 9  // 16, 32, ..., 4096
+
+// A freed block, linked into the free list of its class.
+typedef struct pool_block_st {
+  struct pool_block_st* next;
+} pool_block;
+
+typedef struct pool_slab_st {
+  struct pool_slab_st* next;
+} pool_slab;
+
+typedef struct pool_class_st {
+  pool_block* free_list;
+  unsigned char* bump;  // next never used block in the current slab
+  unsigned char* bump_end;
+} pool_class;
+
+struct pool_st {
+  pool_class classes[POOL_NUM_CLASSES];
+  pool_slab* slabs;
+  Allocator iface;
+};
+
+// Index of the smallest class that fits size, which must be at most
+// POOL_MAX_CLASS_SIZE.
+static size_t pool_class_index(size_t size) {
+  size_t index = 0;
+  size_t class_size = POOL_MIN_CLASS_SIZE;
+  while (class_size < size) {
+    class_size <<= 1U;
+    index++;
+  }
+  return index;
+}
+
+static void* pool_alloc(void* ctx, size_t size) {
+  Pool* pool = (Pool*)ctx;
+  if (size > POOL_MAX_CLASS_SIZE) {
+    return malloc(size);
+  }
+
+  size_t index = pool_class_index(size);
+  pool_class* cls = &pool->classes[index];
+
+  if (cls->free_list != NULL) {
+    pool_block* block = cls->free_list;
+    cls->free_list = block->next;
+    return block;
+  }
+
+  size_t class_size = POOL_MIN_CLASS_SIZE << index;
+  if (cls->bump == NULL || (size_t)(cls->bump_end - cls->bump) < class_size) {
+    pool_slab* slab = (pool_slab*)malloc(POOL_SLAB_SIZE);
+    if (slab == NULL) {
+      return NULL;
+    }
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    // the slab header takes up the first block, so blocks stay aligned
+    cls->bump = (unsigned char*)slab + class_size;
+    cls->bump_end = (unsigned char*)slab + POOL_SLAB_SIZE;
+  }
+
+  void* block = cls->bump;
+  cls->bump += class_size;
+  return block;
+}
+
+static void pool_free(void* ctx, void* ptr, size_t size) {
+  Pool* pool = (Pool*)ctx;
+  if (ptr == NULL) {
+    return;
+  }
+  if (size > POOL_MAX_CLASS_SIZE) {
+    free(ptr);
+    return;
+  }
+
+  pool_class* cls = &pool->classes[pool_class_index(size)];
+  pool_block* block = (pool_block*)ptr;
+  block->next = cls->free_list;
+  cls->free_list = block;
+}
+
+static void* pool_realloc(void* ctx,
+                          void* ptr,
+                          size_t old_size,
+                          size_t new_size) {
+  if (ptr == NULL) {
+    return pool_alloc(ctx, new_size);
+  }
+
+  if (old_size > POOL_MAX_CLASS_SIZE && new_size > POOL_MAX_CLASS_SIZE) {
+    return realloc(ptr, new_size);
+  }
+  if (old_size <= POOL_MAX_CLASS_SIZE && new_size <= POOL_MAX_CLASS_SIZE &&
+      pool_class_index(old_size) == pool_class_index(new_size)) {
+    return ptr;
+  }
+
+  void* new_ptr = pool_alloc(ctx, new_size);
+  if (new_ptr == NULL) {
+    return NULL;
+  }
+  memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+  pool_free(ctx, ptr, old_size);
+  return new_ptr;
+}
+
+Pool* pool_new(void) {
+  Pool* pool = (Pool*)calloc(1, sizeof(Pool));
+  if (pool == NULL) {
+    panic("Memory allocation failed in pool_new");
+    return NULL;
+  }
+
+  pool->iface.alloc_fn = pool_alloc;
+  pool->iface.realloc_fn = pool_realloc;
+  pool->iface.free_fn = pool_free;
+  pool->iface.ctx = pool;
+  return pool;
+}
+
+const Allocator* pool_allocator(Pool* self) {
+  return &self->iface;
+}
+
+void pool_destroy(Pool* self) {
+  if (self == NULL) {
+    return;
+  }
+
+  pool_slab* slab = self->slabs;
+  while (slab != NULL) {
+    pool_slab* next = slab->next;
+    free(slab);
+    slab = next;
+  }
+  free(self);
+}
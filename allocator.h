@@ -0,0 +1,72 @@
+#ifndef ALLOCATOR_H_
+#define ALLOCATOR_H_
+
+/*!
+ * A pluggable memory allocator for containers. An Allocator is a small
+ * vtable plus a context pointer that is passed back on every call. Vec
+ * (vec_new_with_allocator) and vector(T) (vector_new_with_allocator) store a
+ * pointer to one, and every allocation, reallocation and deallocation of
+ * their storage goes through it. The Allocator must outlive the containers
+ * using it.
+ *
+ * Unlike malloc/free, the size of a block is passed back to realloc_fn and
+ * free_fn, so allocators don't need to keep a header per block.
+ *
+ * Two reference implementations are provided:
+ *   allocator_libc       plain malloc/realloc/free
+ *   pool_allocator(pool) power of two size classes with per class free lists
+ */
+
+#include <stddef.h>  // for size_t
+
+typedef struct allocator_st {
+  // Returns a block of at least size bytes, or NULL on failure.
+  void* (*alloc_fn)(void* ctx, size_t size);
+  // Resizes a block from this allocator (or allocates one if ptr is NULL),
+  // keeping the first min(old_size, new_size) bytes. Returns NULL on failure,
+  // in which case ptr is still valid.
+  void* (*realloc_fn)(void* ctx, void* ptr, size_t old_size, size_t new_size);
+  // Returns a block of `size` bytes to the allocator. ptr may be NULL.
+  void (*free_fn)(void* ctx, void* ptr, size_t size);
+  void* ctx;
+} Allocator;
+
+/* Allocator backed by malloc, realloc and free. */
+extern const Allocator allocator_libc;
+
+/* Smallest and largest size class of a Pool, in bytes. Requests bigger than
+ * POOL_MAX_CLASS_SIZE bypass the pool and go to malloc.
+ */
+#define POOL_MIN_CLASS_SIZE ((size_t)16)
+#define POOL_MAX_CLASS_SIZE ((size_t)4096)
+
+/* Size of the slabs a Pool carves its blocks out of. */
+#define POOL_SLAB_SIZE ((size_t)64 * 1024)
+
+typedef struct pool_st Pool;
+
+/*!
+ * Creates a new pool allocator with power of two size classes from
+ * POOL_MIN_CLASS_SIZE to POOL_MAX_CLASS_SIZE. Each class keeps a free list,
+ * so freeing and reallocating a block of the same class is O(1) and never
+ * returns memory to the system until the pool is destroyed.
+ *
+ * A Pool is not thread safe.
+ *
+ * @returns a pointer to the new pool, destroy it with pool_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+Pool* pool_new(void);
+
+/* Returns the Allocator interface of a pool, valid until pool_destroy.
+ */
+const Allocator* pool_allocator(Pool* self);
+
+/* Releases all memory held by the pool, including pooled blocks that are
+ * still in use. Blocks bigger than POOL_MAX_CLASS_SIZE come straight from
+ * malloc and must have been freed through the allocator before.
+ * Does nothing if self is NULL.
+ */
+void pool_destroy(Pool* self);
+
+#endif  // ALLOCATOR_H_
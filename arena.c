@@ -0,0 +1,154 @@
+#include "./arena.h"
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./panic.h"
+
+#define ARENA_ALIGN alignof(max_align_t)
+
+// Chunks are kept in a singly linked list, the one being bumped first.
+typedef struct arena_chunk_st {
+  struct arena_chunk_st* next;
+  size_t size;  // bytes available in data
+  size_t used;  // bytes handed out from data
+  alignas(max_align_t) unsigned char data[];
+} arena_chunk;
+
+struct arena_st {
+  arena_chunk* head;
+  size_t chunk_size;
+  // where the most recent allocation lives, so it can be grown in place
+  arena_chunk* last_chunk;
+  size_t last_offset;
+};
+
+static size_t arena_round_up(size_t size) {
+  if (size > SIZE_MAX - (ARENA_ALIGN - 1)) {
+    panic("Allocation too large for arena");
+  }
+  return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+static arena_chunk* arena_chunk_new(size_t size) {
+  if (size > SIZE_MAX - sizeof(arena_chunk)) {
+    return NULL;
+  }
+
+  arena_chunk* chunk = (arena_chunk*)malloc(sizeof(arena_chunk) + size);
+  if (chunk == NULL) {
+    return NULL;
+  }
+  chunk->next = NULL;
+  chunk->size = size;
+  chunk->used = 0;
+  return chunk;
+}
+
+Arena* arena_new(size_t chunk_size) {
+  Arena* arena = (Arena*)malloc(sizeof(Arena));
+  if (arena == NULL) {
+    panic("Memory allocation failed in arena_new");
+    return NULL;
+  }
+
+  arena->head = NULL;
+  arena->chunk_size = arena_round_up(
+      chunk_size == 0 ? ARENA_DEFAULT_CHUNK_SIZE : chunk_size);
+  arena->last_chunk = NULL;
+  arena->last_offset = 0;
+  return arena;
+}
+
+void* arena_alloc(Arena* self, size_t size) {
+  size_t rounded = arena_round_up(size == 0 ? 1 : size);
+  arena_chunk* chunk = self->head;
+
+  if (chunk == NULL || chunk->size - chunk->used < rounded) {
+    bool dedicated = rounded > self->chunk_size / 2;
+    chunk = arena_chunk_new(dedicated ? rounded : self->chunk_size);
+    if (chunk == NULL) {
+      panic("Memory allocation failed in arena_alloc");
+      return NULL;
+    }
+
+    if (dedicated && self->head != NULL) {
+      // big allocations get their own chunk, behind the one being bumped so
+      // the space left in that one is not wasted
+      chunk->next = self->head->next;
+      self->head->next = chunk;
+    } else {
+      chunk->next = self->head;
+      self->head = chunk;
+    }
+  }
+
+  self->last_chunk = chunk;
+  self->last_offset = chunk->used;
+  chunk->used += rounded;
+  return &chunk->data[self->last_offset];
+}
+
+void* arena_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size) {
+  if (ptr == NULL) {
+    return arena_alloc(self, new_size);
+  }
+
+  arena_chunk* chunk = self->last_chunk;
+  if (chunk != NULL && ptr == &chunk->data[self->last_offset]) {
+    size_t rounded = arena_round_up(new_size == 0 ? 1 : new_size);
+    if (rounded <= chunk->size - self->last_offset) {
+      chunk->used = self->last_offset + rounded;
+      return ptr;
+    }
+  }
+
+  void* new_ptr = arena_alloc(self, new_size);
+  memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+  return new_ptr;
+}
+
+size_t arena_footprint(const Arena* self) {
+  size_t total = 0;
+  for (arena_chunk* chunk = self->head; chunk != NULL; chunk = chunk->next) {
+    total += chunk->size;
+  }
+  return total;
+}
+
+void arena_reset(Arena* self) {
+  arena_chunk* keep = NULL;
+  arena_chunk* chunk = self->head;
+  while (chunk != NULL) {
+    arena_chunk* next = chunk->next;
+    if (keep == NULL && chunk->size == self->chunk_size) {
+      keep = chunk;
+    } else {
+      free(chunk);
+    }
+    chunk = next;
+  }
+
+  if (keep != NULL) {
+    keep->next = NULL;
+    keep->used = 0;
+  }
+  self->head = keep;
+  self->last_chunk = NULL;
+  self->last_offset = 0;
+}
+
+void arena_destroy(Arena* self) {
+  if (self == NULL) {
+    return;
+  }
+
+  arena_chunk* chunk = self->head;
+  while (chunk != NULL) {
+    arena_chunk* next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  free(self);
+}
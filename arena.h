@@ -0,0 +1,74 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/*!
+ * A region (bump) allocator. Memory is handed out from large chunks by
+ * bumping an offset, there is no per allocation header and no way to free a
+ * single allocation. Everything allocated from an arena is released at once
+ * by arena_reset or arena_destroy.
+ *
+ * This is meant for request scoped data: allocate the elements of one or
+ * more vectors from an arena and throw the whole thing away at the end,
+ * instead of free()'ing thousands of small objects one at a time.
+ *
+ * All allocations are aligned for any type (max_align_t).
+ */
+
+#include <stddef.h>  // for size_t
+
+/* Chunk size used when arena_new is given 0. */
+#define ARENA_DEFAULT_CHUNK_SIZE ((size_t)64 * 1024)
+
+typedef struct arena_st Arena;
+
+/*!
+ * Creates a new empty arena.
+ *
+ * @param chunk_size the size in bytes of the chunks memory is carved out of.
+ *                   0 selects ARENA_DEFAULT_CHUNK_SIZE. Allocations bigger
+ *                   than this get a chunk of their own.
+ * @returns a pointer to the new arena, destroy it with arena_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+Arena* arena_new(size_t chunk_size);
+
+/* Allocates size bytes from the arena.
+ *
+ * @param self a pointer to the arena to allocate from
+ * @param size the number of bytes to allocate
+ * @returns a pointer to uninitialized memory, valid until the arena is reset
+ * or destroyed. Never NULL.
+ * @post if memory allocation fails, the function will panic.
+ */
+void* arena_alloc(Arena* self, size_t size);
+
+/* Grows an allocation from the arena to new_size bytes.
+ * If ptr is the most recent allocation and its chunk has room, it is
+ * extended in place. Otherwise new memory is allocated and the first
+ * old_size bytes are copied over, the old memory stays allocated until the
+ * arena is reset or destroyed.
+ *
+ * @param self     a pointer to the arena ptr was allocated from
+ * @param ptr      an allocation from this arena, or NULL
+ * @param old_size the size ptr was allocated with (0 if ptr is NULL)
+ * @param new_size the size wanted
+ * @returns a pointer to at least new_size bytes holding the old contents.
+ * @post if memory allocation fails, the function will panic.
+ */
+void* arena_realloc(Arena* self, void* ptr, size_t old_size, size_t new_size);
+
+/* Returns the total number of bytes of chunks held by the arena.
+ */
+size_t arena_footprint(const Arena* self);
+
+/* Releases every allocation made from the arena at once.
+ * One regular sized chunk is kept for reuse, all others are freed.
+ */
+void arena_reset(Arena* self);
+
+/* Releases every allocation made from the arena and the arena itself.
+ * Does nothing if self is NULL.
+ */
+void arena_destroy(Arena* self);
+
+#endif  // ARENA_H_
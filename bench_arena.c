@@ -0,0 +1,104 @@
+#include "./Vec.h"
+#include "./arena.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Builds request scoped vectors of small heap objects and tears them down,
+// once the way test_basic.cpp does it (malloc'd elements, ele_dtor_fn =
+// free) and once with vec_new_in_arena, where vec_destroy drops the arena.
+//
+// usage: ./bench_arena [rounds] [elements] [object_size]
+//        (default 1000 rounds of 10000 objects of 32 bytes)
+
+#define DEFAULT_ROUNDS 1000UL
+#define DEFAULT_ELEMENTS 10000UL
+#define DEFAULT_OBJECT_SIZE 32UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static uintptr_t run_malloc(size_t rounds, size_t elements, size_t size) {
+  uintptr_t check = 0;
+  for (size_t r = 0; r < rounds; r++) {
+    Vec vec = vec_new(0, free);
+    for (size_t i = 0; i < elements; i++) {
+      unsigned char* obj = malloc(size);
+      if (obj == NULL) {
+        exit(EXIT_FAILURE);
+      }
+      memset(obj, (int)i, size);
+      vec_push_back(&vec, obj);
+    }
+    check += *(unsigned char*)vec_get(&vec, elements / 2);
+    vec_destroy(&vec);
+  }
+  return check;
+}
+
+static uintptr_t run_arena(size_t rounds, size_t elements, size_t size) {
+  uintptr_t check = 0;
+  for (size_t r = 0; r < rounds; r++) {
+    Vec vec = vec_new_in_arena(0, 0);
+    for (size_t i = 0; i < elements; i++) {
+      unsigned char* obj = arena_alloc(vec.arena, size);
+      memset(obj, (int)i, size);
+      vec_push_back(&vec, obj);
+    }
+    check += *(unsigned char*)vec_get(&vec, elements / 2);
+    vec_destroy(&vec);
+  }
+  return check;
+}
+
+int main(int argc, char* argv[]) {
+  size_t rounds = DEFAULT_ROUNDS;
+  size_t elements = DEFAULT_ELEMENTS;
+  size_t size = DEFAULT_OBJECT_SIZE;
+  if (argc > 1) {
+    rounds = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    elements = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+  if (argc > 3) {
+    size = (size_t)strtoull(argv[3], NULL, BASE_10);
+  }
+  if (elements == 0 || size == 0) {
+    fprintf(stderr, "elements and object_size must be non zero\n");
+    return EXIT_FAILURE;
+  }
+
+  struct timespec start;
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  uintptr_t malloc_check = run_malloc(rounds, elements, size);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double malloc_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  uintptr_t arena_check = run_arena(rounds, elements, size);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double arena_secs = elapsed(start, end);
+
+  double ns_scale = NS_PER_SEC / (double)rounds / (double)elements;
+  printf("%zu rounds of %zu objects of %zu bytes\n", rounds, elements, size);
+  printf("malloc + free dtor  %.3f s  %.1f ns/element\n", malloc_secs,
+         malloc_secs * ns_scale);
+  printf("arena Vec           %.3f s  %.1f ns/element\n", arena_secs,
+         arena_secs * ns_scale);
+
+  if (malloc_check != arena_check) {
+    fprintf(stderr, "checksum mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
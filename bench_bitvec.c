@@ -0,0 +1,154 @@
+#include "./bitvec.h"
+#include "./vector.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Compares a vector(bool) with a BitVec, counting the set flags and ANDing
+// two flag sets, and a vector(uint8_t) of 4 bit codes with a PackedVec,
+// counting the codes equal to a value (rank). Also prints the memory each
+// of them uses.
+//
+// usage: ./bench_bitvec [values] [rounds]
+//        (default 2^24 values, 20 rounds)
+
+#define DEFAULT_VALUES ((size_t)1 << 24)
+#define DEFAULT_ROUNDS 20UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define BYTES_PER_MB 1e6
+#define CODE_WIDTH 4U
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+// splitmix64, so that every run uses the same values
+static uint64_t next_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static void report(const char* name,
+                   double secs,
+                   size_t rounds,
+                   size_t n,
+                   size_t bytes) {
+  printf("  %-26s %8.3f s  %6.3f ns/value  %8.2f MB\n", name, secs,
+         secs * NS_PER_SEC / ((double)rounds * (double)n),
+         (double)bytes / BYTES_PER_MB);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = DEFAULT_VALUES;
+  size_t rounds = DEFAULT_ROUNDS;
+  if (argc > 1) {
+    n = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    rounds = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  uint64_t state = 1;
+  vector(bool) flags_a = vector_new(bool, n, NULL);
+  vector(bool) flags_b = vector_new(bool, n, NULL);
+  vector(uint8_t) codes = vector_new(uint8_t, n, NULL);
+  BitVec bits_a = bitvec_new(n);
+  BitVec bits_b = bitvec_new(n);
+  PackedVec packed = packvec_new(CODE_WIDTH, n);
+  for (size_t i = 0; i < n; i++) {
+    uint64_t r = next_random(&state);
+    vector_push(&flags_a, (r & 1U) != 0);
+    vector_push(&flags_b, (r & 2U) != 0);
+    vector_push(&codes, (uint8_t)((r >> 8) & 0xfU));
+    bitvec_push(&bits_a, (r & 1U) != 0);
+    bitvec_push(&bits_b, (r & 2U) != 0);
+    packvec_push(&packed, (uint32_t)((r >> 8) & 0xfU));
+  }
+
+  struct timespec start;
+  struct timespec end;
+  size_t check[2][3] = {{0}};
+
+  printf("%zu values, %zu rounds\n", n, rounds);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < n; i++) {
+      check[0][0] += flags_a[i];
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("count vector(bool)", elapsed(start, end), rounds, n, n);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    check[1][0] += bitvec_popcount(&bits_a, 0, n);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("bitvec_popcount", elapsed(start, end), rounds, n, n / 8);
+
+  // the AND is idempotent, so repeating it leaves the same result
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < n; i++) {
+      flags_b[i] = flags_b[i] & flags_a[i];
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("and vector(bool)", elapsed(start, end), rounds, n, n);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    bitvec_and(&bits_b, &bits_a, 0, n);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("bitvec_and", elapsed(start, end), rounds, n, n / 8);
+
+  for (size_t i = 0; i < n; i++) {
+    check[0][1] += flags_b[i];
+  }
+  check[1][1] = bitvec_popcount(&bits_b, 0, n);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    uint8_t code = (uint8_t)(r % 16);
+    for (size_t i = 0; i < n; i++) {
+      check[0][2] += codes[i] == code;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("rank vector(uint8_t)", elapsed(start, end), rounds, n, n);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    check[1][2] += packvec_rank(&packed, n, (uint32_t)(r % 16));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("packvec_rank, 4 bits", elapsed(start, end), rounds, n,
+         n * CODE_WIDTH / 8);
+
+  int ok = 1;
+  for (size_t k = 0; k < 3; k++) {
+    ok = ok && check[0][k] == check[1][k];
+  }
+
+  vector_free(&flags_a);
+  vector_free(&flags_b);
+  vector_free(&codes);
+  bitvec_destroy(&bits_a);
+  bitvec_destroy(&bits_b);
+  packvec_destroy(&packed);
+
+  if (!ok) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+#include "./Vec.h"
+#include "./concurrent_vec.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// Fills one vector from many threads, once with a Vec behind a mutex and
+// once with a ConcurrentVec, for 1, 2, 4, ... up to `threads` producers.
+// The total number of elements stays the same, so on a machine with enough
+// cores the ConcurrentVec time should drop as producers are added while the
+// mutex time does not.
+//
+// usage: ./bench_concurrent [elements] [threads]
+//        (default 4 * 10^7 elements, as many threads as online cores)
+
+#define DEFAULT_ELEMENTS 40000000UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+typedef struct producer_st {
+  pthread_mutex_t* lock;
+  Vec* vec;
+  ConcurrentVec* cvec;
+  size_t first;
+  size_t count;
+} producer;
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static void* push_locked(void* arg) {
+  producer* p = arg;
+  for (size_t i = p->first; i < p->first + p->count; i++) {
+    pthread_mutex_lock(p->lock);
+    vec_push_back(p->vec, (ptr_t)(uintptr_t)i);
+    pthread_mutex_unlock(p->lock);
+  }
+  return NULL;
+}
+
+static void* push_concurrent(void* arg) {
+  producer* p = arg;
+  for (size_t i = p->first; i < p->first + p->count; i++) {
+    cvec_push_back(p->cvec, (ptr_t)(uintptr_t)i);
+  }
+  return NULL;
+}
+
+// Runs `threads` producers that together push `elements` elements, and
+// returns the elapsed seconds.
+static double run(void* (*fn)(void*),
+                  producer template,
+                  size_t elements,
+                  size_t threads) {
+  pthread_t* ids = malloc(threads * sizeof(pthread_t));
+  producer* args = malloc(threads * sizeof(producer));
+  if (ids == NULL || args == NULL) {
+    exit(EXIT_FAILURE);
+  }
+
+  struct timespec start;
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t t = 0; t < threads; t++) {
+    args[t] = template;
+    args[t].first = elements / threads * t;
+    args[t].count = t + 1 == threads ? elements - args[t].first
+                                     : elements / threads;
+    pthread_create(&ids[t], NULL, fn, &args[t]);
+  }
+  for (size_t t = 0; t < threads; t++) {
+    pthread_join(ids[t], NULL);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  free(ids);
+  free(args);
+  return elapsed(start, end);
+}
+
+static uintptr_t checksum(Vec* vec) {
+  uintptr_t check = 0;
+  for (size_t i = 0; i < vec->length; i++) {
+    check += (uintptr_t)vec_get(vec, i);
+  }
+  return check;
+}
+
+int main(int argc, char* argv[]) {
+  size_t elements = DEFAULT_ELEMENTS;
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t max_threads = cores > 0 ? (size_t)cores : 1;
+  if (argc > 1) {
+    elements = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    max_threads = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+  if (max_threads == 0) {
+    fprintf(stderr, "threads must be non zero\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%zu elements, up to %zu threads\n", elements, max_threads);
+  printf("threads  mutex Vec       ConcurrentVec\n");
+  for (size_t threads = 1;; threads *= 2) {
+    if (threads > max_threads) {
+      threads = max_threads;
+    }
+
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    Vec vec = vec_new(0, NULL);
+    producer locked = {&lock, &vec, NULL, 0, 0};
+    double locked_secs = run(push_locked, locked, elements, threads);
+    uintptr_t locked_check = checksum(&vec);
+    vec_destroy(&vec);
+
+    producer concurrent = {NULL, NULL, cvec_new(0, NULL), 0, 0};
+    double concurrent_secs = run(push_concurrent, concurrent, elements, threads);
+    vec = cvec_into_vec(concurrent.cvec);
+    uintptr_t concurrent_check = checksum(&vec);
+    vec_destroy(&vec);
+
+    double ns_scale = NS_PER_SEC / (double)elements;
+    printf("%7zu  %.3f s %5.1f ns  %.3f s %5.1f ns\n", threads, locked_secs,
+           locked_secs * ns_scale, concurrent_secs,
+           concurrent_secs * ns_scale);
+
+    if (locked_check != concurrent_check) {
+      fprintf(stderr, "checksum mismatch\n");
+      return EXIT_FAILURE;
+    }
+    if (threads == max_threads) {
+      break;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#include "./Vec.h"
+#include "./delta_vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Stores mostly sorted millisecond timestamps, most of them 0 to 255 ms
+// apart and a few of them out of order, in a Vec of (ptr_t)(intptr_t)value
+// and in a DeltaVec. Prints the bytes each of them takes and how fast the
+// values can be read back: sequentially, as a whole (dvec_decode), and at
+// random indices (dvec_get).
+//
+// usage: ./bench_delta_vec [values] [rounds]
+//        (default 2^24 values, 10 rounds)
+
+#define DEFAULT_VALUES ((size_t)1 << 24)
+#define DEFAULT_ROUNDS 10UL
+#define RANDOM_READS ((size_t)1 << 20)
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define BYTES_PER_MB 1e6
+#define START_MS 1700000000000LL
+#define OUT_OF_ORDER_ONE_IN 64U
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+// splitmix64, so that every run uses the same values
+static uint64_t next_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = DEFAULT_VALUES;
+  size_t rounds = DEFAULT_ROUNDS;
+  if (argc > 1) {
+    n = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    rounds = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  struct timespec start;
+  struct timespec end;
+  uint64_t state = 1;
+  Vec boxed = vec_new(0, NULL);
+  DeltaVec* packed = dvec_new();
+  int64_t t = START_MS;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < n; i++) {
+    uint64_t r = next_random(&state);
+    int64_t value = t + (int64_t)(r & 0xffU);
+    t = value;
+    if ((r >> 32) % OUT_OF_ORDER_ONE_IN == 0) {
+      value -= (int64_t)((r >> 8) & 0xfffU);
+    }
+    vec_push_back(&boxed, (ptr_t)(intptr_t)value);
+    dvec_push_back(packed, value);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  size_t vec_bytes = n * sizeof(ptr_t);
+  size_t dvec_bytes = dvec_encoded_bytes(packed);
+  printf("%zu timestamps, built in %.3f s\n", n, elapsed(start, end));
+  printf("  Vec       %8.2f MB  %5.2f bytes/value\n",
+         (double)vec_bytes / BYTES_PER_MB, (double)vec_bytes / (double)n);
+  printf("  DeltaVec  %8.2f MB  %5.2f bytes/value  ratio %.2fx\n",
+         (double)dvec_bytes / BYTES_PER_MB, (double)dvec_bytes / (double)n,
+         (double)vec_bytes / (double)dvec_bytes);
+
+  int64_t* out = (int64_t*)malloc(n * sizeof(int64_t));
+  if (out == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+  int64_t check[2] = {0, 0};
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < n; i++) {
+      out[i] = (int64_t)(intptr_t)vec_get(&boxed, i);
+    }
+    check[0] += out[r % n];
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double secs = elapsed(start, end);
+  printf("  %-22s %7.3f s  %7.1f M values/s\n", "Vec copy out", secs,
+         (double)n * (double)rounds / secs / 1e6);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    dvec_decode(packed, 0, n, out);
+    check[1] += out[r % n];
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  secs = elapsed(start, end);
+  printf("  %-22s %7.3f s  %7.1f M values/s\n", "dvec_decode", secs,
+         (double)n * (double)rounds / secs / 1e6);
+
+  int ok = check[0] == check[1];
+  for (size_t i = 0; i < n; i++) {
+    ok = ok && out[i] == (int64_t)(intptr_t)vec_get(&boxed, i);
+  }
+
+  int64_t random_sum[2] = {0, 0};
+  uint64_t index_state = 2;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < RANDOM_READS; i++) {
+    size_t index = (size_t)(next_random(&index_state) % n);
+    random_sum[0] += (int64_t)(intptr_t)vec_get(&boxed, index);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("  %-22s %7.1f ns/read\n", "Vec random get",
+         elapsed(start, end) * NS_PER_SEC / RANDOM_READS);
+
+  index_state = 2;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < RANDOM_READS; i++) {
+    size_t index = (size_t)(next_random(&index_state) % n);
+    random_sum[1] += dvec_get(packed, index);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("  %-22s %7.1f ns/read\n", "dvec_get random",
+         elapsed(start, end) * NS_PER_SEC / RANDOM_READS);
+  ok = ok && random_sum[0] == random_sum[1];
+
+  free(out);
+  vec_destroy(&boxed);
+  dvec_destroy(packed);
+
+  if (!ok) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
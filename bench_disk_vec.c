@@ -0,0 +1,125 @@
+#include "./Vec.h"
+#include "./disk_vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Fills a DiskVec 10 times bigger than its memory budget, then scans it
+// twice from front to back and reads random elements, next to the same
+// work on an in-memory Vec. The scratch file goes to the given directory.
+//
+// usage: ./bench_disk_vec [budget in MB] [directory]
+//        (default 32 MB, so 320 MB of elements, in /tmp)
+
+#define DEFAULT_BUDGET_MB 32UL
+#define BUDGET_FACTOR 10
+#define RANDOM_READS ((size_t)1 << 16)
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define BYTES_PER_MB ((size_t)1 << 20)
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+// splitmix64, so that every run reads the same indices
+static uint64_t next_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static void report(const char* name, double secs, size_t bytes) {
+  printf("  %-24s %8.3f s  %8.1f MB/s\n", name, secs,
+         (double)bytes / (double)BYTES_PER_MB / secs);
+}
+
+int main(int argc, char* argv[]) {
+  size_t budget = DEFAULT_BUDGET_MB * BYTES_PER_MB;
+  const char* dir = NULL;
+  if (argc > 1) {
+    budget = (size_t)strtoull(argv[1], NULL, BASE_10) * BYTES_PER_MB;
+  }
+  if (argc > 2) {
+    dir = argv[2];
+  }
+  size_t n = BUDGET_FACTOR * budget / sizeof(ptr_t);
+  size_t bytes = n * sizeof(ptr_t);
+
+  struct timespec start;
+  struct timespec end;
+  uintptr_t check[2] = {0, 0};
+
+  printf("%zu elements (%zu MB) under a %zu MB budget\n", n,
+         bytes / BYTES_PER_MB, budget / BYTES_PER_MB);
+
+  Vec mem = vec_new(0, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < n; i++) {
+    vec_push_back(&mem, (ptr_t)i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("Vec push", elapsed(start, end), bytes);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < n; i++) {
+    check[0] += (uintptr_t)vec_get(&mem, i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("Vec scan", elapsed(start, end), bytes);
+
+  DiskVec* disk = diskvec_new(dir, budget, NULL);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < n; i++) {
+    diskvec_push_back(disk, (ptr_t)i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("diskvec_push_back", elapsed(start, end), bytes);
+
+  for (int pass = 1; pass <= 2; pass++) {
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uintptr_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+      sum += (uintptr_t)diskvec_get(disk, i);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    report(pass == 1 ? "diskvec_get scan" : "diskvec_get scan again",
+           elapsed(start, end), bytes);
+    check[1] = sum;
+  }
+
+  uint64_t state = 1;
+  uintptr_t random_sum[2] = {0, 0};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < RANDOM_READS; i++) {
+    random_sum[0] += (uintptr_t)vec_get(&mem, next_random(&state) % n);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("  %-24s %8.1f ns/read\n", "Vec random get",
+         elapsed(start, end) * NS_PER_SEC / RANDOM_READS);
+
+  state = 1;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < RANDOM_READS; i++) {
+    random_sum[1] += (uintptr_t)diskvec_get(disk, next_random(&state) % n);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("  %-24s %8.1f ns/read\n", "diskvec_get random",
+         elapsed(start, end) * NS_PER_SEC / RANDOM_READS);
+  printf("  resident pages: %zu MB\n",
+         diskvec_resident_bytes(disk) / BYTES_PER_MB);
+
+  int ok = check[0] == check[1] && random_sum[0] == random_sum[1];
+  vec_destroy(&mem);
+  diskvec_destroy(disk);
+
+  if (!ok) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
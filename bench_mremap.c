@@ -0,0 +1,65 @@
+#include "./Vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// Pushes N pointer-sized integers onto a Vec that starts empty, so every
+// power of two triggers a doubling, then reports wall time and peak RSS.
+//
+// Built twice by the Makefile:
+//   bench_mremap         large buffers are grown with mremap()
+//   bench_mremap_nommap  built with -DVEC_DISABLE_MMAP, malloc + copy + free
+//
+// usage: ./bench_mremap [num_elements]   (default 10^9, ~8 GiB of data)
+
+#define DEFAULT_NUM_ELEMENTS 1000000000UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define KIB_PER_MIB 1024.0
+
+int main(int argc, char* argv[]) {
+  size_t num_elements = DEFAULT_NUM_ELEMENTS;
+  if (argc > 1) {
+    num_elements = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+
+  struct timespec start;
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  Vec vec = vec_new(0, NULL);
+  for (size_t i = 0; i < num_elements; i++) {
+    vec_push_back(&vec, (ptr_t)(uintptr_t)i);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  // touch the ends so the pushes cannot be optimized away
+  uintptr_t check = 0;
+  if (!vec_is_empty(&vec)) {
+    check = (uintptr_t)vec_get(&vec, 0) +
+            (uintptr_t)vec_get(&vec, vec_len(&vec) - 1);
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  double secs = (double)(end.tv_sec - start.tv_sec) +
+                (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+
+#ifdef VEC_DISABLE_MMAP
+  const char* mode = "malloc+copy";
+#else
+  const char* mode = "mremap";
+#endif
+
+  printf("%-12s pushed %zu elements in %.3f s, peak RSS %.1f MiB (check %lu)\n",
+         mode, num_elements, secs, (double)usage.ru_maxrss / KIB_PER_MIB,
+         (unsigned long)check);
+
+  vec_destroy(&vec);
+  return EXIT_SUCCESS;
+}
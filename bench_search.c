@@ -0,0 +1,118 @@
+#include "./Vec.h"
+#include "./vec_search.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Scans a Vec for an element that is not in it (so every search reads the
+// whole vector) and counts the occurrences of one that is, with a naive
+// loop over vec_get and with vec_find / vec_count_eq on every search kernel
+// the CPU supports.
+//
+// usage: ./bench_search [elements] [rounds]
+//        (default 100 rounds over 10^6 elements, i.e. 8 MB)
+
+#define DEFAULT_ELEMENTS 1000000UL
+#define DEFAULT_ROUNDS 100UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define BYTES_PER_GB 1e9
+#define DISTINCT_VALUES 64
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static size_t naive_find(Vec* vec, ptr_t needle) {
+  for (size_t i = 0; i < vec->length; i++) {
+    if (vec_get(vec, i) == needle) {
+      return i;
+    }
+  }
+  return VEC_NOT_FOUND;
+}
+
+static size_t naive_count(Vec* vec, ptr_t needle) {
+  size_t count = 0;
+  for (size_t i = 0; i < vec->length; i++) {
+    count += vec_get(vec, i) == needle;
+  }
+  return count;
+}
+
+static void report(const char* name,
+                   double secs,
+                   size_t rounds,
+                   size_t elements) {
+  double bytes = (double)rounds * (double)elements * sizeof(ptr_t);
+  printf("  %-8s %8.3f s  %6.2f GB/s\n", name, secs,
+         bytes / secs / BYTES_PER_GB);
+}
+
+// Returns the total of all results so the work can't be optimized away and
+// the kernels can be compared with each other.
+static size_t run(const char* name,
+                  Vec* vec,
+                  size_t rounds,
+                  size_t (*find)(Vec*, ptr_t),
+                  size_t (*count)(Vec*, ptr_t)) {
+  struct timespec start;
+  struct timespec end;
+  size_t check = 0;
+
+  printf("%s\n", name);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    check += find(vec, (ptr_t)(uintptr_t)(DISTINCT_VALUES + r));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("find", elapsed(start, end), rounds, vec->length);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    check += count(vec, (ptr_t)(uintptr_t)(r % DISTINCT_VALUES));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("count", elapsed(start, end), rounds, vec->length);
+  return check;
+}
+
+int main(int argc, char* argv[]) {
+  size_t elements = DEFAULT_ELEMENTS;
+  size_t rounds = DEFAULT_ROUNDS;
+  if (argc > 1) {
+    elements = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    rounds = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  Vec vec = vec_new(elements, NULL);
+  for (size_t i = 0; i < elements; i++) {
+    vec_push_back(&vec, (ptr_t)(uintptr_t)(i % DISTINCT_VALUES));
+  }
+
+  printf("%zu elements, %zu rounds\n", elements, rounds);
+  size_t expected = run("naive vec_get loop", &vec, rounds, naive_find,
+                        naive_count);
+
+  const char* names[] = {"scalar", "SSE2", "AVX2"};
+  vec_search_kernel kernels[] = {VEC_SEARCH_SCALAR, VEC_SEARCH_SSE2,
+                                 VEC_SEARCH_AVX2};
+  for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+    if (!vec_search_use(kernels[k])) {
+      printf("%s: not supported\n", names[k]);
+      continue;
+    }
+    if (run(names[k], &vec, rounds, vec_find, vec_count_eq) != expected) {
+      fprintf(stderr, "result mismatch\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  vec_destroy(&vec);
+  return EXIT_SUCCESS;
+}
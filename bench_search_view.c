@@ -0,0 +1,163 @@
+#include "./Vec.h"
+#include "./search_view.h"
+#include "./vec_sort.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Looks up random keys in sorted vectors sized to fit in L1, L2 and the last
+// level cache, and one far bigger than any cache, with
+//   - vec_lower_bound (binary search through a comparator)
+//   - an inlined branchless binary search over the intptr keys
+//   - eytz_find, an EytzView through the same comparator
+//   - btv_find, a BTreeView
+// Half of the keys looked up are in the vector.
+//
+// usage: ./bench_search_view [lookups] [largest size]
+//        (default 10^6 lookups per size, largest size 2^24 elements, 128 MB)
+
+#define DEFAULT_LOOKUPS 1000000UL
+#define DEFAULT_LARGEST ((size_t)1 << 24)
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static int cmp_intptr(ptr_t a, ptr_t b, void* ctx) {
+  (void)ctx;
+  intptr_t x = (intptr_t)a;
+  intptr_t y = (intptr_t)b;
+  return (x > y) - (x < y);
+}
+
+// splitmix64, so the keys don't depend on the libc rand
+static uint64_t next_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static size_t inline_lower_bound(const intptr_t* keys, size_t n, intptr_t key) {
+  const intptr_t* base = keys;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = base[half - 1] < key ? base + half : base;
+    n -= half;
+  }
+  return (size_t)(base - keys) + (n == 1 && *base < key);
+}
+
+static void report(const char* name, double secs, size_t lookups) {
+  printf("  %-20s %8.3f s  %7.1f ns/lookup\n", name, secs,
+         secs * NS_PER_SEC / (double)lookups);
+}
+
+// Returns the number of keys found by every method, or SIZE_MAX if they
+// don't agree.
+static size_t run(size_t n, const intptr_t* queries, size_t lookups) {
+  // the even numbers 0, 2, .., 2n - 2, so odd queries miss
+  Vec vec = vec_new(n, NULL);
+  intptr_t* keys = (intptr_t*)malloc(n * sizeof(intptr_t));
+  if (keys == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  for (size_t i = 0; i < n; i++) {
+    keys[i] = (intptr_t)(2 * i);
+    vec_push_back(&vec, (ptr_t)keys[i]);
+  }
+  EytzView* eytz = eytz_from_vec(&vec, cmp_intptr, NULL);
+  BTreeView* btv = btv_new(keys, n);
+
+  printf("%zu elements (%zu KB)\n", n, n * sizeof(intptr_t) / 1024);
+  struct timespec start;
+  struct timespec end;
+  size_t found[4] = {0, 0, 0, 0};
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < lookups; i++) {
+    intptr_t key = queries[i] % (intptr_t)(2 * n);
+    size_t index = vec_lower_bound(&vec, (ptr_t)key, cmp_intptr, NULL);
+    found[0] += index < n && (intptr_t)vec.data[index] == key;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("vec_lower_bound", elapsed(start, end), lookups);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < lookups; i++) {
+    intptr_t key = queries[i] % (intptr_t)(2 * n);
+    size_t index = inline_lower_bound(keys, n, key);
+    found[1] += index < n && keys[index] == key;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("inline binary search", elapsed(start, end), lookups);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < lookups; i++) {
+    intptr_t key = queries[i] % (intptr_t)(2 * n);
+    ptr_t ele;
+    found[2] += eytz_find(eytz, (ptr_t)key, &ele);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("eytz_find", elapsed(start, end), lookups);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < lookups; i++) {
+    intptr_t key = queries[i] % (intptr_t)(2 * n);
+    found[3] += btv_find(btv, key) != VEC_NOT_FOUND;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("btv_find", elapsed(start, end), lookups);
+
+  btv_destroy(btv);
+  eytz_destroy(eytz);
+  free(keys);
+  vec_destroy(&vec);
+
+  for (size_t m = 1; m < 4; m++) {
+    if (found[m] != found[0]) {
+      return SIZE_MAX;
+    }
+  }
+  return found[0];
+}
+
+int main(int argc, char* argv[]) {
+  size_t lookups = DEFAULT_LOOKUPS;
+  size_t largest = DEFAULT_LARGEST;
+  if (argc > 1) {
+    lookups = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    largest = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  intptr_t* queries = (intptr_t*)malloc(lookups * sizeof(intptr_t));
+  if (queries == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+  uint64_t state = 1;
+  for (size_t i = 0; i < lookups; i++) {
+    queries[i] = (intptr_t)(next_random(&state) >> 1);
+  }
+
+  // 16 KB, 256 KB, 8 MB and then DRAM
+  size_t sizes[] = {(size_t)1 << 11, (size_t)1 << 15, (size_t)1 << 20,
+                    largest};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    if (run(sizes[s], queries, lookups) == SIZE_MAX) {
+      fprintf(stderr, "result mismatch\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  free(queries);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+#include "./Vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Create-push-destroy loop over short vectors, the pattern SmallVec is for.
+// Each round builds a vector of `len` elements, reads it back and destroys
+// it, once with Vec and once with SmallVec.
+//
+// usage: ./bench_small_vec [rounds] [len]   (default 10^7 rounds of 5)
+
+#define DEFAULT_ROUNDS 10000000UL
+#define DEFAULT_LEN 5UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static uintptr_t run_vec(size_t rounds, size_t len) {
+  uintptr_t check = 0;
+  for (size_t r = 0; r < rounds; r++) {
+    Vec vec = vec_new(0, NULL);
+    for (size_t i = 0; i < len; i++) {
+      vec_push_back(&vec, (ptr_t)(uintptr_t)(r + i));
+    }
+    for (size_t i = 0; i < len; i++) {
+      check += (uintptr_t)vec_get(&vec, i);
+    }
+    vec_destroy(&vec);
+  }
+  return check;
+}
+
+static uintptr_t run_svec(size_t rounds, size_t len) {
+  uintptr_t check = 0;
+  for (size_t r = 0; r < rounds; r++) {
+    SmallVec vec = svec_new(NULL);
+    for (size_t i = 0; i < len; i++) {
+      svec_push_back(&vec, (ptr_t)(uintptr_t)(r + i));
+    }
+    for (size_t i = 0; i < len; i++) {
+      check += (uintptr_t)svec_get(&vec, i);
+    }
+    svec_destroy(&vec);
+  }
+  return check;
+}
+
+int main(int argc, char* argv[]) {
+  size_t rounds = DEFAULT_ROUNDS;
+  size_t len = DEFAULT_LEN;
+  if (argc > 1) {
+    rounds = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    len = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  struct timespec start;
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  uintptr_t vec_check = run_vec(rounds, len);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double vec_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  uintptr_t svec_check = run_svec(rounds, len);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double svec_secs = elapsed(start, end);
+
+  printf("%zu rounds of %zu elements (inline capacity %d)\n", rounds, len,
+         VEC_SMALL_CAPACITY);
+  printf("Vec      %.3f s  %.1f ns/round\n", vec_secs,
+         vec_secs * NS_PER_SEC / (double)rounds);
+  printf("SmallVec %.3f s  %.1f ns/round\n", svec_secs,
+         svec_secs * NS_PER_SEC / (double)rounds);
+
+  if (vec_check != svec_check) {
+    fprintf(stderr, "checksum mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+#include "./soa.h"
+#include "./vector.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Sums one field of a 64 byte record, stored as a vector of records and as
+// a SoA container, and times pushing the rows and swap-removing half of
+// them in both.
+//
+// usage: ./bench_soa [rows] [rounds]
+//        (default 2000000 rows, 20 rounds)
+
+#define DEFAULT_ROWS 2000000UL
+#define DEFAULT_ROUNDS 20UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+typedef struct {
+  int64_t id;
+  double mass;
+  double pos_x;
+  double pos_y;
+  double pos_z;
+  double vel_x;
+  double vel_y;
+  double vel_z;
+} Record;
+
+#define RECORD_FIELDS(F)                                   \
+  F(int64_t, id) F(double, mass) F(double, pos_x)          \
+      F(double, pos_y) F(double, pos_z) F(double, vel_x)   \
+          F(double, vel_y) F(double, vel_z)
+
+SOA_DECLARE(record_soa, Record, RECORD_FIELDS)
+SOA_DEFINE(record_soa, Record, RECORD_FIELDS)
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+int main(int argc, char* argv[]) {
+  size_t rows = DEFAULT_ROWS;
+  size_t rounds = DEFAULT_ROUNDS;
+  if (argc > 1) {
+    rows = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    rounds = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  struct timespec start;
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  vector(Record) aos = vector_new(Record, 0, NULL);
+  for (size_t i = 0; i < rows; i++) {
+    Record r = {(int64_t)i, (double)(i % 100), 0, 0, 0, 1, 1, 1};
+    vector_push(&aos, r);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double aos_push = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  record_soa soa = record_soa_new(0);
+  for (size_t i = 0; i < rows; i++) {
+    Record r = {(int64_t)i, (double)(i % 100), 0, 0, 0, 1, 1, 1};
+    record_soa_push(&soa, r);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double soa_push = elapsed(start, end);
+
+  double aos_sum = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < vector_len(&aos); i++) {
+      aos_sum += aos[i].mass;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double aos_scan = elapsed(start, end);
+
+  double soa_sum = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    const double* mass = soa.mass;
+    for (size_t i = 0; i < soa.len; i++) {
+      soa_sum += mass[i];
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double soa_scan = elapsed(start, end);
+
+  // swap-remove every other row, from the front
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < rows / 2; i++) {
+    size_t last = vector_len(&aos) - 1;
+    aos[i] = aos[last];
+    vector_pop(&aos);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double aos_remove = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < rows / 2; i++) {
+    record_soa_swap_remove(&soa, i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double soa_remove = elapsed(start, end);
+
+  double scanned = (double)rows * (double)rounds;
+  printf("%zu rows of %zu bytes, mass summed %zu times\n", rows,
+         sizeof(Record), rounds);
+  printf("  %-14s %10s %10s %14s\n", "", "push", "scan", "swap remove");
+  printf("  %-14s %8.3f s %8.3f s %12.3f s  (%.2f ns/row scanned)\n",
+         "vector(Record)", aos_push, aos_scan, aos_remove,
+         aos_scan * NS_PER_SEC / scanned);
+  printf("  %-14s %8.3f s %8.3f s %12.3f s  (%.2f ns/row scanned)\n",
+         "record_soa", soa_push, soa_scan, soa_remove,
+         soa_scan * NS_PER_SEC / scanned);
+
+  int64_t aos_ids = 0;
+  int64_t soa_ids = 0;
+  for (size_t i = 0; i < vector_len(&aos); i++) {
+    aos_ids += aos[i].id;
+    soa_ids += soa.id[i];
+  }
+  int ok = aos_sum == soa_sum && vector_len(&aos) == soa.len &&
+           aos_ids == soa_ids;
+  vector_free(&aos);
+  record_soa_free(&soa);
+
+  if (!ok) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
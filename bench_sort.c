@@ -0,0 +1,111 @@
+#include "./Vec.h"
+#include "./vec_sort.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Sorts vectors of random integers stored as (ptr_t)(intptr_t)value, the
+// way main.c stores them, with qsort, vec_sort, vec_par_sort and
+// vec_sort_intptr, at sizes 10^6, 10^7, ... up to max_elements.
+// Every size needs about 3 * 8 bytes per element of memory, so 10^9 takes
+// about 24 GiB.
+//
+// usage: ./bench_sort [max_elements] [threads]
+//        (default 10^8 elements, one thread per online core)
+
+#define DEFAULT_MAX_ELEMENTS 100000000UL
+#define MIN_ELEMENTS 1000000UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static int cmp_intptr(ptr_t a, ptr_t b, void* ctx) {
+  (void)ctx;
+  intptr_t x = (intptr_t)a;
+  intptr_t y = (intptr_t)b;
+  return (x > y) - (x < y);
+}
+
+static int qsort_cmp_intptr(const void* a, const void* b) {
+  return cmp_intptr(*(ptr_t const*)a, *(ptr_t const*)b, NULL);
+}
+
+// xorshift64, so runs are reproducible
+static uint64_t next_random(uint64_t* state) {
+  *state ^= *state << 13U;
+  *state ^= *state >> 7U;
+  *state ^= *state << 17U;
+  return *state;
+}
+
+static void fill(Vec* vec, size_t n) {
+  uint64_t state = 0x9E3779B97F4A7C15ULL;
+  vec_truncate(vec, 0);
+  for (size_t i = 0; i < n; i++) {
+    vec_push_back(vec, (ptr_t)(intptr_t)next_random(&state));
+  }
+}
+
+static void check_sorted(Vec* vec) {
+  for (size_t i = 1; i < vec->length; i++) {
+    if ((intptr_t)vec->data[i - 1] > (intptr_t)vec->data[i]) {
+      fprintf(stderr, "not sorted at %zu\n", i);
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+static void report(const char* name, Vec* vec, struct timespec start) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double secs = elapsed(start, end);
+  check_sorted(vec);
+  printf("  %-16s %8.3f s  %6.1f ns/element\n", name, secs,
+         secs * NS_PER_SEC / (double)vec->length);
+}
+
+int main(int argc, char* argv[]) {
+  size_t max_elements = DEFAULT_MAX_ELEMENTS;
+  size_t threads = 0;
+  if (argc > 1) {
+    max_elements = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    threads = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  Vec vec = vec_new(0, NULL);
+  struct timespec start;
+  for (size_t n = MIN_ELEMENTS; n <= max_elements; n *= BASE_10) {
+    printf("%zu elements\n", n);
+
+    fill(&vec, n);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    qsort(vec.data, vec.length, sizeof(ptr_t), qsort_cmp_intptr);
+    report("qsort", &vec, start);
+
+    fill(&vec, n);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    vec_sort(&vec, cmp_intptr, NULL);
+    report("vec_sort", &vec, start);
+
+    fill(&vec, n);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    vec_par_sort(&vec, cmp_intptr, NULL, threads);
+    report("vec_par_sort", &vec, start);
+
+    fill(&vec, n);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    vec_sort_intptr(&vec);
+    report("vec_sort_intptr", &vec, start);
+  }
+  vec_destroy(&vec);
+  return EXIT_SUCCESS;
+}
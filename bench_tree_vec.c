@@ -0,0 +1,133 @@
+#include "./Vec.h"
+#include "./tree_vec.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Fills a Vec and a TreeVec with the same elements, then times inserts and
+// erases at random positions, random reads and a full in-order scan on
+// both.
+//
+// usage: ./bench_tree_vec [elements] [edits]
+//        (default 10^6 elements, 10^4 inserts followed by 10^4 erases)
+
+#define DEFAULT_ELEMENTS 1000000UL
+#define DEFAULT_EDITS 10000UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+// splitmix64, so the positions don't depend on the libc rand
+static uint64_t next_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static void report(const char* name, double secs, size_t ops) {
+  printf("  %-8s %8.3f s  %9.1f ns/op\n", name, secs,
+         secs * NS_PER_SEC / (double)ops);
+}
+
+int main(int argc, char* argv[]) {
+  size_t elements = DEFAULT_ELEMENTS;
+  size_t edits = DEFAULT_EDITS;
+  if (argc > 1) {
+    elements = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+  if (argc > 2) {
+    edits = (size_t)strtoull(argv[2], NULL, BASE_10);
+  }
+
+  Vec vec = vec_new(elements, NULL);
+  TreeVec* tree = tvec_new(NULL);
+  for (size_t i = 0; i < elements; i++) {
+    vec_push_back(&vec, (ptr_t)(uintptr_t)i);
+    tvec_push_back(tree, (ptr_t)(uintptr_t)i);
+  }
+
+  printf("%zu elements, %zu edits\n", elements, edits);
+  struct timespec start;
+  struct timespec end;
+  uintptr_t check[2] = {0, 0};
+
+  printf("Vec\n");
+  uint64_t state = 1;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < edits; i++) {
+    size_t index = next_random(&state) % (vec.length + 1);
+    vec_insert(&vec, index, (ptr_t)(uintptr_t)i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("insert", elapsed(start, end), edits);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < edits; i++) {
+    vec_erase(&vec, next_random(&state) % vec.length);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("erase", elapsed(start, end), edits);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < edits; i++) {
+    check[0] += (uintptr_t)vec_get(&vec, next_random(&state) % vec.length);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("get", elapsed(start, end), edits);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < vec.length; i++) {
+    check[0] += (uintptr_t)vec_get(&vec, i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("scan", elapsed(start, end), vec.length);
+
+  printf("TreeVec\n");
+  state = 1;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < edits; i++) {
+    size_t index = next_random(&state) % (tvec_len(tree) + 1);
+    tvec_insert(tree, index, (ptr_t)(uintptr_t)i);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("insert", elapsed(start, end), edits);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < edits; i++) {
+    tvec_erase(tree, next_random(&state) % tvec_len(tree));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("erase", elapsed(start, end), edits);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < edits; i++) {
+    check[1] +=
+        (uintptr_t)tvec_get(tree, next_random(&state) % tvec_len(tree));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("get", elapsed(start, end), edits);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  TreeVecIter iter = tvec_iter(tree, 0);
+  ptr_t ele = NULL;
+  while (tvec_iter_next(&iter, &ele)) {
+    check[1] += (uintptr_t)ele;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("scan", elapsed(start, end), tvec_len(tree));
+
+  tvec_destroy(tree);
+  vec_destroy(&vec);
+  if (check[0] != check[1]) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+#include "./vector.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Runs the same mix of vector_push / vector_insert / vector_erase /
+// vector_pop calls on a vector(int), once spelled with the vector.h macros
+// and once with the functions generated by VECTOR_DEFINE. Each version has
+// the same 20 call sites, so the code size of the two loops can be compared
+// with
+//
+//   nm -S --size-sort bench_vector_define | grep _edits
+//
+// usage: ./bench_vector_define [rounds]   (default 10^7 rounds)
+
+#define DEFAULT_ROUNDS 10000000UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define CALLS_PER_ROUND 20
+
+VECTOR_DECLARE(int, int_vec)
+VECTOR_DEFINE(int, int_vec)
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+// Five calls that leave the vector one element longer.
+#define MACRO_EDITS(v, x)                          \
+  vector_push(v, (x));                             \
+  vector_push(v, (x) + 1);                         \
+  vector_insert(v, vector_len(v) - 1, (x) + 2);    \
+  vector_erase(v, vector_len(v) - 2);              \
+  vector_pop(v)
+
+#define TYPED_EDITS(v, x)                          \
+  int_vec_push(v, (x));                            \
+  int_vec_push(v, (x) + 1);                        \
+  int_vec_insert(v, vector_len(v) - 1, (x) + 2);   \
+  int_vec_erase(v, vector_len(v) - 2);             \
+  int_vec_pop(v)
+
+__attribute__((noinline)) static void macro_edits(vector(int) * v,
+                                                  size_t rounds) {
+  for (size_t r = 0; r < rounds; r++) {
+    int x = (int)r;
+    MACRO_EDITS(v, x);
+    MACRO_EDITS(v, x + 3);
+    MACRO_EDITS(v, x + 6);
+    MACRO_EDITS(v, x + 9);
+  }
+}
+
+__attribute__((noinline)) static void typed_edits(vector(int) * v,
+                                                  size_t rounds) {
+  for (size_t r = 0; r < rounds; r++) {
+    int x = (int)r;
+    TYPED_EDITS(v, x);
+    TYPED_EDITS(v, x + 3);
+    TYPED_EDITS(v, x + 6);
+    TYPED_EDITS(v, x + 9);
+  }
+}
+
+static int64_t run(const char* name,
+                   void (*edits)(vector(int) *, size_t),
+                   size_t rounds) {
+  struct timespec start;
+  struct timespec end;
+  vector(int) v = vector_new(int, 0, NULL);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  edits(&v, rounds);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double secs = elapsed(start, end);
+  printf("  %-10s %8.3f s  %6.2f ns/call\n", name, secs,
+         secs * NS_PER_SEC / ((double)rounds * CALLS_PER_ROUND));
+
+  int64_t check = 0;
+  for (size_t i = 0; i < vector_len(&v); i++) {
+    check += v[i];
+  }
+  vector_free(&v);
+  return check;
+}
+
+int main(int argc, char* argv[]) {
+  size_t rounds = DEFAULT_ROUNDS;
+  if (argc > 1) {
+    rounds = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+
+  printf("%zu rounds of %d calls\n", rounds, CALLS_PER_ROUND);
+  int64_t expected = run("macros", macro_edits, rounds);
+  if (run("generated", typed_edits, rounds) != expected) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
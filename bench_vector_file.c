@@ -0,0 +1,132 @@
+#include "./vector.h"
+#include "./vector_file.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// Compares rebuilding a vector of 64 byte records by pushing every element
+// with saving it once and loading it back with vector_load, then reading a
+// few thousand random records and finally all of them. The file is written
+// to the current directory.
+//
+// usage: ./bench_vector_file [records]
+//        (default 2^21, 128 MB)
+
+#define DEFAULT_RECORDS ((size_t)1 << 21)
+#define RANDOM_READS 4096U
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define BYTES_PER_MB 1e6
+#define FILE_PATH "bench_vector_file.vec"
+
+typedef struct {
+  int64_t id;
+  double values[7];
+} Record;
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+// splitmix64, so that every run reads the same records
+static uint64_t next_random(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+static int64_t sample(vector(Record) * v) {
+  uint64_t state = 1;
+  int64_t sum = 0;
+  for (size_t i = 0; i < RANDOM_READS; i++) {
+    sum += (*v)[next_random(&state) % vector_len(v)].id;
+  }
+  return sum;
+}
+
+static int64_t scan(vector(Record) * v) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < vector_len(v); i++) {
+    sum += (*v)[i].id;
+  }
+  return sum;
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = DEFAULT_RECORDS;
+  if (argc > 1) {
+    n = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+
+  struct timespec start;
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  vector(Record) built = vector_new(Record, 0, NULL);
+  for (size_t i = 0; i < n; i++) {
+    Record r = {(int64_t)i, {0}};
+    vector_push(&built, r);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double build_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (!vector_save(&built, FILE_PATH)) {
+    perror("vector_save");
+    return EXIT_FAILURE;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double save_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  vector(Record) loaded = NULL;
+  if (!vector_load(&loaded, FILE_PATH)) {
+    perror("vector_load");
+    return EXIT_FAILURE;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double load_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int64_t sampled = sample(&loaded);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double sample_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int64_t scanned = scan(&loaded);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double scan_secs = elapsed(start, end);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  int verified = vector_file_verify(loaded);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double verify_secs = elapsed(start, end);
+
+  printf("%zu records, %.1f MB\n", n,
+         (double)(n * sizeof(Record)) / BYTES_PER_MB);
+  printf("  %-34s %9.3f ms\n", "rebuild with vector_push",
+         build_secs * 1e3);
+  printf("  %-34s %9.3f ms\n", "vector_save", save_secs * 1e3);
+  printf("  %-34s %9.3f ms\n", "vector_load", load_secs * 1e3);
+  printf("  %-34s %9.3f ms\n", "first 4096 random reads after load",
+         sample_secs * 1e3);
+  printf("  %-34s %9.3f ms\n", "scan every record after that",
+         scan_secs * 1e3);
+  printf("  %-34s %9.3f ms\n", "vector_file_verify", verify_secs * 1e3);
+
+  int ok = verified && sampled == sample(&built) && scanned == scan(&built);
+  vector_free(&built);
+  vector_free(&loaded);
+  unlink(FILE_PATH);
+
+  if (!ok) {
+    fprintf(stderr, "result mismatch\n");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+#include "./vector.h"
+#include "./vector_simd.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Sums, and takes the min and max of, a vector(double) with a plain loop
+// and with the vector_simd.h reductions, on a vector from vector_new and on
+// one from vector_new_aligned. The sizes fit in L1, L2 and neither.
+//
+// usage: ./bench_vector_simd [elements read per measurement]
+//        (default 10^9)
+
+#define DEFAULT_WORK 1000000000UL
+#define BASE_10 10
+#define NS_PER_SEC 1e9
+#define BYTES_PER_GB 1e9
+
+static double elapsed(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) +
+         (double)(end.tv_nsec - start.tv_nsec) / NS_PER_SEC;
+}
+
+static double loop_sum(vector(double) * v) {
+  double sum = 0;
+  for (size_t i = 0; i < vector_len(v); i++) {
+    sum += (*v)[i];
+  }
+  return sum;
+}
+
+static double loop_max(vector(double) * v) {
+  double max = -INFINITY;
+  for (size_t i = 0; i < vector_len(v); i++) {
+    max = (*v)[i] > max ? (*v)[i] : max;
+  }
+  return max;
+}
+
+static double run(const char* name,
+                  double (*reduce)(vector(double) *),
+                  vector(double) * v,
+                  size_t rounds) {
+  struct timespec start;
+  struct timespec end;
+  double check = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t r = 0; r < rounds; r++) {
+    check += reduce(v);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  double secs = elapsed(start, end);
+  double bytes = (double)rounds * (double)vector_len(v) * sizeof(double);
+  printf("  %-22s %7.3f s  %6.2f GB/s\n", name, secs,
+         bytes / secs / BYTES_PER_GB);
+  return check;
+}
+
+int main(int argc, char* argv[]) {
+  size_t work = DEFAULT_WORK;
+  if (argc > 1) {
+    work = (size_t)strtoull(argv[1], NULL, BASE_10);
+  }
+
+  // 16 KB, 256 KB and 64 MB
+  size_t sizes[] = {(size_t)1 << 11, (size_t)1 << 15, (size_t)1 << 23};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    size_t n = sizes[s];
+    size_t rounds = work / n > 0 ? work / n : 1;
+    vector(double) plain = vector_new(double, n, NULL);
+    vector(double) aligned = vector_new_aligned(double, n, NULL);
+    for (size_t i = 0; i < n; i++) {
+      vector_push(&plain, (double)(i % 1024));
+      vector_push(&aligned, (double)(i % 1024));
+    }
+
+    printf("%zu doubles, element 0 at offset %zu of a cache line (plain)\n",
+           n, (size_t)((uintptr_t)plain % VECTOR_ALIGNMENT));
+    double sums[3] = {
+        run("loop sum", loop_sum, &plain, rounds),
+        run("vector_sum_f64", vector_sum_f64, &plain, rounds),
+        run("vector_sum_f64 aligned", vector_sum_f64, &aligned, rounds),
+    };
+    double maxes[3] = {
+        run("loop max", loop_max, &plain, rounds),
+        run("vector_max_f64", vector_max_f64, &plain, rounds),
+        run("vector_max_f64 aligned", vector_max_f64, &aligned, rounds),
+    };
+    vector_free(&plain);
+    vector_free(&aligned);
+
+    // the values are small integers, every order of summation is exact
+    if (sums[1] != sums[0] || sums[2] != sums[0] || maxes[1] != maxes[0] ||
+        maxes[2] != maxes[0]) {
+      fprintf(stderr, "result mismatch\n");
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
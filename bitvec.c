@@ -0,0 +1,472 @@
+#include "./bitvec.h"
+#include <stdint.h>
+#include "./panic.h"
+
+#if defined(__x86_64__) && !defined(VEC_DISABLE_SIMD)
+#define BITVEC_X86
+#include <immintrin.h>
+#endif
+
+#define ALL_ONES (~(uint64_t)0)
+
+typedef enum bit_op_e {
+  BIT_OP_AND,
+  BIT_OP_OR,
+  BIT_OP_XOR,
+} bit_op;
+
+// Number of words needed for `bits` bits.
+static size_t words_for(size_t bits) {
+  return bits / BITVEC_WORD_BITS + (bits % BITVEC_WORD_BITS != 0);
+}
+
+// Bits of a word below bit position `end`, counted from the start of the
+// word `end` falls in. An end on a word boundary keeps the whole word.
+static uint64_t low_mask(size_t end) {
+  size_t rem = end % BITVEC_WORD_BITS;
+  return rem == 0 ? ALL_ONES : ((uint64_t)1 << rem) - 1;
+}
+
+static size_t words_used(vector(uint64_t) * words) {
+  vector_info* info = get_vector_header(words);
+  return info != NULL ? info->len : 0;
+}
+
+static void truncate_words(vector(uint64_t) * words) {
+  vector_info* info = get_vector_header(words);
+  if (info != NULL) {
+    info->len = 0;
+  }
+}
+
+// Appends zero words until `count` are in use.
+static void grow_words(vector(uint64_t) * words, size_t count) {
+  while (words_used(words) < count) {
+    vector_push(words, (uint64_t)0);
+  }
+}
+
+// --- word kernels ---
+
+static size_t popcount_scalar(const uint64_t* words, size_t n) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; i++) {
+    count += (size_t)__builtin_popcountll(words[i]);
+  }
+  return count;
+}
+
+static uint64_t apply_op(bit_op op, uint64_t a, uint64_t b) {
+  switch (op) {
+    case BIT_OP_AND:
+      return a & b;
+    case BIT_OP_OR:
+      return a | b;
+    default:
+      return a ^ b;
+  }
+}
+
+static void op_scalar(uint64_t* dst,
+                      const uint64_t* src,
+                      size_t n,
+                      bit_op op) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = apply_op(op, dst[i], src[i]);
+  }
+}
+
+#ifdef BITVEC_X86
+
+// Same loop as popcount_scalar, compiled to the popcnt instruction rather
+// than a bit twiddling fallback.
+__attribute__((target("popcnt"))) static size_t popcount_popcnt(
+    const uint64_t* words,
+    size_t n) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; i++) {
+    count += (size_t)__builtin_popcountll(words[i]);
+  }
+  return count;
+}
+
+// Counts the bits of each nibble with a 16 entry table lookup (vpshufb),
+// then sums the byte counts of every word with vpsadbw.
+__attribute__((target("avx2,popcnt"))) static size_t popcount_avx2(
+    const uint64_t* words,
+    size_t n) {
+  const __m256i table =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)&words[i]);
+    __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+    __m256i hi = _mm256_shuffle_epi8(
+        table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    acc = _mm256_add_epi64(
+        acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+  }
+
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i*)lanes, acc);
+  size_t count = (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+  for (; i < n; i++) {
+    count += (size_t)__builtin_popcountll(words[i]);
+  }
+  return count;
+}
+
+// The op is a constant in each wrapper below, so the switch folds away.
+__attribute__((target("avx2"), always_inline)) static inline void op_avx2(
+    uint64_t* dst,
+    const uint64_t* src,
+    size_t n,
+    bit_op op) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)&dst[i]);
+    __m256i b = _mm256_loadu_si256((const __m256i*)&src[i]);
+    switch (op) {
+      case BIT_OP_AND:
+        a = _mm256_and_si256(a, b);
+        break;
+      case BIT_OP_OR:
+        a = _mm256_or_si256(a, b);
+        break;
+      default:
+        a = _mm256_xor_si256(a, b);
+        break;
+    }
+    _mm256_storeu_si256((__m256i*)&dst[i], a);
+  }
+  for (; i < n; i++) {
+    dst[i] = apply_op(op, dst[i], src[i]);
+  }
+}
+
+__attribute__((target("avx2"))) static void and_avx2(uint64_t* dst,
+                                                     const uint64_t* src,
+                                                     size_t n) {
+  op_avx2(dst, src, n, BIT_OP_AND);
+}
+
+__attribute__((target("avx2"))) static void or_avx2(uint64_t* dst,
+                                                    const uint64_t* src,
+                                                    size_t n) {
+  op_avx2(dst, src, n, BIT_OP_OR);
+}
+
+__attribute__((target("avx2"))) static void xor_avx2(uint64_t* dst,
+                                                     const uint64_t* src,
+                                                     size_t n) {
+  op_avx2(dst, src, n, BIT_OP_XOR);
+}
+
+#endif  // BITVEC_X86
+
+static size_t popcount_words(const uint64_t* words, size_t n) {
+#ifdef BITVEC_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return popcount_avx2(words, n);
+  }
+  if (__builtin_cpu_supports("popcnt")) {
+    return popcount_popcnt(words, n);
+  }
+#endif
+  return popcount_scalar(words, n);
+}
+
+static void op_words(uint64_t* dst, const uint64_t* src, size_t n, bit_op op) {
+#ifdef BITVEC_X86
+  if (__builtin_cpu_supports("avx2")) {
+    switch (op) {
+      case BIT_OP_AND:
+        and_avx2(dst, src, n);
+        return;
+      case BIT_OP_OR:
+        or_avx2(dst, src, n);
+        return;
+      default:
+        xor_avx2(dst, src, n);
+        return;
+    }
+  }
+#endif
+  op_scalar(dst, src, n, op);
+}
+
+// --- bit ranges ---
+
+// Number of set bits in bit positions [begin, end) of words.
+static size_t count_bits(const uint64_t* words, size_t begin, size_t end) {
+  if (begin == end) {
+    return 0;
+  }
+  size_t first = begin / BITVEC_WORD_BITS;
+  size_t last = (end - 1) / BITVEC_WORD_BITS;
+  uint64_t head = words[first] & (ALL_ONES << (begin % BITVEC_WORD_BITS));
+  if (first == last) {
+    return (size_t)__builtin_popcountll(head & low_mask(end));
+  }
+  return (size_t)__builtin_popcountll(head) +
+         popcount_words(&words[first + 1], last - first - 1) +
+         (size_t)__builtin_popcountll(words[last] & low_mask(end));
+}
+
+// dst = dst op src on bit positions [begin, end), other bits unchanged.
+static void combine_bits(uint64_t* dst,
+                         const uint64_t* src,
+                         size_t begin,
+                         size_t end,
+                         bit_op op) {
+  if (begin == end) {
+    return;
+  }
+  size_t first = begin / BITVEC_WORD_BITS;
+  size_t last = (end - 1) / BITVEC_WORD_BITS;
+  uint64_t head_mask = ALL_ONES << (begin % BITVEC_WORD_BITS);
+  uint64_t tail_mask = low_mask(end);
+  if (first == last) {
+    head_mask &= tail_mask;
+  }
+
+  // the end words are only partly in the range, merge them under a mask
+  uint64_t head = apply_op(op, dst[first], src[first]);
+  uint64_t tail = apply_op(op, dst[last], src[last]);
+  if (last > first + 1) {
+    op_words(&dst[first + 1], &src[first + 1], last - first - 1, op);
+  }
+  dst[first] = (dst[first] & ~head_mask) | (head & head_mask);
+  if (last != first) {
+    dst[last] = (dst[last] & ~tail_mask) | (tail & tail_mask);
+  }
+}
+
+// Reads the `width` bit value that starts at bit position `bit`.
+static uint64_t load_bits(const uint64_t* words, size_t bit, unsigned width) {
+  size_t word = bit / BITVEC_WORD_BITS;
+  size_t offset = bit % BITVEC_WORD_BITS;
+  uint64_t value = words[word] >> offset;
+  if (offset + width > BITVEC_WORD_BITS) {
+    value |= words[word + 1] << (BITVEC_WORD_BITS - offset);
+  }
+  return value & (ALL_ONES >> (BITVEC_WORD_BITS - width));
+}
+
+// Writes the `width` bit value that starts at bit position `bit`.
+static void store_bits(uint64_t* words,
+                       size_t bit,
+                       unsigned width,
+                       uint64_t value) {
+  size_t word = bit / BITVEC_WORD_BITS;
+  size_t offset = bit % BITVEC_WORD_BITS;
+  uint64_t mask = ALL_ONES >> (BITVEC_WORD_BITS - width);
+  words[word] = (words[word] & ~(mask << offset)) | (value << offset);
+  if (offset + width > BITVEC_WORD_BITS) {
+    size_t spill = BITVEC_WORD_BITS - offset;
+    words[word + 1] =
+        (words[word + 1] & ~(mask >> spill)) | (value >> spill);
+  }
+}
+
+// --- BitVec ---
+
+BitVec bitvec_new(size_t initial_capacity) {
+  BitVec self;
+  self.words = vector_new_aligned(uint64_t, words_for(initial_capacity), NULL);
+  self.len = 0;
+  return self;
+}
+
+size_t bitvec_capacity(const BitVec* self) {
+  return vector_capacity(&self->words) * BITVEC_WORD_BITS;
+}
+
+void bitvec_push(BitVec* self, bool bit) {
+  if (self->len % BITVEC_WORD_BITS == 0) {
+    vector_push(&self->words, (uint64_t)0);
+  }
+  self->words[self->len / BITVEC_WORD_BITS] |= (uint64_t)bit
+                                               << (self->len % BITVEC_WORD_BITS);
+  self->len++;
+}
+
+bool bitvec_get(const BitVec* self, size_t index) {
+  if (index >= self->len) {
+    panic("Index out of bounds in bitvec_get\n");
+  }
+  return (self->words[index / BITVEC_WORD_BITS] >>
+          (index % BITVEC_WORD_BITS)) &
+         1U;
+}
+
+void bitvec_set(BitVec* self, size_t index, bool bit) {
+  if (index >= self->len) {
+    panic("Index out of bounds in bitvec_set\n");
+  }
+  uint64_t mask = (uint64_t)1 << (index % BITVEC_WORD_BITS);
+  uint64_t* word = &self->words[index / BITVEC_WORD_BITS];
+  *word = bit ? *word | mask : *word & ~mask;
+}
+
+void bitvec_resize(BitVec* self, size_t new_capacity) {
+  vector_resize(&self->words, words_for(new_capacity));
+}
+
+size_t bitvec_popcount(const BitVec* self, size_t begin, size_t end) {
+  if (begin > end || end > self->len) {
+    panic("Range out of bounds in bitvec_popcount\n");
+  }
+  return count_bits(self->words, begin, end);
+}
+
+size_t bitvec_rank(const BitVec* self, size_t index) {
+  if (index > self->len) {
+    panic("Index out of bounds in bitvec_rank\n");
+  }
+  return count_bits(self->words, 0, index);
+}
+
+static void bitvec_combine(BitVec* self,
+                           const BitVec* other,
+                           size_t begin,
+                           size_t end,
+                           bit_op op) {
+  if (begin > end || end > self->len || end > other->len) {
+    panic("Range out of bounds in bitvec_and/or/xor\n");
+  }
+  combine_bits(self->words, other->words, begin, end, op);
+}
+
+void bitvec_and(BitVec* self, const BitVec* other, size_t begin, size_t end) {
+  bitvec_combine(self, other, begin, end, BIT_OP_AND);
+}
+
+void bitvec_or(BitVec* self, const BitVec* other, size_t begin, size_t end) {
+  bitvec_combine(self, other, begin, end, BIT_OP_OR);
+}
+
+void bitvec_xor(BitVec* self, const BitVec* other, size_t begin, size_t end) {
+  bitvec_combine(self, other, begin, end, BIT_OP_XOR);
+}
+
+void bitvec_clear(BitVec* self) {
+  truncate_words(&self->words);
+  self->len = 0;
+}
+
+void bitvec_destroy(BitVec* self) {
+  vector_free(&self->words);
+  self->len = 0;
+}
+
+// --- PackedVec ---
+
+PackedVec packvec_new(unsigned width, size_t initial_capacity) {
+  if (width == 0 || width > PACKVEC_MAX_WIDTH) {
+    panic("Width out of range in packvec_new\n");
+  }
+  if (initial_capacity > SIZE_MAX / width) {
+    panic("Capacity overflow in packvec_new\n");
+  }
+  PackedVec self;
+  self.words =
+      vector_new_aligned(uint64_t, words_for(initial_capacity * width), NULL);
+  self.len = 0;
+  self.width = width;
+  return self;
+}
+
+size_t packvec_capacity(const PackedVec* self) {
+  return vector_capacity(&self->words) * BITVEC_WORD_BITS / self->width;
+}
+
+void packvec_push(PackedVec* self, uint32_t value) {
+  if (self->width < PACKVEC_MAX_WIDTH && value >> self->width != 0) {
+    panic("Value does not fit in packvec_push\n");
+  }
+  size_t bit = self->len * self->width;
+  grow_words(&self->words, words_for(bit + self->width));
+  store_bits(self->words, bit, self->width, value);
+  self->len++;
+}
+
+uint32_t packvec_get(const PackedVec* self, size_t index) {
+  if (index >= self->len) {
+    panic("Index out of bounds in packvec_get\n");
+  }
+  return (uint32_t)load_bits(self->words, index * self->width, self->width);
+}
+
+void packvec_set(PackedVec* self, size_t index, uint32_t value) {
+  if (index >= self->len) {
+    panic("Index out of bounds in packvec_set\n");
+  }
+  if (self->width < PACKVEC_MAX_WIDTH && value >> self->width != 0) {
+    panic("Value does not fit in packvec_set\n");
+  }
+  store_bits(self->words, index * self->width, self->width, value);
+}
+
+void packvec_resize(PackedVec* self, size_t new_capacity) {
+  if (new_capacity > SIZE_MAX / self->width) {
+    panic("Capacity overflow in packvec_resize\n");
+  }
+  vector_resize(&self->words, words_for(new_capacity * self->width));
+}
+
+size_t packvec_popcount(const PackedVec* self, size_t begin, size_t end) {
+  if (begin > end || end > self->len) {
+    panic("Range out of bounds in packvec_popcount\n");
+  }
+  return count_bits(self->words, begin * self->width, end * self->width);
+}
+
+// Number of `width` bit fields of `word` equal to zero, for widths that
+// divide 64. `high` has the top bit of every field set. The low bits of
+// each field plus all ones carry into its top bit iff they are not zero,
+// and never out of the field.
+static size_t zero_fields(uint64_t word, uint64_t high, unsigned width) {
+  uint64_t nonzero = (((word & ~high) + ~high) | word) & high;
+  return BITVEC_WORD_BITS / width - (size_t)__builtin_popcountll(nonzero);
+}
+
+size_t packvec_rank(const PackedVec* self, size_t index, uint32_t value) {
+  if (index > self->len) {
+    panic("Index out of bounds in packvec_rank\n");
+  }
+  unsigned width = self->width;
+  if (width < PACKVEC_MAX_WIDTH && value >> width != 0) {
+    return 0;
+  }
+  size_t i = 0;
+  size_t count = 0;
+  if (BITVEC_WORD_BITS % width == 0) {
+    // whole words at a time: fields equal to value become zero fields
+    uint64_t ones = ALL_ONES / (ALL_ONES >> (BITVEC_WORD_BITS - width));
+    uint64_t pattern = ones * value;
+    uint64_t high = ones << (width - 1);
+    size_t full_words = index * width / BITVEC_WORD_BITS;
+    for (size_t w = 0; w < full_words; w++) {
+      count += zero_fields(self->words[w] ^ pattern, high, width);
+    }
+    i = full_words * (BITVEC_WORD_BITS / width);
+  }
+  for (; i < index; i++) {
+    count += load_bits(self->words, i * width, width) == value;
+  }
+  return count;
+}
+
+void packvec_clear(PackedVec* self) {
+  truncate_words(&self->words);
+  self->len = 0;
+}
+
+void packvec_destroy(PackedVec* self) {
+  vector_free(&self->words);
+  self->len = 0;
+}
@@ -0,0 +1,166 @@
+#ifndef BITVEC_H_
+#define BITVEC_H_
+
+/*!
+ * Vectors of flags and of small integers that store each value in as few
+ * bits as it needs, instead of one byte (vector(bool)) or eight (a ptr_t in
+ * a Vec):
+ *
+ *   BitVec     one bit per value
+ *   PackedVec  `width` bits per value, 1 to 32, values may straddle words
+ *
+ * Both keep their bits in a vector(uint64_t) (see vector.h) created with
+ * vector_new_aligned, and grow it with vector_push and vector_resize, so
+ * they have the same growth and resize semantics as any other vector(T):
+ * the word array doubles when it is full and a resize only ever grows the
+ * capacity. Bits past the length are always zero.
+ *
+ * The counting and bitwise functions work on whole 64 bit words, and on
+ * x86-64 CPUs with AVX2 on four words per instruction. Builds with
+ * -DVEC_DISABLE_SIMD use the word loops only.
+ *
+ * All functions taking an index or a range panic if it is out of bounds,
+ * like vector_get.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdint.h>
+#include "./vector.h"
+
+/* Bits per storage word. */
+#define BITVEC_WORD_BITS ((size_t)64)
+
+/* Widest value a PackedVec can hold, in bits. */
+#define PACKVEC_MAX_WIDTH 32U
+
+typedef struct bit_vec_st {
+  vector(uint64_t) words;  // ceil(len / 64) words in use
+  size_t len;              // number of bits
+} BitVec;
+
+typedef struct packed_vec_st {
+  vector(uint64_t) words;  // ceil(len * width / 64) words in use
+  size_t len;              // number of values
+  unsigned width;          // bits per value
+} PackedVec;
+
+// --- BitVec ---
+
+/*!
+ * Creates a new empty BitVec.
+ *
+ * @param initial_capacity the number of bits that fit before the first
+ *                         resize, rounded up to a whole word
+ * @returns the new BitVec, destroy it with bitvec_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+BitVec bitvec_new(size_t initial_capacity);
+
+/* Returns the number of bits in the BitVec. */
+#define bitvec_len(self) ((self)->len)
+
+/* Returns the number of bits the BitVec can hold without growing. */
+size_t bitvec_capacity(const BitVec* self);
+
+/* Appends a bit, growing the word vector as vector_push does. */
+void bitvec_push(BitVec* self, bool bit);
+
+/* Returns the bit at the specified index, panics if index >= len. */
+bool bitvec_get(const BitVec* self, size_t index);
+
+/* Sets the bit at the specified index, panics if index >= len. */
+void bitvec_set(BitVec* self, size_t index, bool bit);
+
+/* Grows the capacity to at least new_capacity bits, same as vector_resize.
+ * Does nothing if new_capacity <= bitvec_capacity(self).
+ */
+void bitvec_resize(BitVec* self, size_t new_capacity);
+
+/* Returns the number of set bits in [begin, end).
+ *
+ * @pre panics if begin > end or end > bitvec_len(self).
+ */
+size_t bitvec_popcount(const BitVec* self, size_t begin, size_t end);
+
+/* Returns the number of set bits before index, i.e. in [0, index). Scans
+ * index / 64 words.
+ *
+ * @pre panics if index > bitvec_len(self).
+ */
+size_t bitvec_rank(const BitVec* self, size_t index);
+
+/* Combines the bits of other into self, self[i] = self[i] op other[i] for
+ * every i in [begin, end). Bits of self outside the range are unchanged.
+ * self and other may be the same BitVec.
+ *
+ * @pre panics if begin > end or end is past the length of either BitVec.
+ */
+void bitvec_and(BitVec* self, const BitVec* other, size_t begin, size_t end);
+void bitvec_or(BitVec* self, const BitVec* other, size_t begin, size_t end);
+void bitvec_xor(BitVec* self, const BitVec* other, size_t begin, size_t end);
+
+/* Removes every bit, keeping the capacity. */
+void bitvec_clear(BitVec* self);
+
+/* Frees the words and leaves an empty BitVec. */
+void bitvec_destroy(BitVec* self);
+
+// --- PackedVec ---
+
+/*!
+ * Creates a new empty PackedVec of `width` bit values.
+ *
+ * @param width            bits per value, from 1 to PACKVEC_MAX_WIDTH
+ * @param initial_capacity the number of values that fit before the first
+ *                         resize
+ * @returns the new PackedVec, destroy it with packvec_destroy.
+ * @post panics if width is out of range or memory allocation fails.
+ */
+PackedVec packvec_new(unsigned width, size_t initial_capacity);
+
+/* Returns the number of values in the PackedVec. */
+#define packvec_len(self) ((self)->len)
+
+/* Returns the number of values the PackedVec can hold without growing. */
+size_t packvec_capacity(const PackedVec* self);
+
+/* Appends a value, growing the word vector as vector_push does.
+ *
+ * @pre panics if value does not fit in the width of the PackedVec.
+ */
+void packvec_push(PackedVec* self, uint32_t value);
+
+/* Returns the value at the specified index, panics if index >= len. */
+uint32_t packvec_get(const PackedVec* self, size_t index);
+
+/* Sets the value at the specified index. Panics if index >= len or if the
+ * value does not fit in the width of the PackedVec.
+ */
+void packvec_set(PackedVec* self, size_t index, uint32_t value);
+
+/* Grows the capacity to at least new_capacity values, same as
+ * vector_resize. Does nothing if new_capacity <= packvec_capacity(self).
+ */
+void packvec_resize(PackedVec* self, size_t new_capacity);
+
+/* Returns the total number of set bits in the values in [begin, end).
+ *
+ * @pre panics if begin > end or end > packvec_len(self).
+ */
+size_t packvec_popcount(const PackedVec* self, size_t begin, size_t end);
+
+/* Returns the number of values equal to `value` before index, i.e. in
+ * [0, index).
+ *
+ * @pre panics if index > packvec_len(self).
+ */
+size_t packvec_rank(const PackedVec* self, size_t index, uint32_t value);
+
+/* Removes every value, keeping the capacity. */
+void packvec_clear(PackedVec* self);
+
+/* Frees the words and leaves an empty PackedVec. */
+void packvec_destroy(PackedVec* self);
+
+#endif  // BITVEC_H_
@@ -0,0 +1,215 @@
+#include "./concurrent_vec.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "./panic.h"
+
+// One bucket per bit of an index, more than any index can need.
+#define CVEC_MAX_BUCKETS 64
+#define SIZE_BITS 64
+
+typedef _Atomic(ptr_t) cvec_slot;
+
+struct concurrent_vec_st {
+  _Atomic size_t length;  // slots reserved so far
+  // bucket b holds first_bucket << b slots, NULL until first needed
+  _Atomic(cvec_slot*) buckets[CVEC_MAX_BUCKETS];
+  size_t first_bucket;  // a power of two
+  unsigned first_shift;  // log2(first_bucket)
+  ptr_dtor_fn ele_dtor_fn;
+};
+
+static unsigned cvec_log2(size_t n) {
+  return (unsigned)(SIZE_BITS - 1 - __builtin_clzll((unsigned long long)n));
+}
+
+// Splits an index into a bucket number and an offset within that bucket.
+// With first_bucket = F, bucket b covers indices [F(2^b - 1), F(2^(b+1) - 1)),
+// so the bucket is given by the highest set bit of index + F.
+static void cvec_locate(const ConcurrentVec* self,
+                        size_t index,
+                        size_t* bucket,
+                        size_t* offset) {
+  if (index > SIZE_MAX - self->first_bucket) {
+    panic("Index too large for cvec");
+  }
+  size_t pos = index + self->first_bucket;
+  unsigned high = cvec_log2(pos);
+  *bucket = high - self->first_shift;
+  *offset = pos - ((size_t)1 << high);
+}
+
+static size_t cvec_bucket_size(const ConcurrentVec* self, size_t bucket) {
+  return self->first_bucket << bucket;
+}
+
+// Returns the given bucket, allocating it if no other thread has yet.
+static cvec_slot* cvec_bucket(ConcurrentVec* self, size_t bucket) {
+  cvec_slot* slots =
+      atomic_load_explicit(&self->buckets[bucket], memory_order_acquire);
+  if (slots != NULL) {
+    return slots;
+  }
+
+  // calloc, so slots that are reserved but not stored yet read as NULL
+  cvec_slot* fresh =
+      (cvec_slot*)calloc(cvec_bucket_size(self, bucket), sizeof(cvec_slot));
+  if (fresh == NULL) {
+    panic("Memory allocation failed in cvec");
+    return NULL;
+  }
+  if (atomic_compare_exchange_strong_explicit(&self->buckets[bucket], &slots,
+                                              fresh, memory_order_acq_rel,
+                                              memory_order_acquire)) {
+    return fresh;
+  }
+  // another producer got there first, slots now holds its bucket
+  free(fresh);
+  return slots;
+}
+
+static void cvec_store(ConcurrentVec* self, size_t index, ptr_t ele) {
+  size_t bucket = 0;
+  size_t offset = 0;
+  cvec_locate(self, index, &bucket, &offset);
+  cvec_slot* slots = cvec_bucket(self, bucket);
+  atomic_store_explicit(&slots[offset], ele, memory_order_release);
+}
+
+ConcurrentVec* cvec_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn) {
+  ConcurrentVec* self = (ConcurrentVec*)malloc(sizeof(ConcurrentVec));
+  if (self == NULL) {
+    panic("Memory allocation failed in cvec_new");
+    return NULL;
+  }
+
+  size_t first = CVEC_MIN_FIRST_BUCKET;
+  while (first < initial_capacity) {
+    if (first > SIZE_MAX / 2 / sizeof(cvec_slot)) {
+      panic("Memory allocation failed in cvec_new");
+    }
+    first <<= 1U;
+  }
+
+  atomic_init(&self->length, 0);
+  for (size_t i = 0; i < CVEC_MAX_BUCKETS; i++) {
+    atomic_init(&self->buckets[i], NULL);
+  }
+  self->first_bucket = first;
+  self->first_shift = cvec_log2(first);
+  self->ele_dtor_fn = ele_dtor_fn;
+  cvec_bucket(self, 0);
+  return self;
+}
+
+size_t cvec_len(const ConcurrentVec* self) {
+  return atomic_load_explicit(&self->length, memory_order_acquire);
+}
+
+size_t cvec_push_back(ConcurrentVec* self, ptr_t new_ele) {
+  size_t index =
+      atomic_fetch_add_explicit(&self->length, 1, memory_order_relaxed);
+  cvec_store(self, index, new_ele);
+  return index;
+}
+
+size_t cvec_extend(ConcurrentVec* self, const ptr_t* elems, size_t n) {
+  // checked before reserving, so a failed extend never publishes indices
+  // past a wrapped length
+  size_t first = atomic_load_explicit(&self->length, memory_order_relaxed);
+  do {
+    if (first > SIZE_MAX - n) {
+      panic("Length overflow in cvec_extend");
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&self->length, &first,
+                                                  first + n,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+  for (size_t i = 0; i < n; i++) {
+    cvec_store(self, first + i, elems[i]);
+  }
+  return first;
+}
+
+void cvec_reserve(ConcurrentVec* self, size_t capacity) {
+  if (capacity == 0) {
+    return;
+  }
+
+  size_t last = 0;
+  size_t offset = 0;
+  cvec_locate(self, capacity - 1, &last, &offset);
+  for (size_t bucket = 0; bucket <= last; bucket++) {
+    cvec_bucket(self, bucket);
+  }
+}
+
+ptr_t cvec_get(const ConcurrentVec* self, size_t index) {
+  if (index >= cvec_len(self)) {
+    panic("Index out of bounds in cvec_get");
+  }
+
+  size_t bucket = 0;
+  size_t offset = 0;
+  cvec_locate(self, index, &bucket, &offset);
+  cvec_slot* slots =
+      atomic_load_explicit(&self->buckets[bucket], memory_order_acquire);
+  if (slots == NULL) {
+    // reserved, but the producer has not allocated the bucket yet
+    return NULL;
+  }
+  return atomic_load_explicit(&slots[offset], memory_order_acquire);
+}
+
+// Frees the buckets and the vector itself. The elements are moved to the end
+// of `into` in index order, or destructed if it is NULL. Only used once the
+// producers are done, so relaxed loads are enough.
+static void cvec_free_buckets(ConcurrentVec* self, Vec* into) {
+  size_t length = atomic_load_explicit(&self->length, memory_order_relaxed);
+  size_t base = into != NULL ? into->length : 0;
+  size_t last = 0;
+  size_t offset = 0;
+  if (length > 0) {
+    cvec_locate(self, length - 1, &last, &offset);
+  }
+
+  for (size_t bucket = 0; bucket < CVEC_MAX_BUCKETS; bucket++) {
+    cvec_slot* slots =
+        atomic_load_explicit(&self->buckets[bucket], memory_order_relaxed);
+    if (length > 0 && bucket <= last) {
+      if (slots == NULL) {
+        panic("Missing bucket in cvec");
+      }
+      // bucket b holds the indices from F(2^b - 1), see cvec_locate
+      size_t size = cvec_bucket_size(self, bucket);
+      size_t start = size - self->first_bucket;
+      size_t count = bucket == last ? offset + 1 : size;
+      for (size_t i = 0; i < count; i++) {
+        ptr_t ele = atomic_load_explicit(&slots[i], memory_order_relaxed);
+        if (into != NULL) {
+          into->data[base + start + i] = ele;
+        } else if (self->ele_dtor_fn != NULL) {
+          self->ele_dtor_fn(ele);
+        }
+      }
+    }
+    free(slots);
+  }
+  if (into != NULL) {
+    into->length = base + length;
+  }
+  free(self);
+}
+
+Vec cvec_into_vec(ConcurrentVec* self) {
+  Vec vec = vec_new(cvec_len(self), self->ele_dtor_fn);
+  cvec_free_buckets(self, &vec);
+  return vec;
+}
+
+void cvec_destroy(ConcurrentVec* self) {
+  if (self == NULL) {
+    return;
+  }
+  cvec_free_buckets(self, NULL);
+}
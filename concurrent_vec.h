@@ -0,0 +1,99 @@
+#ifndef CONCURRENT_VEC_H_
+#define CONCURRENT_VEC_H_
+
+/*!
+ * A vector that many threads can append to at once without a lock.
+ *
+ * A producer reserves a slot by atomically incrementing the length, then
+ * stores its element into that slot. Elements live in buckets whose sizes
+ * double (first_bucket, 2 * first_bucket, 4 * first_bucket, ...), so growing
+ * only ever adds a bucket and never moves an element: an index, or a pointer
+ * to an element, stays valid for the life of the vector. A missing bucket is
+ * allocated by whichever producer needs it first, racing producers settle it
+ * with a compare and swap.
+ *
+ * Every slot is read and written atomically, so a reader never sees a torn
+ * element. A slot that has been reserved but not yet stored reads as NULL.
+ * Once the producers are done (e.g. their threads have been joined), the
+ * vector holds exactly the pushed elements and cvec_into_vec turns it into a
+ * regular contiguous Vec.
+ *
+ *   ConcurrentVec* cv = cvec_new(0, NULL);
+ *   // on any number of threads:
+ *   cvec_push_back(cv, ele);
+ *   // after joining them:
+ *   Vec v = cvec_into_vec(cv);
+ *
+ * cvec_push_back, cvec_extend, cvec_reserve, cvec_get and cvec_len are safe
+ * to call concurrently. cvec_into_vec and cvec_destroy are not.
+ */
+
+#include <stddef.h>  // for size_t
+#include "./Vec.h"
+
+/* Smallest size of the first bucket. */
+#define CVEC_MIN_FIRST_BUCKET ((size_t)8)
+
+typedef struct concurrent_vec_st ConcurrentVec;
+
+/*!
+ * Creates a new empty concurrent vector.
+ *
+ * @param initial_capacity the number of elements that can be pushed before
+ *                         any further allocation. Rounded up to a power of
+ *                         two, at least CVEC_MIN_FIRST_BUCKET.
+ * @param ele_dtor_fn      the element destructor, same as in vec_new
+ * @returns a pointer to the new vector, destroy it with cvec_destroy or
+ * cvec_into_vec.
+ * @post if memory allocation fails, the function will panic.
+ */
+ConcurrentVec* cvec_new(size_t initial_capacity, ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the number of slots reserved so far. Slots reserved by pushes that
+ * have not returned yet may still read as NULL.
+ */
+size_t cvec_len(const ConcurrentVec* self);
+
+/* Appends an element and returns the index it was stored at.
+ * Never moves existing elements.
+ *
+ * @post if memory allocation fails, the function will panic.
+ */
+size_t cvec_push_back(ConcurrentVec* self, ptr_t new_ele);
+
+/* Appends n elements to consecutive slots with a single reservation and
+ * returns the index of the first one. Elements pushed by other threads never
+ * interleave with them.
+ *
+ * @post if memory allocation fails, the function will panic.
+ */
+size_t cvec_extend(ConcurrentVec* self, const ptr_t* elems, size_t n);
+
+/* Allocates every bucket needed to hold `capacity` elements, so that pushes
+ * up to that length never allocate.
+ *
+ * @post if memory allocation fails, the function will panic.
+ */
+void cvec_reserve(ConcurrentVec* self, size_t capacity);
+
+/* Gets the element at the specified index, NULL if its slot has been
+ * reserved but not stored yet.
+ *
+ * @post panics if index is >= cvec_len(self).
+ */
+ptr_t cvec_get(const ConcurrentVec* self, size_t index);
+
+/* Moves the elements into a new contiguous Vec with the same element
+ * destructor and frees the concurrent vector. No other thread may be using
+ * it.
+ *
+ * @post if memory allocation fails, the function will panic.
+ */
+Vec cvec_into_vec(ConcurrentVec* self);
+
+/* Destructs every element and frees the vector. No other thread may be using
+ * it. Does nothing if self is NULL.
+ */
+void cvec_destroy(ConcurrentVec* self);
+
+#endif  // CONCURRENT_VEC_H_
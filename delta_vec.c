@@ -0,0 +1,308 @@
+#include "./delta_vec.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./panic.h"
+
+#if defined(__x86_64__) && !defined(VEC_DISABLE_SIMD)
+#define DELTA_VEC_X86
+#include <immintrin.h>
+#endif
+
+#define WORD_BITS 64U
+
+// A block of w bit values takes DVEC_BLOCK_LEN * w bits, w * this many words.
+#define WORDS_PER_WIDTH (DVEC_BLOCK_LEN / WORD_BITS)
+
+_Static_assert(DVEC_BLOCK_LEN % WORD_BITS == 0,
+               "a block should pack into whole words");
+
+// The skip header of a compressed block. Value j of the block is
+// first + j * base + (packed[1] + ... + packed[j]), packed[0] is always 0.
+typedef struct dvec_block_st {
+  int64_t first;
+  int64_t base;    // smallest difference between neighbours in the block
+  size_t offset;   // index in the payload of the block's first word
+  unsigned width;  // bits per packed value, 0 to 64
+} DvecBlock;
+
+struct delta_vec_st {
+  DvecBlock* blocks;
+  size_t block_count;
+  size_t block_capacity;
+  // packed bits of every block, followed by at least one zero word so that
+  // reading the word after a value's first one never leaves the array
+  uint64_t* payload;
+  size_t payload_len;
+  size_t payload_capacity;
+  int64_t tail[DVEC_BLOCK_LEN];  // the values after the last block
+  size_t tail_len;
+};
+
+static void* dvec_realloc(void* ptr, size_t count, size_t size) {
+  if (count > SIZE_MAX / size) {
+    panic("Capacity overflow in DeltaVec");
+  }
+  void* new_ptr = realloc(ptr, count * size);
+  if (new_ptr == NULL) {
+    panic("Memory allocation failed in DeltaVec");
+  }
+  return new_ptr;
+}
+
+// Makes room for `words` more payload words plus the zero word after them.
+static void dvec_reserve_payload(DeltaVec* self, size_t words) {
+  size_t needed = self->payload_len + words + 1;
+  if (needed <= self->payload_capacity) {
+    return;
+  }
+  size_t capacity = self->payload_capacity * 2;
+  if (capacity < needed) {
+    capacity = needed;
+  }
+  self->payload = (uint64_t*)dvec_realloc(self->payload, capacity,
+                                          sizeof(uint64_t));
+  self->payload_capacity = capacity;
+}
+
+static uint64_t width_mask(unsigned width) {
+  return width == 0 ? 0 : ~(uint64_t)0 >> (WORD_BITS - width);
+}
+
+// Reads packed value j of a block.
+static uint64_t dvec_unpack(const uint64_t* words, unsigned width, size_t j) {
+  if (width == 0) {
+    return 0;
+  }
+  size_t bit = j * width;
+  size_t word = bit / WORD_BITS;
+  size_t offset = bit % WORD_BITS;
+  uint64_t value = words[word] >> offset;
+  if (offset + width > WORD_BITS) {
+    value |= words[word + 1] << (WORD_BITS - offset);
+  }
+  return value & width_mask(width);
+}
+
+// Encodes the full tail as a new block. Differences are taken modulo 2^64,
+// so the base and the packed values are too.
+static void dvec_seal(DeltaVec* self) {
+  uint64_t packed[DVEC_BLOCK_LEN];
+  uint64_t base = 0;
+  for (size_t j = 1; j < DVEC_BLOCK_LEN; j++) {
+    int64_t diff = (int64_t)((uint64_t)self->tail[j] -
+                             (uint64_t)self->tail[j - 1]);
+    if (j == 1 || diff < (int64_t)base) {
+      base = (uint64_t)diff;
+    }
+  }
+  uint64_t max = 0;
+  packed[0] = 0;
+  for (size_t j = 1; j < DVEC_BLOCK_LEN; j++) {
+    packed[j] = (uint64_t)self->tail[j] - (uint64_t)self->tail[j - 1] - base;
+    max |= packed[j];
+  }
+  unsigned width = max == 0 ? 0 : WORD_BITS - (unsigned)__builtin_clzll(max);
+
+  if (self->block_count == self->block_capacity) {
+    size_t capacity = self->block_capacity == 0 ? 1 : self->block_capacity * 2;
+    self->blocks =
+        (DvecBlock*)dvec_realloc(self->blocks, capacity, sizeof(DvecBlock));
+    self->block_capacity = capacity;
+  }
+
+  size_t words = width * WORDS_PER_WIDTH;
+  dvec_reserve_payload(self, words);
+  uint64_t* out = &self->payload[self->payload_len];
+  memset(out, 0, (words + 1) * sizeof(uint64_t));
+  for (size_t j = 0; j < DVEC_BLOCK_LEN && width > 0; j++) {
+    size_t bit = j * width;
+    size_t word = bit / WORD_BITS;
+    size_t offset = bit % WORD_BITS;
+    out[word] |= packed[j] << offset;
+    if (offset + width > WORD_BITS) {
+      out[word + 1] |= packed[j] >> (WORD_BITS - offset);
+    }
+  }
+
+  DvecBlock* block = &self->blocks[self->block_count++];
+  block->first = self->tail[0];
+  block->base = (int64_t)base;
+  block->offset = self->payload_len;
+  block->width = width;
+  self->payload_len += words;
+  self->tail_len = 0;
+}
+
+// --- block decoding ---
+
+static void dvec_decode_block_scalar(const DvecBlock* block,
+                                     const uint64_t* words,
+                                     int64_t* out) {
+  uint64_t base = (uint64_t)block->base;
+  uint64_t value = (uint64_t)block->first - base;
+  for (size_t j = 0; j < DVEC_BLOCK_LEN; j++) {
+    value += base + dvec_unpack(words, block->width, j);
+    out[j] = (int64_t)value;
+  }
+}
+
+#ifdef DELTA_VEC_X86
+
+// Four values per step: each lane gathers the two words its value can span
+// and shifts them into place (variable shifts by 64 or more give 0, which
+// handles values that fit in one word), then the lanes are prefix summed
+// in the register and the last lane carries over to the next step.
+__attribute__((target("avx2"))) static void dvec_decode_block_avx2(
+    const DvecBlock* block,
+    const uint64_t* words,
+    int64_t* out) {
+  const long long* lo_words = (const long long*)words;
+  const long long* hi_words = lo_words + 1;
+  __m256i base = _mm256_set1_epi64x(block->base);
+  __m256i carry = _mm256_set1_epi64x(
+      (long long)((uint64_t)block->first - (uint64_t)block->base));
+  __m256i mask = _mm256_set1_epi64x((long long)width_mask(block->width));
+  __m256i word_bits = _mm256_set1_epi64x(WORD_BITS);
+  __m256i low_bits = _mm256_set1_epi64x(WORD_BITS - 1);
+  __m256i zero = _mm256_setzero_si256();
+  long long width = block->width;
+  __m256i bit = _mm256_setr_epi64x(0, width, 2 * width, 3 * width);
+  __m256i step = _mm256_set1_epi64x(4 * width);
+
+  for (size_t j = 0; j < DVEC_BLOCK_LEN; j += 4) {
+    __m256i x = base;
+    if (width > 0) {
+      __m256i index = _mm256_srli_epi64(bit, 6);
+      __m256i offset = _mm256_and_si256(bit, low_bits);
+      __m256i lo = _mm256_i64gather_epi64(lo_words, index, 8);
+      __m256i hi = _mm256_i64gather_epi64(hi_words, index, 8);
+      __m256i packed = _mm256_or_si256(
+          _mm256_srlv_epi64(lo, offset),
+          _mm256_sllv_epi64(hi, _mm256_sub_epi64(word_bits, offset)));
+      x = _mm256_add_epi64(x, _mm256_and_si256(packed, mask));
+      bit = _mm256_add_epi64(bit, step);
+    }
+    // [a, b, c, d] -> [a, a+b, b+c, c+d] -> [a, a+b, a+b+c, a+b+c+d]
+    x = _mm256_add_epi64(
+        x, _mm256_blend_epi32(
+               _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero,
+               0x03));
+    x = _mm256_add_epi64(
+        x, _mm256_blend_epi32(
+               _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero,
+               0x0F));
+    x = _mm256_add_epi64(x, carry);
+    _mm256_storeu_si256((__m256i*)&out[j], x);
+    carry = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+}
+
+#endif  // DELTA_VEC_X86
+
+static void dvec_decode_block(const DeltaVec* self,
+                              size_t b,
+                              int64_t* out) {
+  const DvecBlock* block = &self->blocks[b];
+  const uint64_t* words = &self->payload[block->offset];
+#ifdef DELTA_VEC_X86
+  if (__builtin_cpu_supports("avx2")) {
+    dvec_decode_block_avx2(block, words, out);
+    return;
+  }
+#endif
+  dvec_decode_block_scalar(block, words, out);
+}
+
+// --- public functions ---
+
+DeltaVec* dvec_new(void) {
+  DeltaVec* self = (DeltaVec*)malloc(sizeof(DeltaVec));
+  if (self == NULL) {
+    panic("Memory allocation failed in dvec_new");
+    return NULL;
+  }
+  self->blocks = NULL;
+  self->block_count = 0;
+  self->block_capacity = 0;
+  self->payload = NULL;
+  self->payload_len = 0;
+  self->payload_capacity = 0;
+  self->tail_len = 0;
+  return self;
+}
+
+size_t dvec_len(const DeltaVec* self) {
+  return self->block_count * DVEC_BLOCK_LEN + self->tail_len;
+}
+
+void dvec_push_back(DeltaVec* self, int64_t value) {
+  self->tail[self->tail_len++] = value;
+  if (self->tail_len == DVEC_BLOCK_LEN) {
+    dvec_seal(self);
+  }
+}
+
+int64_t dvec_get(const DeltaVec* self, size_t index) {
+  if (index >= dvec_len(self)) {
+    panic("Index out of bounds in dvec_get");
+  }
+  size_t b = index / DVEC_BLOCK_LEN;
+  size_t j = index % DVEC_BLOCK_LEN;
+  if (b == self->block_count) {
+    return self->tail[j];
+  }
+
+  const DvecBlock* block = &self->blocks[b];
+  const uint64_t* words = &self->payload[block->offset];
+  uint64_t value = (uint64_t)block->first + (uint64_t)j * (uint64_t)block->base;
+  for (size_t k = 1; k <= j; k++) {
+    value += dvec_unpack(words, block->width, k);
+  }
+  return (int64_t)value;
+}
+
+void dvec_decode(const DeltaVec* self, size_t begin, size_t n, int64_t* out) {
+  size_t len = dvec_len(self);
+  if (begin > len || n > len - begin) {
+    panic("Range out of bounds in dvec_decode");
+  }
+
+  int64_t scratch[DVEC_BLOCK_LEN];
+  size_t index = begin;
+  size_t end = begin + n;
+  while (index < end) {
+    size_t b = index / DVEC_BLOCK_LEN;
+    size_t j = index % DVEC_BLOCK_LEN;
+    size_t count = DVEC_BLOCK_LEN - j;
+    if (count > end - index) {
+      count = end - index;
+    }
+
+    if (b == self->block_count) {
+      memcpy(out, &self->tail[j], count * sizeof(int64_t));
+    } else if (count == DVEC_BLOCK_LEN) {
+      dvec_decode_block(self, b, out);
+    } else {
+      dvec_decode_block(self, b, scratch);
+      memcpy(out, &scratch[j], count * sizeof(int64_t));
+    }
+    out += count;
+    index += count;
+  }
+}
+
+size_t dvec_encoded_bytes(const DeltaVec* self) {
+  return self->block_count * sizeof(DvecBlock) +
+         self->payload_len * sizeof(uint64_t) +
+         self->tail_len * sizeof(int64_t);
+}
+
+void dvec_destroy(DeltaVec* self) {
+  if (self == NULL) {
+    return;
+  }
+  free(self->blocks);
+  free(self->payload);
+  free(self);
+}
@@ -0,0 +1,73 @@
+#ifndef DELTA_VEC_H_
+#define DELTA_VEC_H_
+
+/*!
+ * An append-only sequence of 64 bit integers, stored compressed. Meant for
+ * long, mostly sorted sequences such as timestamps, which take 8 bytes per
+ * value in a Vec of (ptr_t)(intptr_t)value but whose differences fit in one
+ * or two bytes.
+ *
+ * Values are grouped in blocks of DVEC_BLOCK_LEN. A full block is encoded
+ * with delta and frame of reference coding: the differences between
+ * neighbouring values have the smallest difference (the block's base)
+ * subtracted and are bit-packed with the width of the largest remainder,
+ * 0 to 64 bits. Each block has a small header, holding its first value,
+ * base, width and the position of its packed bits, so reaching any block
+ * takes O(1) and reading a value in it O(DVEC_BLOCK_LEN). The last, not yet
+ * full, block is kept uncompressed.
+ *
+ * dvec_decode unpacks and sums whole blocks, on x86-64 CPUs with AVX2 four
+ * values per instruction (builds with -DVEC_DISABLE_SIMD use a plain loop).
+ * Arithmetic wraps, so any int64_t values round-trip exactly, they just
+ * compress worse the further apart neighbours are.
+ */
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>
+
+/* Values per compressed block. */
+#define DVEC_BLOCK_LEN 128
+
+typedef struct delta_vec_st DeltaVec;
+
+/*!
+ * Creates a new empty DeltaVec.
+ *
+ * @returns a pointer to the new sequence, destroy it with dvec_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+DeltaVec* dvec_new(void);
+
+/* Returns the number of values in the DeltaVec. */
+size_t dvec_len(const DeltaVec* self);
+
+/* Appends a value. Every DVEC_BLOCK_LEN-th push encodes a block.
+ *
+ * @post If memory allocation fails, then this function will panic().
+ */
+void dvec_push_back(DeltaVec* self, int64_t value);
+
+/* Returns the value at the specified index. Decodes up to DVEC_BLOCK_LEN
+ * values of its block, use dvec_decode to read many values.
+ *
+ * @pre If the index is >= dvec_len(self) then this function will panic().
+ */
+int64_t dvec_get(const DeltaVec* self, size_t index);
+
+/* Copies the values [begin, begin + n) into out.
+ *
+ * @pre If begin + n > dvec_len(self) then this function will panic().
+ */
+void dvec_decode(const DeltaVec* self, size_t begin, size_t n, int64_t* out);
+
+/* Returns the number of bytes the values take: the block headers, packed
+ * bits and the uncompressed last block. Comparing it with
+ * dvec_len(self) * sizeof(int64_t) gives the compression ratio.
+ */
+size_t dvec_encoded_bytes(const DeltaVec* self);
+
+/* Frees the sequence. Does nothing if self is NULL.
+ */
+void dvec_destroy(DeltaVec* self);
+
+#endif  // DELTA_VEC_H_
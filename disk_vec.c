@@ -0,0 +1,320 @@
+#include "./disk_vec.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "./panic.h"
+
+#define NO_FRAME SIZE_MAX
+#define NO_PAGE SIZE_MAX
+
+// How much of the file is prefetched ahead of sequential faults.
+#define READAHEAD_PAGES 16
+
+#define SCRATCH_NAME "/diskvec-XXXXXX"
+#define DEFAULT_DIR "/tmp"
+
+typedef struct diskvec_page_st {
+  size_t frame;  // frame holding the page, NO_FRAME if it isn't in memory
+  bool on_disk;  // the file has a copy of the page
+} DiskvecPage;
+
+typedef struct diskvec_frame_st {
+  ptr_t* data;  // DISKVEC_PAGE_ELEMS elements
+  size_t page;  // page in the frame, NO_PAGE if the frame is free
+  bool dirty;   // modified since it was read from the file
+  bool referenced;  // accessed since the clock hand last passed
+} DiskvecFrame;
+
+struct disk_vec_st {
+  int fd;
+  size_t length;
+  ptr_dtor_fn ele_dtor_fn;
+  DiskvecPage* pages;  // one entry per page of elements
+  size_t page_count;
+  size_t page_capacity;
+  DiskvecFrame* frames;  // max_frames entries, frame_count of them allocated
+  size_t frame_count;
+  size_t max_frames;
+  size_t hand;  // next frame the clock looks at
+  size_t last_fault;  // page read from the file last, for readahead
+};
+
+static off_t page_offset(size_t page) {
+  return (off_t)(page * DISKVEC_PAGE_BYTES);
+}
+
+static void write_page(DiskVec* self, size_t page, const ptr_t* data) {
+  const char* bytes = (const char*)data;
+  size_t done = 0;
+  while (done < DISKVEC_PAGE_BYTES) {
+    ssize_t n = pwrite(self->fd, bytes + done, DISKVEC_PAGE_BYTES - done,
+                       page_offset(page) + (off_t)done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      panic("I/O error writing the scratch file of a DiskVec");
+    }
+    done += (size_t)n;
+  }
+}
+
+static void read_page(DiskVec* self, size_t page, ptr_t* data) {
+  char* bytes = (char*)data;
+  size_t done = 0;
+  while (done < DISKVEC_PAGE_BYTES) {
+    ssize_t n = pread(self->fd, bytes + done, DISKVEC_PAGE_BYTES - done,
+                      page_offset(page) + (off_t)done);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      panic("I/O error reading the scratch file of a DiskVec");
+    }
+    done += (size_t)n;
+  }
+}
+
+// Writes the page in `frame` out if it was modified and frees the frame.
+static void evict(DiskVec* self, size_t frame) {
+  DiskvecFrame* f = &self->frames[frame];
+  if (f->dirty) {
+    write_page(self, f->page, f->data);
+    self->pages[f->page].on_disk = true;
+  }
+  self->pages[f->page].frame = NO_FRAME;
+  f->page = NO_PAGE;
+  f->dirty = false;
+}
+
+// Returns a free frame: a new one while the budget allows it, otherwise
+// the first one the clock hand finds free or not recently referenced.
+static size_t take_frame(DiskVec* self) {
+  if (self->frame_count < self->max_frames) {
+    DiskvecFrame* f = &self->frames[self->frame_count];
+    f->data = (ptr_t*)malloc(DISKVEC_PAGE_BYTES);
+    if (f->data == NULL) {
+      panic("Memory allocation failed in DiskVec");
+    }
+    f->page = NO_PAGE;
+    f->dirty = false;
+    f->referenced = false;
+    return self->frame_count++;
+  }
+
+  while (true) {
+    size_t frame = self->hand;
+    DiskvecFrame* f = &self->frames[frame];
+    self->hand = (self->hand + 1) % self->frame_count;
+    if (f->page == NO_PAGE) {
+      return frame;
+    }
+    if (f->referenced) {
+      f->referenced = false;
+      continue;
+    }
+    evict(self, frame);
+    return frame;
+  }
+}
+
+// Brings a page that is not in memory into a frame.
+static void fault_in(DiskVec* self, size_t page) {
+  size_t frame = take_frame(self);
+  DiskvecFrame* f = &self->frames[frame];
+  if (self->pages[page].on_disk) {
+    if (page == self->last_fault + 1) {
+      posix_fadvise(self->fd, page_offset(page + 1),
+                    (off_t)(READAHEAD_PAGES * DISKVEC_PAGE_BYTES),
+                    POSIX_FADV_WILLNEED);
+    }
+    read_page(self, page, f->data);
+    self->last_fault = page;
+    f->dirty = false;
+  } else {
+    // a new page, it has to be written out when it is evicted
+    memset(f->data, 0, DISKVEC_PAGE_BYTES);
+    f->dirty = true;
+  }
+  f->page = page;
+  self->pages[page].frame = frame;
+}
+
+// Returns the elements of a page, faulting it in if needed. `write` marks
+// the page as modified.
+static ptr_t* page_data(DiskVec* self, size_t page, bool write) {
+  if (self->pages[page].frame == NO_FRAME) {
+    fault_in(self, page);
+  }
+  DiskvecFrame* f = &self->frames[self->pages[page].frame];
+  f->referenced = true;
+  f->dirty = f->dirty || write;
+  return f->data;
+}
+
+// Drops the last page, which holds no elements any more.
+static void drop_last_page(DiskVec* self) {
+  self->page_count--;
+  size_t frame = self->pages[self->page_count].frame;
+  if (frame != NO_FRAME) {
+    self->frames[frame].page = NO_PAGE;
+    self->frames[frame].dirty = false;
+  }
+}
+
+DiskVec* diskvec_new(const char* dir,
+                     size_t memory_budget,
+                     ptr_dtor_fn ele_dtor_fn) {
+  DiskVec* self = (DiskVec*)malloc(sizeof(DiskVec));
+  const char* base = dir != NULL ? dir : DEFAULT_DIR;
+  size_t path_size = strlen(base) + sizeof(SCRATCH_NAME);
+  char* path = (char*)malloc(path_size);
+  size_t max_frames = memory_budget / DISKVEC_PAGE_BYTES;
+  if (max_frames < DISKVEC_MIN_FRAMES) {
+    max_frames = DISKVEC_MIN_FRAMES;
+  }
+  DiskvecFrame* frames =
+      (DiskvecFrame*)malloc(max_frames * sizeof(DiskvecFrame));
+  if (self == NULL || path == NULL || frames == NULL) {
+    free(self);
+    free(path);
+    free(frames);
+    panic("Memory allocation failed in diskvec_new");
+    return NULL;
+  }
+
+  snprintf(path, path_size, "%s%s", base, SCRATCH_NAME);
+  int fd = mkstemp(path);
+  if (fd < 0) {
+    free(self);
+    free(path);
+    free(frames);
+    panic("Could not create the scratch file in diskvec_new");
+    return NULL;
+  }
+  // the file stays usable through fd and goes away with it
+  unlink(path);
+  free(path);
+
+  self->fd = fd;
+  self->length = 0;
+  self->ele_dtor_fn = ele_dtor_fn;
+  self->pages = NULL;
+  self->page_count = 0;
+  self->page_capacity = 0;
+  self->frames = frames;
+  self->frame_count = 0;
+  self->max_frames = max_frames;
+  self->hand = 0;
+  self->last_fault = NO_PAGE;
+  return self;
+}
+
+size_t diskvec_len(const DiskVec* self) {
+  return self->length;
+}
+
+size_t diskvec_resident_bytes(const DiskVec* self) {
+  return self->frame_count * DISKVEC_PAGE_BYTES;
+}
+
+ptr_t diskvec_get(DiskVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in diskvec_get");
+  }
+  return page_data(self, index / DISKVEC_PAGE_ELEMS,
+                   false)[index % DISKVEC_PAGE_ELEMS];
+}
+
+ptr_t* diskvec_at(DiskVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in diskvec_at");
+  }
+  return &page_data(self, index / DISKVEC_PAGE_ELEMS,
+                    true)[index % DISKVEC_PAGE_ELEMS];
+}
+
+void diskvec_set(DiskVec* self, size_t index, ptr_t new_ele) {
+  if (index >= self->length) {
+    panic("Index out of bounds in diskvec_set");
+  }
+  ptr_t* slot = &page_data(self, index / DISKVEC_PAGE_ELEMS,
+                           true)[index % DISKVEC_PAGE_ELEMS];
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(*slot);
+  }
+  *slot = new_ele;
+}
+
+void diskvec_push_back(DiskVec* self, ptr_t new_ele) {
+  if (self->length % DISKVEC_PAGE_ELEMS == 0) {
+    if (self->page_count == self->page_capacity) {
+      size_t capacity =
+          self->page_capacity == 0 ? 1 : self->page_capacity * 2;
+      DiskvecPage* pages =
+          (DiskvecPage*)realloc(self->pages, capacity * sizeof(DiskvecPage));
+      if (pages == NULL) {
+        panic("Memory allocation failed in diskvec_push_back");
+      }
+      self->pages = pages;
+      self->page_capacity = capacity;
+    }
+    self->pages[self->page_count].frame = NO_FRAME;
+    self->pages[self->page_count].on_disk = false;
+    self->page_count++;
+  }
+
+  size_t page = self->length / DISKVEC_PAGE_ELEMS;
+  page_data(self, page, true)[self->length % DISKVEC_PAGE_ELEMS] = new_ele;
+  self->length++;
+}
+
+bool diskvec_pop_back(DiskVec* self) {
+  if (self->length == 0) {
+    return false;
+  }
+  size_t index = self->length - 1;
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(page_data(self, index / DISKVEC_PAGE_ELEMS,
+                                false)[index % DISKVEC_PAGE_ELEMS]);
+  }
+  self->length--;
+  if (self->length % DISKVEC_PAGE_ELEMS == 0) {
+    drop_last_page(self);
+  }
+  return true;
+}
+
+void diskvec_clear(DiskVec* self) {
+  if (self->ele_dtor_fn != NULL) {
+    for (size_t i = 0; i < self->length; i++) {
+      self->ele_dtor_fn(diskvec_get(self, i));
+    }
+  }
+  while (self->page_count > 0) {
+    drop_last_page(self);
+  }
+  self->length = 0;
+  self->last_fault = NO_PAGE;
+  if (ftruncate(self->fd, 0) != 0) {
+    panic("I/O error truncating the scratch file of a DiskVec");
+  }
+}
+
+void diskvec_destroy(DiskVec* self) {
+  if (self == NULL) {
+    return;
+  }
+  diskvec_clear(self);
+  for (size_t i = 0; i < self->frame_count; i++) {
+    free(self->frames[i].data);
+  }
+  free(self->frames);
+  free(self->pages);
+  close(self->fd);
+  free(self);
+}
@@ -0,0 +1,107 @@
+#ifndef DISK_VEC_H_
+#define DISK_VEC_H_
+
+/*!
+ * A vector that can grow past the memory it is allowed to use. Elements
+ * live in fixed size pages of DISKVEC_PAGE_BYTES; at most
+ * memory_budget / DISKVEC_PAGE_BYTES of them are held in memory and the
+ * rest are written out to a scratch file and read back when touched:
+ *
+ *   - a page that is needed and not in memory replaces a cold one, picked
+ *     with the CLOCK algorithm (an approximation of least recently used:
+ *     every page in memory has a referenced bit, set on access and
+ *     cleared as the clock hand sweeps past it, and the first page found
+ *     with the bit clear is evicted)
+ *   - an evicted page is written to the file only if it was modified
+ *   - when pages are faulted in one after the other, the file region after
+ *     them is prefetched (posix_fadvise), so a full scan reads the file
+ *     sequentially ahead of the accesses
+ *
+ * The scratch file is created in a directory given to diskvec_new and
+ * unlinked right away, it disappears when the DiskVec is destroyed or the
+ * process exits.
+ *
+ * The functions mirror their vec_ counterparts, including when they panic.
+ * They also panic if the scratch file can't be created, read or written.
+ * Pointers returned by diskvec_at are only valid until the next call on the
+ * same DiskVec. A DiskVec is not thread safe.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include "./Vec.h"
+
+/* Size of a page, the unit of eviction and file I/O. */
+#define DISKVEC_PAGE_BYTES ((size_t)64 * 1024)
+
+/* Elements per page. */
+#define DISKVEC_PAGE_ELEMS (DISKVEC_PAGE_BYTES / sizeof(ptr_t))
+
+/* Pages kept in memory however small the budget is. */
+#define DISKVEC_MIN_FRAMES ((size_t)4)
+
+typedef struct disk_vec_st DiskVec;
+
+/*!
+ * Creates a new empty DiskVec.
+ *
+ * @param dir           directory for the scratch file, NULL for /tmp
+ * @param memory_budget the most memory page contents may take, in bytes,
+ *                      rounded down to whole pages and up to
+ *                      DISKVEC_MIN_FRAMES pages
+ * @param ele_dtor_fn   the element destructor, same as in vec_new
+ * @returns a pointer to the new vector, destroy it with diskvec_destroy.
+ * @post panics if memory allocation or creating the scratch file fails.
+ */
+DiskVec* diskvec_new(const char* dir,
+                     size_t memory_budget,
+                     ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the number of elements in the DiskVec. */
+size_t diskvec_len(const DiskVec* self);
+
+/* Returns the number of bytes of page contents currently held in memory,
+ * never more than the budget.
+ */
+size_t diskvec_resident_bytes(const DiskVec* self);
+
+/* Gets the element at the specified index, reading its page back from the
+ * scratch file if it was evicted.
+ * Same as vec_get, panics if index >= diskvec_len(self)
+ */
+ptr_t diskvec_get(DiskVec* self, size_t index);
+
+/* Returns a pointer to the element at the specified index, valid until the
+ * next call on self. Writes through it are kept, as the page is marked
+ * modified. Panics if index >= diskvec_len(self)
+ */
+ptr_t* diskvec_at(DiskVec* self, size_t index);
+
+/* Sets the element at the specified index
+ * Same as vec_set: the replaced element is destructed and this panics if
+ * index >= diskvec_len(self)
+ */
+void diskvec_set(DiskVec* self, size_t index, ptr_t new_ele);
+
+/* Appends the given element to the end of the DiskVec, evicting a page if
+ * a new one is needed and the budget is used up.
+ */
+void diskvec_push_back(DiskVec* self, ptr_t new_ele);
+
+/* Removes and destroys the last element of the DiskVec
+ *
+ * @returns true iff an element was removed.
+ */
+bool diskvec_pop_back(DiskVec* self);
+
+/* Erases all elements from the DiskVec, destructing them (which reads any
+ * evicted pages back if there is an element destructor).
+ */
+void diskvec_clear(DiskVec* self);
+
+/* Destructs every element, frees the pages and closes the scratch file.
+ * Does nothing if self is NULL.
+ */
+void diskvec_destroy(DiskVec* self);
+
+#endif  // DISK_VEC_H_
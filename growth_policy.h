@@ -0,0 +1,105 @@
+#ifndef GROWTH_POLICY_H_
+#define GROWTH_POLICY_H_
+
+/*!
+ * Growth policies shared by Vec (Vec.h) and the typed vector(T) macros
+ * (vector.h). A policy decides how much capacity to ask for when a push or
+ * insert finds the container full:
+ *
+ *   GROWTH_MODE_DOUBLE  capacity 0 -> 1 -> 2 -> 4 -> ...   (the default)
+ *   GROWTH_MODE_HALF    capacity grows by 1.5x, wasting at most 1/3
+ *   GROWTH_MODE_STEP    capacity grows by a fixed number of elements
+ *
+ * Independently of the mode, a policy can ask for
+ *   - a minimum first allocation in bytes (e.g. one cache line), so that
+ *     short containers don't do several tiny reallocations while starting
+ *   - allocator slack to be kept as capacity: after every reallocation the
+ *     container asks malloc_usable_size() how big the block really is and
+ *     uses all of it.
+ *
+ * A zero-initialized growth_policy is the plain doubling policy with exact
+ * capacities, which is what vec_new and vector_new use.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define GROWTH_CACHE_LINE_SIZE ((size_t)64)
+
+typedef enum growth_mode_en {
+  GROWTH_MODE_DOUBLE = 0,
+  GROWTH_MODE_HALF,
+  GROWTH_MODE_STEP,
+} growth_mode;
+
+typedef struct growth_policy_st {
+  growth_mode mode;
+  bool use_usable_size;  // turn allocator slack into capacity
+  size_t min_bytes;      // smallest allocation made when growing
+  size_t step;           // elements added per growth in GROWTH_MODE_STEP
+} growth_policy;
+
+// Doubling with exact capacities. Same behaviour as vec_new/vector_new.
+#define GROWTH_DOUBLE ((growth_policy){GROWTH_MODE_DOUBLE, false, 0, 0})
+
+// 1.5x growth, first allocation of at least a cache line, keeps slack.
+#define GROWTH_1_5X \
+  ((growth_policy){GROWTH_MODE_HALF, true, GROWTH_CACHE_LINE_SIZE, 0})
+
+// Grows by n elements at a time, first allocation of at least a cache line,
+// keeps slack.
+#define GROWTH_STEP(n) \
+  ((growth_policy){GROWTH_MODE_STEP, true, GROWTH_CACHE_LINE_SIZE, (n)})
+
+// Synopsis:
+//   size_t growth_next_capacity(const growth_policy* policy, size_t capacity,
+//                               size_t needed, size_t ele_size);
+//
+// Description:
+// Returns the capacity a container with the given policy should grow to
+// from `capacity`. The result is always at least `needed` and at least
+// capacity + 1.
+//
+// args:
+// - policy: the growth policy of the container
+// - capacity: the current capacity, in elements
+// - needed: the smallest acceptable new capacity, in elements
+// - ele_size: the size of one element in bytes, non zero
+static inline size_t growth_next_capacity(const growth_policy* policy,
+                                          size_t capacity,
+                                          size_t needed,
+                                          size_t ele_size) {
+  size_t next = 0;
+  switch (policy->mode) {
+    case GROWTH_MODE_HALF:
+      next = capacity + capacity / 2;
+      break;
+    case GROWTH_MODE_STEP:
+      next = capacity + (policy->step == 0 ? 1 : policy->step);
+      break;
+    case GROWTH_MODE_DOUBLE:
+    default:
+      next = capacity == 0 ? 1 : capacity * 2;
+      break;
+  }
+
+  // saturate rather than wrap, the allocation will fail and panic instead
+  if (next < capacity) {
+    next = SIZE_MAX;
+  }
+
+  size_t min_capacity = (policy->min_bytes + ele_size - 1) / ele_size;
+  if (next < min_capacity) {
+    next = min_capacity;
+  }
+  if (next <= capacity) {
+    next = capacity + 1;
+  }
+  if (next < needed) {
+    next = needed;
+  }
+  return next;
+}
+
+#endif  // GROWTH_POLICY_H_
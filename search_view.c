@@ -0,0 +1,292 @@
+#include "./search_view.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./panic.h"
+
+#if defined(__x86_64__) && !defined(VEC_DISABLE_SIMD)
+#define SEARCH_VIEW_X86
+#include <immintrin.h>
+#endif
+
+#define CACHE_LINE 64
+
+// The tree is 1 based and its first element sits at the start of a cache
+// line, so the 8 descendants three levels below node k, 8k .. 8k + 7, fill
+// exactly one cache line.
+#define EYTZ_PREFETCH_STRIDE (CACHE_LINE / sizeof(ptr_t))
+
+// More layers than a tree with 9 children per node can need.
+#define BTV_MAX_LAYERS 24
+
+struct eytz_view_st {
+  ptr_t* tree;  // tree[1 .. n], tree[0] unused
+  size_t n;
+  ptr_cmp_fn cmp;
+  void* ctx;
+};
+
+struct btree_view_st {
+  intptr_t* keys;
+  size_t n;
+  size_t height;  // number of inner layers above the leaves
+  // offset into keys of the first node of each layer, layer 0 being the
+  // leaves (the sorted keys themselves, padded to a whole node)
+  size_t layer_offset[BTV_MAX_LAYERS];
+  size_t (*lower_bound)(const BTreeView*, intptr_t);
+};
+
+static void* alloc_lines(size_t size) {
+  size_t rounded = (size + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+  if (rounded < size) {
+    return NULL;
+  }
+  return aligned_alloc(CACHE_LINE, rounded == 0 ? CACHE_LINE : rounded);
+}
+
+// --- Eytzinger ---
+
+// Places sorted[*next ..] into the subtree rooted at k, in order.
+static void eytz_fill(EytzView* self,
+                      const ptr_t* sorted,
+                      size_t* next,
+                      size_t k) {
+  if (k > self->n) {
+    return;
+  }
+  eytz_fill(self, sorted, next, 2 * k);
+  self->tree[k] = sorted[(*next)++];
+  eytz_fill(self, sorted, next, 2 * k + 1);
+}
+
+EytzView* eytz_new(const ptr_t* sorted, size_t n, ptr_cmp_fn cmp, void* ctx) {
+  EytzView* self = (EytzView*)malloc(sizeof(EytzView));
+  ptr_t* tree = NULL;
+  if (self != NULL && n < SIZE_MAX / sizeof(ptr_t)) {
+    tree = (ptr_t*)alloc_lines((n + 1) * sizeof(ptr_t));
+  }
+  if (tree == NULL) {
+    free(self);
+    panic("Memory allocation failed in eytz_new");
+    return NULL;
+  }
+
+  self->tree = tree;
+  self->n = n;
+  self->cmp = cmp;
+  self->ctx = ctx;
+  size_t next = 0;
+  eytz_fill(self, sorted, &next, 1);
+  return self;
+}
+
+EytzView* eytz_from_vec(Vec* sorted, ptr_cmp_fn cmp, void* ctx) {
+  return eytz_new(sorted->data, sorted->length, cmp, ctx);
+}
+
+bool eytz_find(const EytzView* self, ptr_t key, ptr_t* found) {
+  size_t k = 1;
+  while (k <= self->n) {
+    // computed as an integer, the address may be past the end of the tree
+    __builtin_prefetch(
+        (const void*)((uintptr_t)self->tree +
+                      k * EYTZ_PREFETCH_STRIDE * sizeof(ptr_t)));
+    k = 2 * k + (self->cmp(self->tree[k], key, self->ctx) < 0);
+  }
+  // k went right past the lower bound and then left at every level below
+  // it: drop the trailing ones and the zero above them
+  k >>= (unsigned)__builtin_ffsll((long long)~k);
+
+  if (k == 0 || self->cmp(self->tree[k], key, self->ctx) != 0) {
+    return false;
+  }
+  *found = self->tree[k];
+  return true;
+}
+
+void eytz_destroy(EytzView* self) {
+  if (self == NULL) {
+    return;
+  }
+  free(self->tree);
+  free(self);
+}
+
+// --- B+ tree ---
+
+// Number of keys in `node` that are less than key. The keys are sorted, so
+// this is also the child to descend into.
+static size_t btv_rank_scalar(const intptr_t* node, intptr_t key) {
+  size_t rank = 0;
+  for (size_t i = 0; i < BTV_NODE_KEYS; i++) {
+    rank += node[i] < key;
+  }
+  return rank;
+}
+
+static size_t btv_lower_bound_scalar(const BTreeView* self, intptr_t key) {
+  size_t k = 0;
+  for (size_t h = self->height; h > 0; h--) {
+    const intptr_t* node =
+        &self->keys[self->layer_offset[h] + k * BTV_NODE_KEYS];
+    k = k * (BTV_NODE_KEYS + 1) + btv_rank_scalar(node, key);
+  }
+  return k * BTV_NODE_KEYS +
+         btv_rank_scalar(&self->keys[k * BTV_NODE_KEYS], key);
+}
+
+#ifdef SEARCH_VIEW_X86
+
+_Static_assert(sizeof(intptr_t) == sizeof(long long),
+               "BTreeView SIMD search needs 64 bit keys");
+
+__attribute__((target("avx2"))) static size_t btv_rank_avx2(
+    const intptr_t* node,
+    __m256i key) {
+  __m256i lo = _mm256_load_si256((const __m256i*)node);
+  __m256i hi = _mm256_load_si256((const __m256i*)(node + 4));
+  int lo_mask =
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(key, lo)));
+  int hi_mask =
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(key, hi)));
+  return (size_t)__builtin_popcount((unsigned)(lo_mask | (hi_mask << 4)));
+}
+
+__attribute__((target("avx2"))) static size_t btv_lower_bound_avx2(
+    const BTreeView* self,
+    intptr_t key) {
+  __m256i keys = _mm256_set1_epi64x((long long)key);
+  size_t k = 0;
+  for (size_t h = self->height; h > 0; h--) {
+    const intptr_t* node =
+        &self->keys[self->layer_offset[h] + k * BTV_NODE_KEYS];
+    k = k * (BTV_NODE_KEYS + 1) + btv_rank_avx2(node, keys);
+  }
+  return k * BTV_NODE_KEYS +
+         btv_rank_avx2(&self->keys[k * BTV_NODE_KEYS], keys);
+}
+
+#endif  // SEARCH_VIEW_X86
+
+// First key of the subtree under block `block` of layer `layer`, or
+// INTPTR_MAX if that subtree is past the end of the leaves.
+static intptr_t btv_subtree_min(const BTreeView* self,
+                                size_t leaf_blocks,
+                                size_t layer,
+                                size_t block) {
+  size_t leaf = block;
+  for (size_t h = 0; h < layer; h++) {
+    if (leaf >= leaf_blocks) {
+      return INTPTR_MAX;
+    }
+    leaf *= BTV_NODE_KEYS + 1;
+  }
+  return leaf < leaf_blocks ? self->keys[leaf * BTV_NODE_KEYS] : INTPTR_MAX;
+}
+
+// Allocates a view for n keys and lays out its layers. The caller fills in
+// the leaves, keys[0 .. n), and then calls btv_build_inner.
+static BTreeView* btv_alloc(size_t n) {
+  BTreeView* self = (BTreeView*)malloc(sizeof(BTreeView));
+  if (self == NULL) {
+    panic("Memory allocation failed in btv_new");
+    return NULL;
+  }
+
+  // layer sizes in nodes, from the leaves up to a single root
+  size_t blocks[BTV_MAX_LAYERS];
+  blocks[0] = n == 0 ? 1 : (n - 1) / BTV_NODE_KEYS + 1;
+  size_t total = blocks[0];
+  size_t height = 0;
+  while (blocks[height] > 1) {
+    blocks[height + 1] = (blocks[height] - 1) / (BTV_NODE_KEYS + 1) + 1;
+    height++;
+    self->layer_offset[height] = total * BTV_NODE_KEYS;
+    total += blocks[height];
+  }
+  self->layer_offset[0] = 0;
+  self->height = height;
+  self->n = n;
+
+  self->keys = NULL;
+  if (total < SIZE_MAX / BTV_NODE_KEYS / sizeof(intptr_t)) {
+    self->keys =
+        (intptr_t*)alloc_lines(total * BTV_NODE_KEYS * sizeof(intptr_t));
+  }
+  if (self->keys == NULL) {
+    free(self);
+    panic("Memory allocation failed in btv_new");
+    return NULL;
+  }
+
+  for (size_t i = n; i < blocks[0] * BTV_NODE_KEYS; i++) {
+    self->keys[i] = INTPTR_MAX;
+  }
+
+  self->lower_bound = btv_lower_bound_scalar;
+#ifdef SEARCH_VIEW_X86
+  if (__builtin_cpu_supports("avx2")) {
+    self->lower_bound = btv_lower_bound_avx2;
+  }
+#endif
+  return self;
+}
+
+// Fills the inner layers from the leaves. Key i of an inner node is the
+// first key under its child i + 1.
+static void btv_build_inner(BTreeView* self) {
+  size_t leaf_blocks = self->height == 0
+                           ? 1
+                           : self->layer_offset[1] / BTV_NODE_KEYS;
+  for (size_t h = 1; h <= self->height; h++) {
+    intptr_t* layer = &self->keys[self->layer_offset[h]];
+    size_t end = h == self->height ? self->layer_offset[h] + BTV_NODE_KEYS
+                                   : self->layer_offset[h + 1];
+    size_t nodes = (end - self->layer_offset[h]) / BTV_NODE_KEYS;
+    for (size_t j = 0; j < nodes; j++) {
+      for (size_t i = 0; i < BTV_NODE_KEYS; i++) {
+        layer[j * BTV_NODE_KEYS + i] = btv_subtree_min(
+            self, leaf_blocks, h - 1, j * (BTV_NODE_KEYS + 1) + i + 1);
+      }
+    }
+  }
+}
+
+BTreeView* btv_new(const intptr_t* sorted, size_t n) {
+  BTreeView* self = btv_alloc(n);
+  if (n > 0) {
+    memcpy(self->keys, sorted, n * sizeof(intptr_t));
+  }
+  btv_build_inner(self);
+  return self;
+}
+
+BTreeView* btv_from_vec(Vec* sorted) {
+  BTreeView* self = btv_alloc(sorted->length);
+  for (size_t i = 0; i < sorted->length; i++) {
+    self->keys[i] = (intptr_t)sorted->data[i];
+  }
+  btv_build_inner(self);
+  return self;
+}
+
+size_t btv_lower_bound(const BTreeView* self, intptr_t key) {
+  size_t index = self->lower_bound(self, key);
+  return index < self->n ? index : self->n;
+}
+
+size_t btv_find(const BTreeView* self, intptr_t key) {
+  size_t index = btv_lower_bound(self, key);
+  if (index == self->n || self->keys[index] != key) {
+    return VEC_NOT_FOUND;
+  }
+  return index;
+}
+
+void btv_destroy(BTreeView* self) {
+  if (self == NULL) {
+    return;
+  }
+  free(self->keys);
+  free(self);
+}
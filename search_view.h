@@ -0,0 +1,93 @@
+#ifndef SEARCH_VIEW_H_
+#define SEARCH_VIEW_H_
+
+/*!
+ * Frozen, search optimized copies of a sorted vector, for big read mostly
+ * lookup tables where a binary search over the sorted array takes a cache
+ * miss on nearly every probe.
+ *
+ *   EytzView   the elements in Eytzinger (breadth first) order, so the next
+ *              few levels of the search sit in one cache line that can be
+ *              prefetched ahead of time. Works for any elements with a
+ *              ptr_cmp_fn.
+ *   BTreeView  integer keys in a static B+ tree whose nodes are one cache
+ *              line (8 keys) each and are searched with SIMD compares.
+ *              The tree is about log_9(n) nodes deep instead of log_2(n).
+ *
+ * A view is a copy: later changes to the vector it was built from are not
+ * seen. Views are never modified after they are built, so any number of
+ * threads can search the same view at once.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for intptr_t
+#include "./Vec.h"
+#include "./vec_search.h"  // for VEC_NOT_FOUND
+#include "./vec_sort.h"    // for ptr_cmp_fn
+
+/* Keys per BTreeView node, one 64 byte cache line. */
+#define BTV_NODE_KEYS 8
+
+typedef struct eytz_view_st EytzView;
+typedef struct btree_view_st BTreeView;
+
+/*!
+ * Builds an Eytzinger view of n sorted elements.
+ *
+ * @param sorted the elements, sorted according to cmp. A vector(ptr_t) can
+ *               be passed directly.
+ * @param n      the number of elements
+ * @param cmp    the comparator the elements are sorted by, used by eytz_find
+ * @param ctx    passed to every call of cmp
+ * @returns a pointer to the new view, destroy it with eytz_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+EytzView* eytz_new(const ptr_t* sorted, size_t n, ptr_cmp_fn cmp, void* ctx);
+
+/* Same as eytz_new, over the elements of a sorted Vec.
+ */
+EytzView* eytz_from_vec(Vec* sorted, ptr_cmp_fn cmp, void* ctx);
+
+/* Looks up an element equal to key.
+ *
+ * @param found set to the first element equal to key, if there is one
+ * @returns true iff an element equal to key was found.
+ */
+bool eytz_find(const EytzView* self, ptr_t key, ptr_t* found);
+
+/* Releases the view. Does nothing if self is NULL.
+ */
+void eytz_destroy(EytzView* self);
+
+/*!
+ * Builds a B+ tree view of n sorted integer keys.
+ *
+ * @param sorted the keys in ascending order. A vector(intptr_t) can be
+ *               passed directly.
+ * @param n      the number of keys
+ * @returns a pointer to the new view, destroy it with btv_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+BTreeView* btv_new(const intptr_t* sorted, size_t n);
+
+/* Same as btv_new, over a sorted Vec whose elements are integers stored as
+ * (ptr_t)(intptr_t)value (see vec_sort_intptr).
+ */
+BTreeView* btv_from_vec(Vec* sorted);
+
+/* Returns the index in the sorted keys of the first key that is not less
+ * than key, n if there is none.
+ */
+size_t btv_lower_bound(const BTreeView* self, intptr_t key);
+
+/* Returns the index in the sorted keys of the first key equal to key, or
+ * VEC_NOT_FOUND.
+ */
+size_t btv_find(const BTreeView* self, intptr_t key);
+
+/* Releases the view. Does nothing if self is NULL.
+ */
+void btv_destroy(BTreeView* self);
+
+#endif  // SEARCH_VIEW_H_
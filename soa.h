@@ -0,0 +1,227 @@
+#ifndef SOA_H_
+#define SOA_H_
+
+/*!
+ * A generator for struct-of-arrays containers. vector(T) of a struct stores
+ * whole records one after the other, so a loop that reads one field of
+ * every record pulls the other fields through the cache too. A SoA
+ * container stores every field in its own array instead:
+ *
+ *   vector(Point):  x y x y x y x y ...
+ *   point_soa:      x x x x ...
+ *                   y y y y ...
+ *
+ * The fields are given as an X-macro, a macro that applies its argument to
+ * (type, name) for each of them:
+ *
+ *   typedef struct { float x; float y; int id; } Point;
+ *   #define POINT_FIELDS(F) F(float, x) F(float, y) F(int, id)
+ *   SOA_DECLARE(point_soa, Point, POINT_FIELDS)  // in a header
+ *   SOA_DEFINE(point_soa, Point, POINT_FIELDS)   // in one source file
+ *
+ * which gives a type
+ *
+ *   typedef struct {
+ *     size_t len;
+ *     size_t capacity;
+ *     float* x;
+ *     float* y;
+ *     int* id;
+ *   } point_soa;
+ *
+ * and these functions, which move whole rows (values of the row type,
+ * here Point) in and out and keep the columns the same length:
+ *
+ *   point_soa point_soa_new(size_t initial_capacity);
+ *   void point_soa_reserve(point_soa* self, size_t capacity);
+ *   void point_soa_push(point_soa* self, Point row);
+ *   Point point_soa_get(const point_soa* self, size_t index);
+ *   void point_soa_set(point_soa* self, size_t index, Point row);
+ *   void point_soa_erase(point_soa* self, size_t index);
+ *   void point_soa_swap_remove(point_soa* self, size_t index);
+ *   void point_soa_free(point_soa* self);
+ *
+ * The columns are plain arrays, self->x[0 .. self->len), each starting on
+ * a SOA_ALIGNMENT boundary, so a hot loop can run straight over one of
+ * them with aligned SIMD loads. The row type only needs a member for every
+ * field, with the same name. The columns hold plain values: no element
+ * destructors are run.
+ */
+
+#include <stddef.h>  // for size_t
+#include <stdint.h>
+#include <stdlib.h>  // for aligned_alloc, free
+#include <string.h>  // for memcpy, memmove
+#include "./panic.h"
+
+/* Every column starts on a boundary of this many bytes, a cache line. */
+#define SOA_ALIGNMENT ((size_t)64)
+
+/* Capacity of the first allocation when pushing onto an empty container. */
+#define SOA_MIN_CAPACITY ((size_t)16)
+
+// Synopsis:
+//   void* soa_impl_realloc(void* column, size_t len, size_t new_capacity,
+//                          size_t ele_size);
+//
+// Description:
+// Not part of the public interface, used by the generated functions.
+// Moves the first `len` elements of a column into a new SOA_ALIGNMENT
+// aligned array with room for `new_capacity` elements and frees the old
+// one. Panics if the allocation fails.
+//
+// returns:
+// - the new column
+static inline void* soa_impl_realloc(void* column,
+                                     size_t len,
+                                     size_t new_capacity,
+                                     size_t ele_size) {
+  if (new_capacity > (SIZE_MAX - SOA_ALIGNMENT) / ele_size) {
+    panic("Capacity overflow in SoA container\n");
+  }
+
+  // aligned_alloc wants a multiple of the alignment
+  size_t bytes = (new_capacity * ele_size + SOA_ALIGNMENT - 1) &
+                 ~(SOA_ALIGNMENT - 1);
+  void* new_column = aligned_alloc(SOA_ALIGNMENT, bytes);
+  if (new_column == NULL) {
+    panic("Memory allocation failed in SoA container\n");
+  }
+  if (len > 0) {
+    memcpy(new_column, column, len * ele_size);
+  }
+  free(column);
+  return new_column;
+}
+
+// Per-field pieces of the generated code, applied with the field list.
+#define SOA_IMPL_MEMBER(T, field) T* field;
+#define SOA_IMPL_INIT(T, field) soa.field = NULL;
+#define SOA_IMPL_GROW(T, field) \
+  self->field =                 \
+      (T*)soa_impl_realloc(self->field, self->len, capacity, sizeof(T));
+#define SOA_IMPL_PUSH(T, field) self->field[self->len] = row.field;
+#define SOA_IMPL_GET(T, field) row.field = self->field[index];
+#define SOA_IMPL_SET(T, field) self->field[index] = row.field;
+#define SOA_IMPL_ERASE(T, field)                        \
+  memmove(&self->field[index], &self->field[index + 1], \
+          (self->len - index - 1) * sizeof(T));
+#define SOA_IMPL_SWAP_REMOVE(T, field) \
+  self->field[index] = self->field[self->len - 1];
+#define SOA_IMPL_FREE(T, field) \
+  free(self->field);            \
+  self->field = NULL;
+
+// Synopsis:
+//   SOA_DECLARE(name, Row, FIELDS)
+//
+// Description:
+// Defines the container type `name` and declares its functions, see the
+// top of this file.
+//
+// args:
+// - name: the name of the container type and prefix of its functions
+// - Row: the struct type that rows are passed in and out as
+// - FIELDS: an X-macro applying its argument to (type, name) of each field
+#define SOA_DECLARE(name, Row, FIELDS)                                  \
+  typedef struct name##_st {                                            \
+    size_t len;                                                         \
+    size_t capacity;                                                    \
+    FIELDS(SOA_IMPL_MEMBER)                                             \
+  } name;                                                               \
+                                                                        \
+  name name##_new(size_t initial_capacity);                             \
+  void name##_reserve(name* self, size_t capacity);                     \
+  void name##_push(name* self, Row row);                                \
+  Row name##_get(const name* self, size_t index);                       \
+  void name##_set(name* self, size_t index, Row row);                   \
+  void name##_erase(name* self, size_t index);                          \
+  void name##_swap_remove(name* self, size_t index);                    \
+  void name##_free(name* self);
+
+// Synopsis:
+//   SOA_DEFINE(name, Row, FIELDS)
+//
+// Description:
+// Defines the functions declared by SOA_DECLARE with the same arguments.
+// Goes in exactly one source file, after SOA_DECLARE.
+//
+//  - name_new creates a container with room for initial_capacity rows
+//    (0 does not allocate). Panics if memory allocation fails.
+//  - name_reserve grows every column to hold at least `capacity` rows.
+//  - name_push appends a row. If the container is full, every column is
+//    moved to an array twice the size (SOA_MIN_CAPACITY at first), any
+//    pointers into the old columns are invalidated.
+//  - name_get and name_set read and write row `index`, name_erase removes
+//    it and moves the rows after it down, name_swap_remove replaces it with
+//    the last row. They panic if index >= self->len, like vector_get.
+//  - name_free frees every column and leaves an empty container.
+#define SOA_DEFINE(name, Row, FIELDS)                                      \
+  void name##_reserve(name* self, size_t capacity) {                       \
+    if (capacity <= self->capacity) {                                      \
+      return;                                                              \
+    }                                                                      \
+    FIELDS(SOA_IMPL_GROW)                                                  \
+    self->capacity = capacity;                                             \
+  }                                                                        \
+                                                                           \
+  name name##_new(size_t initial_capacity) {                               \
+    name soa;                                                              \
+    soa.len = 0;                                                           \
+    soa.capacity = 0;                                                      \
+    FIELDS(SOA_IMPL_INIT)                                                  \
+    name##_reserve(&soa, initial_capacity);                                \
+    return soa;                                                            \
+  }                                                                        \
+                                                                           \
+  void name##_push(name* self, Row row) {                                  \
+    if (self->len == self->capacity) {                                     \
+      if (self->capacity > SIZE_MAX / 2) {                                 \
+        panic("Capacity overflow in " #name "_push\n");                    \
+      }                                                                    \
+      name##_reserve(self, self->capacity == 0 ? SOA_MIN_CAPACITY          \
+                                               : self->capacity * 2);      \
+    }                                                                      \
+    FIELDS(SOA_IMPL_PUSH)                                                  \
+    self->len++;                                                           \
+  }                                                                        \
+                                                                           \
+  Row name##_get(const name* self, size_t index) {                         \
+    if (index >= self->len) {                                              \
+      panic("Index out of bounds in " #name "_get\n");                     \
+    }                                                                      \
+    Row row;                                                               \
+    FIELDS(SOA_IMPL_GET)                                                   \
+    return row;                                                            \
+  }                                                                        \
+                                                                           \
+  void name##_set(name* self, size_t index, Row row) {                     \
+    if (index >= self->len) {                                              \
+      panic("Index out of bounds in " #name "_set\n");                     \
+    }                                                                      \
+    FIELDS(SOA_IMPL_SET)                                                   \
+  }                                                                        \
+                                                                           \
+  void name##_erase(name* self, size_t index) {                            \
+    if (index >= self->len) {                                              \
+      panic("Index out of bounds in " #name "_erase\n");                   \
+    }                                                                      \
+    FIELDS(SOA_IMPL_ERASE)                                                 \
+    self->len--;                                                           \
+  }                                                                        \
+                                                                           \
+  void name##_swap_remove(name* self, size_t index) {                      \
+    if (index >= self->len) {                                              \
+      panic("Index out of bounds in " #name "_swap_remove\n");             \
+    }                                                                      \
+    FIELDS(SOA_IMPL_SWAP_REMOVE)                                           \
+    self->len--;                                                           \
+  }                                                                        \
+                                                                           \
+  void name##_free(name* self) {                                           \
+    FIELDS(SOA_IMPL_FREE)                                                  \
+    self->len = 0;                                                         \
+    self->capacity = 0;                                                    \
+  }
+
+#endif  // SOA_H_
@@ -0,0 +1,152 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./allocator.h"
+}
+
+using namespace std;
+
+// Forwards to malloc and keeps track of what is live, so tests can check
+// that every byte handed out came back through free_fn with the right size.
+typedef struct counting_ctx_st {
+  size_t live_blocks;
+  size_t live_bytes;
+  size_t calls;
+} counting_ctx;
+
+static void* counting_alloc(void* ctx, size_t size) {
+  counting_ctx* c = static_cast<counting_ctx*>(ctx);
+  c->live_blocks++;
+  c->live_bytes += size;
+  c->calls++;
+  return malloc(size);
+}
+
+static void* counting_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+  counting_ctx* c = static_cast<counting_ctx*>(ctx);
+  if (ptr == nullptr) {
+    return counting_alloc(ctx, new_size);
+  }
+  c->live_bytes = c->live_bytes - old_size + new_size;
+  c->calls++;
+  return realloc(ptr, new_size);
+}
+
+static void counting_free(void* ctx, void* ptr, size_t size) {
+  counting_ctx* c = static_cast<counting_ctx*>(ctx);
+  if (ptr == nullptr) {
+    return;
+  }
+  c->live_blocks--;
+  c->live_bytes -= size;
+  c->calls++;
+  free(ptr);
+}
+
+TEST_CASE("Vec Routes Every Allocation Through its Allocator", "[allocator]") {
+  counting_ctx ctx = {0, 0, 0};
+  Allocator counting = {counting_alloc, counting_realloc, counting_free, &ctx};
+
+  Vec v = vec_new_with_allocator(4, free, &counting);
+  REQUIRE(v.allocator == &counting);
+  REQUIRE(v.capacity == 4);
+  REQUIRE(ctx.live_blocks == 1);
+  REQUIRE(ctx.live_bytes == 4 * sizeof(ptr_t));
+
+  for (uintptr_t i = 0; i < 100; i++) {
+    uintptr_t* obj = static_cast<uintptr_t*>(malloc(sizeof(uintptr_t)));
+    *obj = i;
+    vec_push_back(&v, obj);
+  }
+  REQUIRE(v.capacity == 128);
+  REQUIRE(ctx.live_bytes == 128 * sizeof(ptr_t));
+
+  vec_erase_range(&v, 0, 90);
+  vec_resize(&v, 16);
+  REQUIRE(v.capacity == 16);
+  REQUIRE(ctx.live_bytes == 16 * sizeof(ptr_t));
+  REQUIRE(*static_cast<uintptr_t*>(vec_get(&v, 0)) == 90);
+
+  vec_destroy(&v);
+  REQUIRE(ctx.live_blocks == 0);
+  REQUIRE(ctx.live_bytes == 0);
+  REQUIRE(v.allocator == nullptr);
+}
+
+TEST_CASE("Vec with Zero Capacity Allocates Lazily", "[allocator]") {
+  counting_ctx ctx = {0, 0, 0};
+  Allocator counting = {counting_alloc, counting_realloc, counting_free, &ctx};
+
+  Vec v = vec_new_with_allocator(0, nullptr, &counting);
+  REQUIRE(v.data == nullptr);
+  REQUIRE(ctx.calls == 0);
+
+  vec_push_back(&v, nullptr);
+  REQUIRE(ctx.live_blocks == 1);
+  vec_destroy(&v);
+  REQUIRE(ctx.live_blocks == 0);
+}
+
+TEST_CASE("Libc Allocator", "[allocator]") {
+  Vec v = vec_new_with_allocator(0, nullptr, &allocator_libc);
+  for (uintptr_t i = 0; i < 1000; i++) {
+    vec_push_back(&v, reinterpret_cast<ptr_t>(i));
+  }
+  for (uintptr_t i = 0; i < 1000; i++) {
+    REQUIRE(reinterpret_cast<uintptr_t>(vec_get(&v, i)) == i);
+  }
+  vec_destroy(&v);
+}
+
+TEST_CASE("Pool Allocator Reuses Blocks of the Same Class", "[allocator]") {
+  Pool* pool = pool_new();
+  const Allocator* alloc = pool_allocator(pool);
+
+  void* first = alloc->alloc_fn(alloc->ctx, 24);
+  REQUIRE(reinterpret_cast<uintptr_t>(first) % POOL_MIN_CLASS_SIZE == 0);
+  alloc->free_fn(alloc->ctx, first, 24);
+  // 24 and 32 bytes are both in the 32 byte class
+  void* second = alloc->alloc_fn(alloc->ctx, 32);
+  REQUIRE(second == first);
+
+  // growing within a class keeps the block, crossing one moves it
+  REQUIRE(alloc->realloc_fn(alloc->ctx, second, 32, 20) == second);
+  memset(second, 'x', 20);
+  char* moved = static_cast<char*>(alloc->realloc_fn(alloc->ctx, second, 20, 100));
+  REQUIRE(moved != second);
+  REQUIRE(moved[19] == 'x');
+
+  // bigger than the largest class, straight from malloc
+  void* big = alloc->alloc_fn(alloc->ctx, POOL_MAX_CLASS_SIZE + 1);
+  REQUIRE(big != nullptr);
+  alloc->free_fn(alloc->ctx, big, POOL_MAX_CLASS_SIZE + 1);
+
+  pool_destroy(pool);
+}
+
+TEST_CASE("Pool Allocator Backs Many Small Vecs", "[allocator]") {
+  Pool* pool = pool_new();
+
+  for (int round = 0; round < 100; round++) {
+    Vec vecs[16];
+    for (Vec& v : vecs) {
+      v = vec_new_with_allocator(0, nullptr, pool_allocator(pool));
+    }
+    for (uintptr_t i = 0; i < 40; i++) {
+      for (Vec& v : vecs) {
+        vec_push_back(&v, reinterpret_cast<ptr_t>(i));
+      }
+    }
+    for (Vec& v : vecs) {
+      REQUIRE(v.length == 40);
+      REQUIRE(reinterpret_cast<uintptr_t>(vec_get(&v, 39)) == 39);
+      vec_destroy(&v);
+    }
+  }
+
+  pool_destroy(pool);
+}
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./arena.h"
+}
+
+using namespace std;
+
+TEST_CASE("Arena Allocations are Aligned and Distinct", "[arena]") {
+  Arena* arena = arena_new(256);
+
+  char* first = static_cast<char*>(arena_alloc(arena, 3));
+  char* second = static_cast<char*>(arena_alloc(arena, 17));
+  REQUIRE(reinterpret_cast<uintptr_t>(first) % alignof(max_align_t) == 0);
+  REQUIRE(reinterpret_cast<uintptr_t>(second) % alignof(max_align_t) == 0);
+  REQUIRE(second >= first + 3);
+
+  memset(first, 'a', 3);
+  memset(second, 'b', 17);
+  REQUIRE(first[2] == 'a');
+
+  // bigger than a chunk, gets a dedicated one
+  char* big = static_cast<char*>(arena_alloc(arena, 4096));
+  memset(big, 'c', 4096);
+  REQUIRE(arena_footprint(arena) >= 4096 + 256);
+  REQUIRE(second[16] == 'b');
+
+  // the regular chunk is still being bumped after the big allocation
+  char* third = static_cast<char*>(arena_alloc(arena, 8));
+  REQUIRE(third > second);
+  REQUIRE(third < second + 256);
+
+  arena_reset(arena);
+  REQUIRE(arena_footprint(arena) == 256);
+  arena_destroy(arena);
+}
+
+TEST_CASE("Arena Realloc Extends the Last Allocation", "[arena]") {
+  Arena* arena = arena_new(1024);
+
+  char* buf = static_cast<char*>(arena_realloc(arena, nullptr, 0, 16));
+  strcpy(buf, "hello");
+  char* grown = static_cast<char*>(arena_realloc(arena, buf, 16, 64));
+  REQUIRE(grown == buf);
+
+  arena_alloc(arena, 8);  // buf is no longer the last allocation
+  char* moved = static_cast<char*>(arena_realloc(arena, grown, 64, 128));
+  REQUIRE(moved != grown);
+  REQUIRE(strcmp(moved, "hello") == 0);
+
+  arena_destroy(arena);
+}
+
+TEST_CASE("Arena Vec", "[arena]") {
+  Vec v = vec_new_in_arena(2, 0);
+  REQUIRE(v.arena != nullptr);
+  REQUIRE(v.capacity == 2);
+  REQUIRE(v.ele_dtor_fn == nullptr);
+
+  for (uintptr_t i = 0; i < 1000; i++) {
+    uintptr_t* obj = static_cast<uintptr_t*>(arena_alloc(v.arena, sizeof(uintptr_t)));
+    *obj = i;
+    vec_push_back(&v, obj);
+  }
+  REQUIRE(v.length == 1000);
+  REQUIRE(v.capacity == 1024);
+
+  for (uintptr_t i = 0; i < 1000; i++) {
+    REQUIRE(*static_cast<uintptr_t*>(vec_get(&v, i)) == i);
+  }
+
+  vec_erase_range(&v, 0, 500);
+  REQUIRE(*static_cast<uintptr_t*>(vec_get(&v, 0)) == 500);
+
+  vec_destroy(&v);
+  REQUIRE(v.arena == nullptr);
+  REQUIRE(v.data == nullptr);
+  REQUIRE(v.length == 0);
+}
@@ -450,3 +450,360 @@ TEST_CASE("Stress Test with Large Capacity and Operations", "[stress]") {
   vec_destroy(&v);
   //done...
 }
+
+// --- Large (mmap backed) buffers ---
+TEST_CASE("Push Past the mmap Threshold", "[resize]") {
+  const uintptr_t num = (2 * VEC_MMAP_THRESHOLD) / sizeof(ptr_t) + 1;
+  Vec v = vec_new(0, nullptr);
+
+  for (uintptr_t i = 0; i < num; ++i) {
+    vec_push_back(&v, reinterpret_cast<ptr_t>(i));
+  }
+  REQUIRE(v.length == num);
+  REQUIRE(v.capacity >= num);
+
+  for (uintptr_t i = 0; i < num; ++i) {
+    REQUIRE(vec_get(&v, i) == reinterpret_cast<ptr_t>(i));
+  }
+
+  vec_destroy(&v);
+  REQUIRE(v.data == nullptr);
+}
+
+TEST_CASE("Resize Into and Out of the mmap Threshold", "[resize]") {
+  const size_t big = VEC_MMAP_THRESHOLD / sizeof(ptr_t);
+  Vec v = vec_new(4, nullptr);
+  vec_push_back(&v, kOne);
+  vec_push_back(&v, kTwo);
+
+  vec_resize(&v, big);
+  REQUIRE(v.capacity == big);
+  vec_resize(&v, big * 4);
+  REQUIRE(v.capacity == big * 4);
+  vec_resize(&v, 3);
+  REQUIRE(v.capacity == 3);
+
+  REQUIRE(v.length == 2);
+  REQUIRE(vec_get(&v, 0) == kOne);
+  REQUIRE(vec_get(&v, 1) == kTwo);
+  vec_destroy(&v);
+}
+
+// --- Growth Policies ---
+TEST_CASE("Default Policy Doubles", "[growth]") {
+  Vec v = vec_new_with_policy(0, nullptr, GROWTH_DOUBLE);
+  vec_push_back(&v, kOne);
+  REQUIRE(v.capacity == 1);
+  vec_push_back(&v, kTwo);
+  REQUIRE(v.capacity == 2);
+  vec_push_back(&v, kThree);
+  REQUIRE(v.capacity == 4);
+  vec_destroy(&v);
+}
+
+TEST_CASE("1.5x Policy Starts at a Cache Line", "[growth]") {
+  Vec v = vec_new_with_policy(0, nullptr, GROWTH_1_5X);
+  vec_push_back(&v, kOne);
+  REQUIRE(v.capacity >= GROWTH_CACHE_LINE_SIZE / sizeof(ptr_t));
+
+  size_t prev = v.capacity;
+  while (v.capacity == prev) {
+    vec_push_back(&v, kTwo);
+  }
+  // grows by roughly half, plus whatever slack malloc handed back
+  REQUIRE(v.capacity >= prev + prev / 2);
+  REQUIRE(v.capacity < prev * 2 + 4);
+
+  REQUIRE(vec_get(&v, 0) == kOne);
+  for (size_t i = 1; i < v.length; i++) {
+    REQUIRE(vec_get(&v, i) == kTwo);
+  }
+  vec_destroy(&v);
+}
+
+TEST_CASE("Fixed Step Policy", "[growth]") {
+  const size_t step = 100;
+  Vec v = vec_new_with_policy(step, count_constants, GROWTH_STEP(step));
+  REQUIRE(v.capacity >= step);
+
+  counter = 0;
+  invocations = 0;
+  size_t prev = v.capacity;
+  for (size_t i = 0; i <= prev; i++) {
+    vec_push_back(&v, kOne);
+  }
+  REQUIRE(v.capacity >= prev + step);
+  REQUIRE(v.capacity < prev + 2 * step);
+
+  vec_destroy(&v);
+  REQUIRE(invocations == static_cast<int>(prev + 1));
+}
+
+// --- Small Vec ---
+TEST_CASE("Small Vec Stays Inline", "[small-vec]") {
+  SmallVec v = svec_new(nullptr);
+  REQUIRE(svec_is_empty(&v));
+  REQUIRE(svec_capacity(&v) == VEC_SMALL_CAPACITY);
+
+  for (uintptr_t i = 0; i < VEC_SMALL_CAPACITY; ++i) {
+    svec_push_back(&v, reinterpret_cast<ptr_t>(i));
+  }
+  REQUIRE(svec_len(&v) == VEC_SMALL_CAPACITY);
+  REQUIRE_FALSE(svec_is_spilled(&v));
+
+  for (uintptr_t i = 0; i < VEC_SMALL_CAPACITY; ++i) {
+    REQUIRE(svec_get(&v, i) == reinterpret_cast<ptr_t>(i));
+  }
+  svec_destroy(&v);
+}
+
+TEST_CASE("Small Vec Spills to the Heap", "[small-vec]") {
+  counter = 0;
+  invocations = 0;
+
+  SmallVec v = svec_new(count_constants);
+  for (uintptr_t i = 0; i < 3 * VEC_SMALL_CAPACITY; ++i) {
+    svec_push_back(&v, kOne);
+  }
+  REQUIRE(svec_is_spilled(&v));
+  REQUIRE(svec_capacity(&v) == 4 * VEC_SMALL_CAPACITY);
+  REQUIRE(svec_len(&v) == 3 * VEC_SMALL_CAPACITY);
+
+  svec_set(&v, 0, kTwo);
+  REQUIRE(svec_get(&v, 0) == kTwo);
+  REQUIRE(invocations == 1);
+
+  REQUIRE(svec_pop_back(&v));
+  REQUIRE(invocations == 2);
+
+  svec_destroy(&v);
+  REQUIRE(invocations == 3 * VEC_SMALL_CAPACITY + 1);
+  REQUIRE(counter == 3 * VEC_SMALL_CAPACITY + 2);
+  REQUIRE(svec_is_empty(&v));
+  REQUIRE_FALSE(svec_is_spilled(&v));
+}
+
+// --- Range Operations ---
+TEST_CASE("Extend and Insert Range", "[range]") {
+  ptr_t first[] = {kOne, kTwo};
+  ptr_t middle[] = {kFour, kFive, kSixetyEight};
+
+  Vec v = vec_new(0, nullptr);
+  vec_extend(&v, first, 2);
+  vec_extend(&v, nullptr, 0);
+  vec_push_back(&v, kThree);
+  REQUIRE(v.length == 3);
+
+  vec_insert_range(&v, 1, middle, 3);
+  REQUIRE(v.length == 6);
+  REQUIRE(v.capacity >= 6);
+
+  ptr_t expected[] = {kOne, kFour, kFive, kSixetyEight, kTwo, kThree};
+  for (size_t i = 0; i < 6; i++) {
+    REQUIRE(vec_get(&v, i) == expected[i]);
+  }
+
+  vec_insert_range(&v, 6, first, 2);
+  REQUIRE(vec_get(&v, 6) == kOne);
+  REQUIRE(vec_get(&v, 7) == kTwo);
+  vec_destroy(&v);
+}
+
+TEST_CASE("Erase Range and Truncate w/Dtor", "[range]") {
+  counter = 0;
+  invocations = 0;
+
+  Vec v = vec_new(8, count_constants);
+  ptr_t elems[] = {kOne, kTwo, kThree, kFour, kFive};
+  vec_extend(&v, elems, 5);
+
+  vec_erase_range(&v, 1, 2);  // kTwo, kThree
+  REQUIRE(v.length == 3);
+  REQUIRE(counter == 5);
+  REQUIRE(invocations == 2);
+  REQUIRE(vec_get(&v, 0) == kOne);
+  REQUIRE(vec_get(&v, 1) == kFour);
+  REQUIRE(vec_get(&v, 2) == kFive);
+
+  vec_erase_range(&v, 3, 0);
+  REQUIRE(v.length == 3);
+
+  vec_truncate(&v, 5);
+  REQUIRE(v.length == 3);
+  vec_truncate(&v, 1);  // kFour, kFive
+  REQUIRE(v.length == 1);
+  REQUIRE(counter == 14);
+  REQUIRE(invocations == 4);
+  REQUIRE(v.capacity == 8);
+
+  vec_destroy(&v);
+  REQUIRE(counter == 15);
+  REQUIRE(invocations == 5);
+}
+
+TEST_CASE("Stress Test with a Single Erase Range", "[stress]") {
+  Vec v = vec_new(1000, count_constants);
+
+  for (uintptr_t i = 0; i < 1001; ++i) {
+    vec_push_back(&v, kOne);
+  }
+
+  counter = 0;
+  invocations = 0;
+  vec_erase_range(&v, 0, 500);
+
+  REQUIRE(v.length == 501);
+  REQUIRE(v.capacity == 2000);
+  REQUIRE(invocations == 500);
+
+  vec_destroy(&v);
+}
+
+// --- Unordered Removal ---
+static bool is_not_two(ptr_t ele, [[maybe_unused]] void* ctx) {
+  return ele != kTwo;
+}
+
+static bool below_limit(ptr_t ele, void* ctx) {
+  return reinterpret_cast<uintptr_t>(ele) < *static_cast<uintptr_t*>(ctx);
+}
+
+TEST_CASE("Swap Remove", "[unordered]") {
+  counter = 0;
+  invocations = 0;
+
+  Vec v = vec_new(4, count_constants);
+  vec_push_back(&v, kOne);
+  vec_push_back(&v, kTwo);
+  vec_push_back(&v, kThree);
+  vec_push_back(&v, kFour);
+
+  vec_swap_remove(&v, 1);  // kFour takes kTwo's place
+  REQUIRE(v.length == 3);
+  REQUIRE(counter == 2);
+  REQUIRE(invocations == 1);
+  REQUIRE(vec_get(&v, 0) == kOne);
+  REQUIRE(vec_get(&v, 1) == kFour);
+  REQUIRE(vec_get(&v, 2) == kThree);
+
+  vec_swap_remove(&v, 2);  // removing the last element
+  REQUIRE(v.length == 2);
+  REQUIRE(vec_get(&v, 1) == kFour);
+  vec_destroy(&v);
+}
+
+TEST_CASE("Retain", "[unordered]") {
+  counter = 0;
+  invocations = 0;
+
+  Vec v = vec_new(0, count_constants);
+  for (int i = 0; i < 10; i++) {
+    vec_push_back(&v, kOne);
+    vec_push_back(&v, kTwo);
+  }
+
+  vec_retain(&v, is_not_two, nullptr);
+  REQUIRE(v.length == 10);
+  REQUIRE(counter == 20);
+  REQUIRE(invocations == 10);
+  for (size_t i = 0; i < v.length; i++) {
+    REQUIRE(vec_get(&v, i) == kOne);
+  }
+  vec_destroy(&v);
+
+  Vec nums = vec_new(0, nullptr);
+  for (uintptr_t i = 0; i < 100; i++) {
+    vec_push_back(&nums, reinterpret_cast<ptr_t>(99 - i));
+  }
+  uintptr_t limit = 10;
+  vec_retain(&nums, below_limit, &limit);
+  REQUIRE(nums.length == 10);
+  for (uintptr_t i = 0; i < 10; i++) {
+    REQUIRE(vec_get(&nums, i) == reinterpret_cast<ptr_t>(9 - i));
+  }
+  vec_destroy(&nums);
+}
+
+// --- Batched Destructors ---
+static int batch_calls = 0;
+
+static void count_constants_batch(ptr_t* elems, size_t n) {
+  batch_calls += 1;
+  for (size_t i = 0; i < n; i++) {
+    count_constants(elems[i]);
+  }
+}
+
+TEST_CASE("Batch Destructor Called Once per Span", "[batch-dtor]") {
+  counter = 0;
+  invocations = 0;
+  batch_calls = 0;
+
+  Vec v = vec_new_batched(0, count_constants_batch);
+  REQUIRE(v.ele_dtor_fn == nullptr);
+  REQUIRE(v.ele_batch_dtor_fn == count_constants_batch);
+  for (int i = 0; i < 10; i++) {
+    vec_push_back(&v, kOne);
+  }
+
+  vec_erase_range(&v, 2, 3);
+  REQUIRE(batch_calls == 1);
+  REQUIRE(invocations == 3);
+
+  vec_truncate(&v, 5);
+  REQUIRE(batch_calls == 2);
+  REQUIRE(invocations == 5);
+
+  vec_erase(&v, 0);
+  vec_set(&v, 0, kTwo);
+  REQUIRE(batch_calls == 4);
+  REQUIRE(invocations == 7);
+
+  vec_clear(&v);
+  REQUIRE(batch_calls == 5);
+  REQUIRE(invocations == 11);
+  REQUIRE(counter == 12);
+
+  vec_push_back(&v, kThree);
+  vec_destroy(&v);
+  REQUIRE(batch_calls == 6);
+  REQUIRE(counter == 15);
+  REQUIRE(v.ele_batch_dtor_fn == nullptr);
+}
+
+TEST_CASE("Batch Destructor Called Once by Retain", "[batch-dtor]") {
+  counter = 0;
+  invocations = 0;
+  batch_calls = 0;
+
+  Vec v = vec_new_batched(0, count_constants_batch);
+  for (int i = 0; i < 10; i++) {
+    vec_push_back(&v, kOne);
+    vec_push_back(&v, kTwo);
+  }
+  vec_retain(&v, is_not_two, nullptr);
+  REQUIRE(batch_calls == 1);
+  REQUIRE(invocations == 10);
+  REQUIRE(counter == 20);
+  REQUIRE(v.length == 10);
+  for (size_t i = 0; i < v.length; i++) {
+    REQUIRE(vec_get(&v, i) == kOne);
+  }
+
+  vec_retain(&v, is_not_two, nullptr);
+  REQUIRE(batch_calls == 1);
+  vec_destroy(&v);
+  REQUIRE(batch_calls == 2);
+  REQUIRE(counter == 30);
+}
+
+TEST_CASE("Free as the Element Destructor", "[batch-dtor]") {
+  Vec v = vec_new(0, free);
+  for (int i = 0; i < 100; i++) {
+    vec_push_back(&v, malloc(16));
+  }
+  vec_erase_range(&v, 10, 20);
+  vec_truncate(&v, 50);
+  REQUIRE(v.length == 50);
+  vec_destroy(&v);
+}
@@ -0,0 +1,157 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./concurrent_vec.h"
+}
+
+using namespace std;
+
+static constexpr uintptr_t kThreads = 8;
+static constexpr uintptr_t kPerThread = 20000;
+
+// Elements encode (thread, sequence) so every push can be accounted for.
+static ptr_t encode(uintptr_t thread, uintptr_t seq) {
+  return reinterpret_cast<ptr_t>(thread * kPerThread + seq + 1);
+}
+
+static void require_all_pushed_once(Vec* v) {
+  REQUIRE(v->length == kThreads * kPerThread);
+  vector<uintptr_t> last_seq(kThreads, 0);
+  vector<bool> seen(kThreads * kPerThread, false);
+  for (size_t i = 0; i < v->length; i++) {
+    uintptr_t value = reinterpret_cast<uintptr_t>(vec_get(v, i)) - 1;
+    REQUIRE(value < kThreads * kPerThread);
+    REQUIRE_FALSE(seen[value]);
+    seen[value] = true;
+
+    // each producer's own elements keep their order
+    uintptr_t thread = value / kPerThread;
+    uintptr_t seq = value % kPerThread;
+    REQUIRE((seq == 0 || seq > last_seq[thread]));
+    last_seq[thread] = seq;
+  }
+}
+
+TEST_CASE("Concurrent Vec Single Threaded", "[concurrent]") {
+  ConcurrentVec* cv = cvec_new(0, nullptr);
+  REQUIRE(cvec_len(cv) == 0);
+
+  for (uintptr_t i = 0; i < 1000; i++) {
+    REQUIRE(cvec_push_back(cv, reinterpret_cast<ptr_t>(i)) == i);
+  }
+  REQUIRE(cvec_len(cv) == 1000);
+  for (uintptr_t i = 0; i < 1000; i++) {
+    REQUIRE(reinterpret_cast<uintptr_t>(cvec_get(cv, i)) == i);
+  }
+
+  ptr_t batch[3] = {reinterpret_cast<ptr_t>(7), reinterpret_cast<ptr_t>(8),
+                    reinterpret_cast<ptr_t>(9)};
+  REQUIRE(cvec_extend(cv, batch, 3) == 1000);
+  REQUIRE(reinterpret_cast<uintptr_t>(cvec_get(cv, 1002)) == 9);
+
+  Vec v = cvec_into_vec(cv);
+  REQUIRE(v.length == 1003);
+  REQUIRE(reinterpret_cast<uintptr_t>(vec_get(&v, 999)) == 999);
+  REQUIRE(reinterpret_cast<uintptr_t>(vec_get(&v, 1000)) == 7);
+  vec_destroy(&v);
+}
+
+TEST_CASE("Concurrent Vec Into Vec at Bucket Edges", "[concurrent]") {
+  // buckets of 8, 16, 32... end at indices 8, 24, 56...
+  const size_t lengths[] = {0, 1, 7, 8, 9, 23, 24, 25, 56};
+  for (size_t length : lengths) {
+    ConcurrentVec* cv = cvec_new(0, nullptr);
+    cvec_reserve(cv, 200);  // buckets past the length are freed too
+    for (uintptr_t i = 0; i < length; i++) {
+      cvec_push_back(cv, reinterpret_cast<ptr_t>(i + 1));
+    }
+    Vec moved = cvec_into_vec(cv);
+    REQUIRE(moved.length == length);
+    for (uintptr_t i = 0; i < length; i++) {
+      REQUIRE(reinterpret_cast<uintptr_t>(vec_get(&moved, i)) == i + 1);
+    }
+    vec_destroy(&moved);
+  }
+}
+
+TEST_CASE("Concurrent Vec Elements Never Move", "[concurrent]") {
+  ConcurrentVec* cv = cvec_new(3, free);
+  uintptr_t* first = static_cast<uintptr_t*>(malloc(sizeof(uintptr_t)));
+  *first = 42;
+  cvec_push_back(cv, first);
+  for (int i = 0; i < 10000; i++) {
+    cvec_push_back(cv, malloc(1));
+  }
+  REQUIRE(cvec_get(cv, 0) == first);
+  REQUIRE(*first == 42);
+  cvec_destroy(cv);
+}
+
+TEST_CASE("Concurrent Vec Parallel Push", "[concurrent]") {
+  // start small so producers race to allocate buckets
+  ConcurrentVec* cv = cvec_new(0, nullptr);
+
+  vector<thread> producers;
+  for (uintptr_t t = 0; t < kThreads; t++) {
+    producers.emplace_back([cv, t] {
+      for (uintptr_t seq = 0; seq < kPerThread; seq++) {
+        size_t index = cvec_push_back(cv, encode(t, seq));
+        // our own element is visible as soon as the push returns
+        if (cvec_get(cv, index) != encode(t, seq)) {
+          abort();
+        }
+      }
+    });
+  }
+  for (thread& producer : producers) {
+    producer.join();
+  }
+
+  Vec v = cvec_into_vec(cv);
+  require_all_pushed_once(&v);
+  vec_destroy(&v);
+}
+
+TEST_CASE("Concurrent Vec Parallel Extend with Reader", "[concurrent]") {
+  ConcurrentVec* cv = cvec_new(0, nullptr);
+  cvec_reserve(cv, kThreads * kPerThread / 2);
+
+  constexpr uintptr_t kBatch = 16;
+  vector<thread> producers;
+  for (uintptr_t t = 0; t < kThreads; t++) {
+    producers.emplace_back([cv, t] {
+      ptr_t batch[kBatch];
+      for (uintptr_t seq = 0; seq < kPerThread; seq += kBatch) {
+        for (uintptr_t i = 0; i < kBatch; i++) {
+          batch[i] = encode(t, seq + i);
+        }
+        size_t first = cvec_extend(cv, batch, kBatch);
+        // a batch stays in consecutive slots
+        if (cvec_get(cv, first + kBatch - 1) != batch[kBatch - 1]) {
+          abort();
+        }
+      }
+    });
+  }
+
+  // reads racing with the producers see either NULL or a pushed element
+  while (cvec_len(cv) < kThreads * kPerThread) {
+    size_t len = cvec_len(cv);
+    if (len > 0) {
+      uintptr_t value = reinterpret_cast<uintptr_t>(cvec_get(cv, len - 1));
+      REQUIRE(value <= kThreads * kPerThread);
+    }
+  }
+  for (thread& producer : producers) {
+    producer.join();
+  }
+
+  Vec v = cvec_into_vec(cv);
+  require_all_pushed_once(&v);
+  vec_destroy(&v);
+}
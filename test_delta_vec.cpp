@@ -0,0 +1,101 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include "./delta_vec.h"
+}
+
+using namespace std;
+
+// Checks every value through dvec_get and through dvec_decode, both as a
+// whole and in pieces that start and end inside blocks.
+static void require_contents(DeltaVec* d, const vector<int64_t>& expected) {
+  REQUIRE(dvec_len(d) == expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    REQUIRE(dvec_get(d, i) == expected[i]);
+  }
+
+  vector<int64_t> out(expected.size());
+  dvec_decode(d, 0, expected.size(), out.data());
+  REQUIRE(out == expected);
+
+  for (size_t begin = 0; begin < expected.size(); begin += 97) {
+    size_t n = min<size_t>(expected.size() - begin, 200);
+    vector<int64_t> piece(n);
+    dvec_decode(d, begin, n, piece.data());
+    for (size_t i = 0; i < n; i++) {
+      REQUIRE(piece[i] == expected[begin + i]);
+    }
+  }
+}
+
+TEST_CASE("DeltaVec Empty and Partial Block", "[deltavec]") {
+  DeltaVec* d = dvec_new();
+  REQUIRE(dvec_len(d) == 0);
+  REQUIRE(dvec_encoded_bytes(d) == 0);
+  dvec_decode(d, 0, 0, nullptr);
+
+  vector<int64_t> expected;
+  for (int64_t i = 0; i < DVEC_BLOCK_LEN - 1; i++) {
+    dvec_push_back(d, i * 3);
+    expected.push_back(i * 3);
+  }
+  require_contents(d, expected);
+  dvec_destroy(d);
+  dvec_destroy(nullptr);
+}
+
+TEST_CASE("DeltaVec Sorted Timestamps Compress", "[deltavec]") {
+  DeltaVec* d = dvec_new();
+  mt19937_64 rng(7);
+  vector<int64_t> expected;
+  int64_t t = 1700000000000;
+  for (size_t i = 0; i < 100 * DVEC_BLOCK_LEN + 5; i++) {
+    t += 1000 + static_cast<int64_t>(rng() % 200);
+    dvec_push_back(d, t);
+    expected.push_back(t);
+  }
+  require_contents(d, expected);
+  // 8 bit differences, about one byte per value plus the block headers
+  REQUIRE(dvec_encoded_bytes(d) * 4 < expected.size() * sizeof(int64_t));
+  dvec_destroy(d);
+}
+
+TEST_CASE("DeltaVec Constant Steps Pack to Zero Bits", "[deltavec]") {
+  DeltaVec* d = dvec_new();
+  vector<int64_t> expected;
+  for (int64_t i = 0; i < 10 * DVEC_BLOCK_LEN; i++) {
+    dvec_push_back(d, 500 - 7 * i);
+    expected.push_back(500 - 7 * i);
+  }
+  require_contents(d, expected);
+  // only the block headers are left
+  REQUIRE(dvec_encoded_bytes(d) < expected.size());
+  dvec_destroy(d);
+}
+
+TEST_CASE("DeltaVec Every Width Round Trips", "[deltavec]") {
+  DeltaVec* d = dvec_new();
+  mt19937_64 rng(11);
+  vector<int64_t> expected;
+  // one block for every width from 0 to 64, unsorted within the width
+  for (unsigned width = 0; width <= 64; width++) {
+    uint64_t mask = width == 0 ? 0 : ~uint64_t{0} >> (64 - width);
+    for (size_t j = 0; j < DVEC_BLOCK_LEN; j++) {
+      int64_t value = static_cast<int64_t>(rng() & mask);
+      dvec_push_back(d, value);
+      expected.push_back(value);
+    }
+  }
+  // differences that wrap around
+  for (size_t j = 0; j < DVEC_BLOCK_LEN + 2; j++) {
+    int64_t value = j % 3 == 0 ? INT64_MIN : INT64_MAX - static_cast<int64_t>(j);
+    dvec_push_back(d, value);
+    expected.push_back(value);
+  }
+  require_contents(d, expected);
+  dvec_destroy(d);
+}
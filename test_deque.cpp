@@ -0,0 +1,140 @@
+#include "catch.hpp"
+#include <stdlib.h>
+
+extern "C" {
+  #include "./Vec.h"
+}
+
+using namespace std;
+
+static ptr_t kOne   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(1U)));
+static ptr_t kTwo   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(2U)));
+static ptr_t kThree = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(3U)));
+
+static uintptr_t counter = 0;
+static int invocations = 0;
+
+static void count_constants(ptr_t input) {
+  counter += reinterpret_cast<uintptr_t>(input);
+  invocations += 1;
+}
+
+TEST_CASE("Deque Construction", "[deque]") {
+  VecDeque d = vdq_new(5, nullptr);
+  REQUIRE(d.data != nullptr);
+  REQUIRE(vdq_capacity(&d) == 8);  // rounded up to a power of two
+  REQUIRE(vdq_is_empty(&d));
+  vdq_destroy(&d);
+  REQUIRE(d.data == nullptr);
+
+  VecDeque empty = vdq_new(0, nullptr);
+  REQUIRE(vdq_capacity(&empty) == 0);
+  vdq_push_front(&empty, kOne);
+  REQUIRE(vdq_capacity(&empty) == 1);
+  REQUIRE(vdq_get(&empty, 0) == kOne);
+  vdq_destroy(&empty);
+}
+
+TEST_CASE("Deque Push and Pop at Both Ends", "[deque]") {
+  VecDeque d = vdq_new(2, nullptr);
+  vdq_push_back(&d, kTwo);
+  vdq_push_front(&d, kOne);
+  vdq_push_back(&d, kThree);  // grows while wrapped
+
+  REQUIRE(vdq_len(&d) == 3);
+  REQUIRE(vdq_capacity(&d) == 4);
+  REQUIRE(vdq_get(&d, 0) == kOne);
+  REQUIRE(vdq_get(&d, 1) == kTwo);
+  REQUIRE(vdq_get(&d, 2) == kThree);
+
+  REQUIRE(vdq_pop_front(&d));
+  REQUIRE(vdq_get(&d, 0) == kTwo);
+  REQUIRE(vdq_pop_back(&d));
+  REQUIRE(vdq_get(&d, 0) == kTwo);
+  REQUIRE(vdq_pop_back(&d));
+  REQUIRE_FALSE(vdq_pop_back(&d));
+  REQUIRE_FALSE(vdq_pop_front(&d));
+  vdq_destroy(&d);
+}
+
+TEST_CASE("Deque as a FIFO Queue", "[deque]") {
+  VecDeque d = vdq_new(4, nullptr);
+  uintptr_t next_in = 0;
+  uintptr_t next_out = 0;
+
+  // keep the queue short so head walks around the buffer many times
+  for (int round = 0; round < 1000; round++) {
+    vdq_push_back(&d, reinterpret_cast<ptr_t>(next_in++));
+    vdq_push_back(&d, reinterpret_cast<ptr_t>(next_in++));
+    REQUIRE(vdq_get(&d, 0) == reinterpret_cast<ptr_t>(next_out++));
+    REQUIRE(vdq_pop_front(&d));
+  }
+
+  REQUIRE(vdq_len(&d) == 1000);
+  for (size_t i = 0; i < vdq_len(&d); i++) {
+    REQUIRE(vdq_get(&d, i) == reinterpret_cast<ptr_t>(next_out + i));
+  }
+  vdq_destroy(&d);
+}
+
+TEST_CASE("Deque Slices", "[deque]") {
+  VecDeque d = vdq_new(8, nullptr);
+  VecSlice first;
+  VecSlice second;
+
+  vdq_as_slices(&d, &first, &second);
+  REQUIRE(first.length == 0);
+  REQUIRE(second.length == 0);
+
+  for (uintptr_t i = 0; i < 6; i++) {
+    vdq_push_back(&d, reinterpret_cast<ptr_t>(i));
+  }
+  vdq_as_slices(&d, &first, &second);
+  REQUIRE(first.length == 6);
+  REQUIRE(second.length == 0);
+
+  for (uintptr_t i = 0; i < 2; i++) {
+    vdq_push_front(&d, reinterpret_cast<ptr_t>(100 + i));
+  }
+  // still full at capacity 8, the front wrapped to the end of the buffer
+  REQUIRE(vdq_capacity(&d) == 8);
+  vdq_as_slices(&d, &first, &second);
+  REQUIRE(first.length == 2);
+  REQUIRE(second.length == 6);
+
+  size_t idx = 0;
+  for (size_t i = 0; i < first.length; i++, idx++) {
+    REQUIRE(first.data[i] == vdq_get(&d, idx));
+  }
+  for (size_t i = 0; i < second.length; i++, idx++) {
+    REQUIRE(second.data[i] == vdq_get(&d, idx));
+  }
+  vdq_destroy(&d);
+}
+
+TEST_CASE("Deque Destructor Calls", "[deque]") {
+  counter = 0;
+  invocations = 0;
+
+  VecDeque d = vdq_new(2, count_constants);
+  vdq_push_back(&d, kOne);
+  vdq_push_front(&d, kTwo);
+  vdq_push_front(&d, kThree);
+
+  vdq_set(&d, 0, kOne);  // replaces kThree
+  REQUIRE(counter == 3);
+  REQUIRE(invocations == 1);
+
+  REQUIRE(vdq_pop_front(&d));  // kOne
+  REQUIRE(counter == 4);
+
+  vdq_clear(&d);  // kTwo, kOne
+  REQUIRE(counter == 7);
+  REQUIRE(invocations == 4);
+  REQUIRE(vdq_is_empty(&d));
+
+  vdq_push_back(&d, kTwo);
+  vdq_destroy(&d);
+  REQUIRE(counter == 9);
+  REQUIRE(invocations == 5);
+}
@@ -0,0 +1,165 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./disk_vec.h"
+}
+
+using namespace std;
+
+// Sanitizers map shadow memory that counts towards the process RSS, so the
+// RSS of a sanitized build says nothing about the DiskVec budget.
+#if defined(__SANITIZE_THREAD__) || defined(__SANITIZE_ADDRESS__)
+#define RSS_IS_MEANINGFUL false
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer) || __has_feature(address_sanitizer)
+#define RSS_IS_MEANINGFUL false
+#endif
+#endif
+#ifndef RSS_IS_MEANINGFUL
+#define RSS_IS_MEANINGFUL true
+#endif
+
+static uintptr_t counter = 0;
+static int invocations = 0;
+
+static void count_constants(ptr_t input) {
+  counter += reinterpret_cast<uintptr_t>(input);
+  invocations += 1;
+}
+
+static ptr_t as_ptr(uintptr_t value) {
+  return reinterpret_cast<ptr_t>(value);
+}
+
+// Resident set size of this process, from /proc/self/statm.
+static size_t resident_bytes() {
+  FILE* statm = fopen("/proc/self/statm", "r");
+  REQUIRE(statm != nullptr);
+  size_t total = 0;
+  size_t resident = 0;
+  REQUIRE(fscanf(statm, "%zu %zu", &total, &resident) == 2);
+  fclose(statm);
+  return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+TEST_CASE("DiskVec Basic Operations", "[diskvec]") {
+  DiskVec* d = diskvec_new(nullptr, 0, nullptr);
+  REQUIRE(diskvec_len(d) == 0);
+  REQUIRE_FALSE(diskvec_pop_back(d));
+
+  diskvec_push_back(d, as_ptr(1));
+  diskvec_push_back(d, as_ptr(2));
+  diskvec_set(d, 0, as_ptr(3));
+  *diskvec_at(d, 1) = as_ptr(4);
+  REQUIRE(diskvec_len(d) == 2);
+  REQUIRE(diskvec_get(d, 0) == as_ptr(3));
+  REQUIRE(diskvec_get(d, 1) == as_ptr(4));
+  REQUIRE(diskvec_resident_bytes(d) == DISKVEC_PAGE_BYTES);
+
+  REQUIRE(diskvec_pop_back(d));
+  REQUIRE(diskvec_pop_back(d));
+  REQUIRE(diskvec_len(d) == 0);
+  diskvec_destroy(d);
+  diskvec_destroy(nullptr);
+}
+
+TEST_CASE("DiskVec Spills Past Its Budget", "[diskvec]") {
+  const size_t budget = DISKVEC_MIN_FRAMES * DISKVEC_PAGE_BYTES;
+  const size_t n = 10 * budget / sizeof(ptr_t) + 123;
+  DiskVec* d = diskvec_new(nullptr, budget, nullptr);
+  for (size_t i = 0; i < n; i++) {
+    diskvec_push_back(d, as_ptr(i * 3));
+  }
+  REQUIRE(diskvec_len(d) == n);
+  REQUIRE(diskvec_resident_bytes(d) <= budget);
+
+  // a scan, random reads and writes, and a scan to see the writes
+  for (size_t i = 0; i < n; i++) {
+    REQUIRE(diskvec_get(d, i) == as_ptr(i * 3));
+  }
+  mt19937_64 rng(5);
+  vector<size_t> touched;
+  for (int k = 0; k < 2000; k++) {
+    size_t i = rng() % n;
+    diskvec_set(d, i, as_ptr(i * 5));
+    touched.push_back(i);
+  }
+  for (size_t i : touched) {
+    REQUIRE(diskvec_get(d, i) == as_ptr(i * 5));
+  }
+  size_t changed = 0;
+  for (size_t i = 0; i < n; i++) {
+    ptr_t ele = diskvec_get(d, i);
+    REQUIRE((ele == as_ptr(i * 3) || ele == as_ptr(i * 5)));
+    changed += i != 0 && ele == as_ptr(i * 5);
+  }
+  REQUIRE(changed > 0);
+  REQUIRE(diskvec_resident_bytes(d) <= budget);
+
+  // pop across page boundaries, then grow again over evicted pages
+  for (size_t i = 0; i < 3 * DISKVEC_PAGE_ELEMS; i++) {
+    REQUIRE(diskvec_pop_back(d));
+  }
+  size_t kept = n - 3 * DISKVEC_PAGE_ELEMS;
+  for (size_t i = kept; i < n; i++) {
+    diskvec_push_back(d, as_ptr(i + 1));
+  }
+  REQUIRE(diskvec_get(d, 0) == as_ptr(0));
+  REQUIRE(diskvec_get(d, kept) == as_ptr(kept + 1));
+  REQUIRE(diskvec_get(d, n - 1) == as_ptr(n));
+
+  diskvec_clear(d);
+  REQUIRE(diskvec_len(d) == 0);
+  diskvec_push_back(d, as_ptr(9));
+  REQUIRE(diskvec_get(d, 0) == as_ptr(9));
+  diskvec_destroy(d);
+}
+
+TEST_CASE("DiskVec Keeps RSS Bounded", "[diskvec]") {
+  const size_t budget = (size_t)4 << 20;
+  // 40 MB of elements under a 4 MB budget
+  const size_t n = 10 * budget / sizeof(ptr_t);
+  DiskVec* d = diskvec_new(nullptr, budget, nullptr);
+  size_t before = resident_bytes();
+  uintptr_t sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    diskvec_push_back(d, as_ptr(i));
+    sum += i;
+  }
+  for (size_t i = 0; i < n; i++) {
+    sum -= reinterpret_cast<uintptr_t>(diskvec_get(d, i));
+  }
+  size_t after = resident_bytes();
+  REQUIRE(sum == 0);
+  REQUIRE(diskvec_resident_bytes(d) <= budget);
+  // the budget, plus room for the page table and allocator overhead
+  if (RSS_IS_MEANINGFUL) {
+    REQUIRE(after < before + 2 * budget);
+  }
+  diskvec_destroy(d);
+}
+
+TEST_CASE("DiskVec Destructs Evicted Elements", "[diskvec]") {
+  counter = 0;
+  invocations = 0;
+  const size_t n = 6 * DISKVEC_PAGE_ELEMS;
+  DiskVec* d = diskvec_new(nullptr, 0, count_constants);
+  for (size_t i = 0; i < n; i++) {
+    diskvec_push_back(d, as_ptr(1));
+  }
+  diskvec_set(d, 0, as_ptr(2));
+  REQUIRE(counter == 1);
+  REQUIRE(diskvec_pop_back(d));
+  REQUIRE(counter == 2);
+  diskvec_destroy(d);
+  // 1 + 1 before, then the 2 and n - 2 ones left
+  REQUIRE(counter == n + 2);
+  REQUIRE(invocations == static_cast<int>(n + 1));
+}
@@ -0,0 +1,182 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+}
+
+using namespace std;
+
+static ptr_t kOne   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(1U)));
+static ptr_t kTwo   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(2U)));
+static ptr_t kThree = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(3U)));
+
+static uintptr_t counter = 0;
+static int invocations = 0;
+
+static void count_constants(ptr_t input) {
+  counter += reinterpret_cast<uintptr_t>(input);
+  invocations += 1;
+}
+
+static void require_contents(GapBuf* b, const vector<ptr_t>& expected) {
+  REQUIRE(gbuf_len(b) == expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    REQUIRE(gbuf_get(b, i) == expected[i]);
+  }
+}
+
+TEST_CASE("GapBuf Construction", "[gapbuf]") {
+  GapBuf empty = gbuf_new(0, nullptr);
+  REQUIRE(empty.data == nullptr);
+  REQUIRE(gbuf_capacity(&empty) == 0);
+  REQUIRE(gbuf_is_empty(&empty));
+  gbuf_insert(&empty, kOne);
+  REQUIRE(gbuf_capacity(&empty) == 1);
+  REQUIRE(gbuf_get(&empty, 0) == kOne);
+  gbuf_destroy(&empty);
+
+  GapBuf b = gbuf_new(10, nullptr);
+  REQUIRE(b.data != nullptr);
+  REQUIRE(gbuf_capacity(&b) == 10);
+  REQUIRE(gbuf_len(&b) == 0);
+  REQUIRE(gbuf_cursor(&b) == 0);
+  gbuf_destroy(&b);
+  REQUIRE(b.data == nullptr);
+  REQUIRE(gbuf_capacity(&b) == 0);
+}
+
+TEST_CASE("GapBuf Insert and Erase at the Cursor", "[gapbuf]") {
+  GapBuf b = gbuf_new(4, nullptr);
+  gbuf_insert(&b, kOne);
+  gbuf_insert(&b, kThree);
+  REQUIRE(gbuf_cursor(&b) == 2);
+  require_contents(&b, {kOne, kThree});
+
+  gbuf_move_to(&b, 1);
+  gbuf_insert(&b, kTwo);
+  REQUIRE(gbuf_cursor(&b) == 2);
+  require_contents(&b, {kOne, kTwo, kThree});
+
+  // the cursor is between kTwo and kThree
+  REQUIRE(gbuf_erase_after(&b));
+  require_contents(&b, {kOne, kTwo});
+  REQUIRE_FALSE(gbuf_erase_after(&b));
+  REQUIRE(gbuf_erase_before(&b));
+  require_contents(&b, {kOne});
+
+  gbuf_move_to(&b, 0);
+  REQUIRE_FALSE(gbuf_erase_before(&b));
+  REQUIRE(gbuf_erase_after(&b));
+  REQUIRE(gbuf_is_empty(&b));
+  REQUIRE(gbuf_capacity(&b) == 4);
+  gbuf_destroy(&b);
+}
+
+TEST_CASE("GapBuf Grows with Elements on Both Sides", "[gapbuf]") {
+  GapBuf b = gbuf_new(0, nullptr);
+  vector<ptr_t> model;
+  for (uintptr_t i = 0; i < 100; i++) {
+    gbuf_insert(&b, reinterpret_cast<ptr_t>(i));
+    model.push_back(reinterpret_cast<ptr_t>(i));
+  }
+  // every further insert lands in the middle, and some of them grow the
+  // buffer while elements are after the gap
+  gbuf_move_to(&b, 50);
+  for (uintptr_t i = 0; i < 1000; i++) {
+    gbuf_insert(&b, reinterpret_cast<ptr_t>(1000 + i));
+    model.insert(model.begin() + 50 + static_cast<long>(i),
+                 reinterpret_cast<ptr_t>(1000 + i));
+  }
+  require_contents(&b, model);
+  REQUIRE(gbuf_capacity(&b) == 2048);
+
+  VecSlice before;
+  VecSlice after;
+  gbuf_as_slices(&b, &before, &after);
+  REQUIRE(before.length == 1050);
+  REQUIRE(after.length == 50);
+  REQUIRE(after.data[0] == model[1050]);
+  REQUIRE(after.data + after.length == b.data + gbuf_capacity(&b));
+  gbuf_destroy(&b);
+}
+
+TEST_CASE("GapBuf Matches a Vector Under Random Edits", "[gapbuf]") {
+  mt19937 rng(16);
+  GapBuf b = gbuf_new(0, nullptr);
+  vector<ptr_t> model;
+  size_t cursor = 0;
+  uintptr_t next = 0;
+
+  for (int step = 0; step < 20000; step++) {
+    switch (rng() % 6) {
+      case 0:
+        cursor = model.empty() ? 0 : rng() % (model.size() + 1);
+        gbuf_move_to(&b, cursor);
+        break;
+      case 1:
+      case 2:
+        gbuf_insert(&b, reinterpret_cast<ptr_t>(next));
+        model.insert(model.begin() + static_cast<long>(cursor),
+                     reinterpret_cast<ptr_t>(next));
+        cursor++;
+        next++;
+        break;
+      case 3:
+        REQUIRE(gbuf_erase_before(&b) == (cursor > 0));
+        if (cursor > 0) {
+          model.erase(model.begin() + static_cast<long>(--cursor));
+        }
+        break;
+      case 4:
+        REQUIRE(gbuf_erase_after(&b) == (cursor < model.size()));
+        if (cursor < model.size()) {
+          model.erase(model.begin() + static_cast<long>(cursor));
+        }
+        break;
+      default:
+        if (!model.empty()) {
+          size_t index = rng() % model.size();
+          gbuf_set(&b, index, reinterpret_cast<ptr_t>(next));
+          model[index] = reinterpret_cast<ptr_t>(next++);
+        }
+        break;
+    }
+    REQUIRE(gbuf_cursor(&b) == cursor);
+    REQUIRE(gbuf_len(&b) == model.size());
+  }
+  require_contents(&b, model);
+  gbuf_destroy(&b);
+}
+
+TEST_CASE("GapBuf Element Destructor", "[gapbuf]") {
+  counter = 0;
+  invocations = 0;
+  GapBuf b = gbuf_new(2, count_constants);
+  gbuf_insert(&b, kOne);
+  gbuf_insert(&b, kTwo);
+  gbuf_insert(&b, kThree);
+  gbuf_move_to(&b, 1);
+  REQUIRE(invocations == 0);  // growing and moving destroy nothing
+
+  gbuf_set(&b, 0, kThree);
+  REQUIRE(counter == 1);
+  REQUIRE(gbuf_erase_after(&b));
+  REQUIRE(counter == 3);
+  REQUIRE(invocations == 2);
+
+  // the remaining kThree on each side of the gap
+  gbuf_clear(&b);
+  REQUIRE(counter == 9);
+  REQUIRE(invocations == 4);
+  REQUIRE(gbuf_cursor(&b) == 0);
+  REQUIRE(gbuf_capacity(&b) == 4);
+
+  gbuf_insert(&b, kOne);
+  gbuf_destroy(&b);
+  REQUIRE(counter == 10);
+  REQUIRE(invocations == 5);
+}
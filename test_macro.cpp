@@ -1,12 +1,23 @@
 #include <sys/types.h>
+#include <dirent.h>
 #include <sys/wait.h>
 #include <signal.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
 
 #include "catch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
 
 extern "C" {
   #include "./vector.h"
+  #include "./vector_simd.h"
+  #include "./soa.h"
+  #include "./bitvec.h"
+  #include "./vector_file.h"
 }
 
 using namespace std;
@@ -406,3 +417,670 @@ TEST_CASE("Stress Test with Large Capacity and Operations", "[stress macro]") {
 
     vector_free(&vec);
 }
+
+// --- Growth Policies ---
+TEST_CASE("Growth Policy 1.5x", "[growth macro]") {
+    vector(uintptr_t) vec = vector_new_with_policy(uintptr_t, 0, NULL, GROWTH_1_5X);
+    // header slack may already hold one element, the first real growth
+    // has to reach a full cache line
+    vector_push(&vec, kOne);
+    vector_push(&vec, kTwo);
+    REQUIRE(vector_capacity(&vec) >= GROWTH_CACHE_LINE_SIZE / sizeof(uintptr_t));
+
+    size_t prev = vector_capacity(&vec);
+    while (vector_capacity(&vec) == prev) {
+        vector_push(&vec, kTwo);
+    }
+    REQUIRE(vector_capacity(&vec) >= prev + prev / 2);
+    REQUIRE(vector_capacity(&vec) < prev * 2 + 4);
+    REQUIRE(vec[0] == kOne);
+    vector_free(&vec);
+}
+
+TEST_CASE("Growth Policy Fixed Step", "[growth macro]") {
+    vector(_____Point) vec = vector_new_with_policy(_____Point, 0, NULL, GROWTH_STEP(10));
+    for (int i = 0; i < 25; i++) {
+        vector_push(&vec, (_____Point){i, -i});
+    }
+    REQUIRE(vector_len(&vec) == 25);
+    REQUIRE(vector_capacity(&vec) >= 25);
+    REQUIRE(vector_capacity(&vec) < 25 + 10 + 8);
+
+    vector_resize(&vec, 100);
+    REQUIRE(vector_capacity(&vec) >= 100);
+    REQUIRE(vec[24].x == 24);
+    REQUIRE(vec[24].y == -24);
+    vector_free(&vec);
+    REQUIRE(vec == nullptr);
+}
+
+// --- Allocators ---
+static size_t alloc_live_bytes = 0;
+static size_t alloc_calls = 0;
+
+static void* tracking_alloc([[maybe_unused]] void* ctx, size_t size) {
+    alloc_calls++;
+    alloc_live_bytes += size;
+    return malloc(size);
+}
+
+static void* tracking_realloc(void* ctx, void* ptr, size_t old_size, size_t new_size) {
+    if (ptr == nullptr) {
+        return tracking_alloc(ctx, new_size);
+    }
+    alloc_calls++;
+    alloc_live_bytes = alloc_live_bytes - old_size + new_size;
+    return realloc(ptr, new_size);
+}
+
+static void tracking_free([[maybe_unused]] void* ctx, void* ptr, size_t size) {
+    if (ptr != nullptr) {
+        alloc_live_bytes -= size;
+        free(ptr);
+    }
+}
+
+TEST_CASE("Vector with Allocator", "[allocator macro]") {
+    Allocator tracking = {tracking_alloc, tracking_realloc, tracking_free, nullptr};
+    alloc_live_bytes = 0;
+
+    vector(_____Point) vec = vector_new_with_allocator(_____Point, 2, NULL, &tracking);
+    REQUIRE(get_vector_header(&vec)->allocator == &tracking);
+    REQUIRE(alloc_live_bytes == sizeof(vector_info) + 2 * sizeof(_____Point));
+
+    for (int i = 0; i < 50; i++) {
+        vector_push(&vec, (_____Point){i, i * 2});
+    }
+    REQUIRE(vector_capacity(&vec) == 64);
+    REQUIRE(alloc_live_bytes == sizeof(vector_info) + 64 * sizeof(_____Point));
+    REQUIRE(vec[49].y == 98);
+
+    vector_free(&vec);
+    REQUIRE(vec == nullptr);
+    REQUIRE(alloc_live_bytes == 0);
+}
+
+TEST_CASE("Vector with Pool Allocator", "[allocator macro]") {
+    Pool* pool = pool_new();
+    vector(char*) vec = vector_new_with_allocator(char*, 0, string_destructor, pool_allocator(pool));
+    for (int i = 0; i < 100; i++) {
+        vector_push(&vec, strdup("pooled"));
+    }
+    REQUIRE(strcmp(vector_get(&vec, 99), "pooled") == 0);
+    vector_free(&vec);
+    pool_destroy(pool);
+}
+
+TEST_CASE("Aligned Vector with Allocator", "[allocator macro]") {
+    Allocator tracking = {tracking_alloc, tracking_realloc, tracking_free, nullptr};
+    Allocator aligned;
+    alloc_live_bytes = 0;
+    alloc_calls = 0;
+
+    // created with a single allocation of the whole block
+    vector(double) vec = vector_new_with_allocator(double, 3, NULL,
+                                                   vector_aligned_allocator(&aligned, &tracking));
+    REQUIRE(alloc_calls == 1);
+    REQUIRE(alloc_live_bytes == sizeof(vector_info) + 3 * sizeof(double) + VECTOR_IMPL_ALIGNED_LEAD);
+    REQUIRE(reinterpret_cast<uintptr_t>(vec) % VECTOR_ALIGNMENT == 0);
+    for (int i = 0; i < 100; i++) {
+        vector_push(&vec, static_cast<double>(i));
+        REQUIRE(reinterpret_cast<uintptr_t>(vec) % VECTOR_ALIGNMENT == 0);
+    }
+    REQUIRE(vec[99] == 99.0);
+    vector_free(&vec);
+    REQUIRE(alloc_live_bytes == 0);
+
+    Pool* pool = pool_new();
+    vector(double) pooled = vector_new_with_allocator(double, 0, NULL,
+                                                      vector_aligned_allocator(&aligned, pool_allocator(pool)));
+    for (int i = 0; i < 1000; i++) {
+        vector_push(&pooled, static_cast<double>(i));
+        REQUIRE(reinterpret_cast<uintptr_t>(pooled) % VECTOR_ALIGNMENT == 0);
+    }
+    REQUIRE(vector_sum_f64(&pooled) == 999.0 * 1000.0 / 2.0);
+    vector_free(&pooled);
+    pool_destroy(pool);
+}
+
+// --- Filling Elements in Place ---
+TEST_CASE("Emplace Back", "[emplace macro]") {
+    vector(_____Point) vec = NULL;
+    for (int i = 0; i < 100; i++) {
+        _____Point* p = vector_emplace_back(&vec);
+        REQUIRE(p == &vec[i]);
+        p->x = i;
+        p->y = -i;
+        REQUIRE(vector_len(&vec) == static_cast<size_t>(i) + 1);
+    }
+    REQUIRE(vec[57].x == 57);
+    REQUIRE(vec[57].y == -57);
+    vector_free(&vec);
+}
+
+TEST_CASE("Push n Uninitialized", "[emplace macro]") {
+    vector(char) buf = vector_new(char, 4, NULL);
+    vector_push(&buf, 'a');
+
+    const char text[] = "hello, world";
+    char* dst = vector_push_n_uninit(&buf, sizeof(text));
+    REQUIRE(dst == &buf[1]);
+    memcpy(dst, text, sizeof(text));
+    REQUIRE(vector_len(&buf) == sizeof(text) + 1);
+    REQUIRE(vector_capacity(&buf) >= sizeof(text) + 1);
+    REQUIRE(strcmp(&buf[1], text) == 0);
+
+    // reserving nothing returns the end and changes nothing
+    size_t cap = vector_capacity(&buf);
+    REQUIRE(vector_push_n_uninit(&buf, 0) == buf + vector_len(&buf));
+    REQUIRE(vector_capacity(&buf) == cap);
+    vector_free(&buf);
+
+    vector(int) empty = NULL;
+    REQUIRE(vector_push_n_uninit(&empty, 0) == nullptr);
+    int* ints = vector_push_n_uninit(&empty, 3);
+    ints[0] = 1;
+    ints[1] = 2;
+    ints[2] = 3;
+    REQUIRE(vector_len(&empty) == 3);
+    REQUIRE(vector_get(&empty, 2) == 3);
+    vector_free(&empty);
+}
+
+TEST_CASE("Emplaced Elements Are Destroyed", "[emplace macro]") {
+    counter = 0;
+    invocations = 0;
+    vector(uintptr_t) vec = vector_new(uintptr_t, 0, count_constants);
+    *vector_emplace_back(&vec) = kTwo;
+    uintptr_t* two = vector_push_n_uninit(&vec, 2);
+    two[0] = kThree;
+    two[1] = kFour;
+    vector_free(&vec);
+    REQUIRE(counter == 9);
+    REQUIRE(invocations == 3);
+}
+
+// --- Generated Functions ---
+VECTOR_DECLARE(_____Point, point_vec)
+VECTOR_DEFINE(_____Point, point_vec)
+VECTOR_DEFINE(uintptr_t, uint_vec)
+
+TEST_CASE("Generated Functions Match the Macros", "[typed macro]") {
+    vector(_____Point) vec = NULL;
+    for (int i = 0; i < 100; i++) {
+        point_vec_push(&vec, (_____Point){i, -i});
+    }
+    REQUIRE(vector_len(&vec) == 100);
+    REQUIRE(vector_capacity(&vec) >= 100);
+
+    _____Point* slot = point_vec_emplace_back(&vec);
+    slot->x = 100;
+    slot->y = -100;
+    point_vec_erase(&vec, 100);
+    REQUIRE(point_vec_push_n_uninit(&vec, 0) == vec + 100);
+
+    point_vec_insert(&vec, 0, (_____Point){-1, 1});
+    point_vec_erase(&vec, 50);
+    REQUIRE(vector_len(&vec) == 100);
+    REQUIRE(vec[0].x == -1);
+    REQUIRE(vec[50].x == 50);
+
+    // generated functions and macros work on the same vector
+    vector_push(&vec, (_____Point){7, 7});
+    REQUIRE(point_vec_pop(&vec));
+    point_vec_resize(&vec, 500);
+    REQUIRE(vector_capacity(&vec) == 500);
+    REQUIRE(vec[99].y == -99);
+
+    point_vec_free(&vec);
+    REQUIRE(vec == nullptr);
+    REQUIRE_FALSE(point_vec_pop(&vec));
+}
+
+TEST_CASE("Generated Functions with Dtor", "[typed macro]") {
+    counter = 0;
+    invocations = 0;
+    vector(uintptr_t) vec = vector_new(uintptr_t, 0, count_constants);
+    uint_vec_push(&vec, kOne);
+    uint_vec_push(&vec, kTwo);
+    uint_vec_insert(&vec, 1, kFour);
+    uint_vec_erase(&vec, 1);
+    REQUIRE(counter == 4);
+    REQUIRE(uint_vec_pop(&vec));
+    REQUIRE(counter == 6);
+
+    uint_vec_push(&vec, kThree);
+    uint_vec_free(&vec);
+    REQUIRE(counter == 10);
+    REQUIRE(invocations == 4);
+}
+
+// --- Aligned Vectors ---
+TEST_CASE("Aligned Vector Stays Aligned", "[aligned macro]") {
+    vector(double) vec = vector_new_aligned(double, 3, NULL);
+    REQUIRE(vector_capacity(&vec) == 3);
+    REQUIRE(reinterpret_cast<uintptr_t>(vec) % VECTOR_ALIGNMENT == 0);
+    // the padding is kept in the block, not in the header
+    REQUIRE(sizeof(vector_info) == 4 * sizeof(size_t) + sizeof(growth_policy));
+
+    for (int i = 0; i < 1000; i++) {
+        vector_push(&vec, static_cast<double>(i));
+        REQUIRE(reinterpret_cast<uintptr_t>(vec) % VECTOR_ALIGNMENT == 0);
+    }
+    vector_insert(&vec, 0, -1.0);
+    vector_resize(&vec, 5000);
+    REQUIRE(reinterpret_cast<uintptr_t>(vec) % VECTOR_ALIGNMENT == 0);
+    REQUIRE(vector_len(&vec) == 1001);
+    REQUIRE(vec[0] == -1.0);
+    REQUIRE(vec[1000] == 999.0);
+    vector_free(&vec);
+    REQUIRE(vec == nullptr);
+}
+
+TEST_CASE("Aligned Vector with Dtor", "[aligned macro]") {
+    counter = 0;
+    invocations = 0;
+    vector(uintptr_t) vec = vector_new_aligned(uintptr_t, 0, count_constants);
+    for (int i = 0; i < 100; i++) {
+        vector_push(&vec, kOne);
+    }
+    vector_erase(&vec, 0);
+    REQUIRE(counter == 1);
+    vector_free(&vec);
+    REQUIRE(counter == 100);
+    REQUIRE(invocations == 100);
+}
+
+TEST_CASE("SIMD Reductions", "[simd macro]") {
+    vector(double) aligned = vector_new_aligned(double, 0, NULL);
+    vector(double) plain = vector_new(double, 0, NULL);
+    vector(float) floats = vector_new(float, 0, NULL);
+
+    REQUIRE(vector_sum_f64(&aligned) == 0.0);
+    REQUIRE(vector_min_f64(&aligned) == INFINITY);
+    REQUIRE(vector_max_f64(&aligned) == -INFINITY);
+    REQUIRE(vector_sum_f32(&floats) == 0.0f);
+
+    double sum = 0;
+    for (int i = 0; i < 300; i++) {
+        // small integers, so every summation order is exact
+        double x = static_cast<double>((i * 37) % 101 - 50);
+        vector_push(&aligned, x);
+        vector_push(&plain, x);
+        vector_push(&floats, static_cast<float>(x));
+        sum += x;
+
+        double lo = *std::min_element(aligned, aligned + i + 1);
+        double hi = *std::max_element(aligned, aligned + i + 1);
+        REQUIRE(vector_sum_f64(&aligned) == sum);
+        REQUIRE(vector_sum_f64(&plain) == sum);
+        REQUIRE(vector_sum_f32(&floats) == static_cast<float>(sum));
+        REQUIRE(vector_min_f64(&aligned) == lo);
+        REQUIRE(vector_min_f64(&plain) == lo);
+        REQUIRE(vector_min_f32(&floats) == static_cast<float>(lo));
+        REQUIRE(vector_max_f64(&aligned) == hi);
+        REQUIRE(vector_max_f64(&plain) == hi);
+        REQUIRE(vector_max_f32(&floats) == static_cast<float>(hi));
+    }
+
+    double* null_vec = nullptr;
+    REQUIRE(vector_sum_f64(&null_vec) == 0.0);
+
+    vector_free(&aligned);
+    vector_free(&plain);
+    vector_free(&floats);
+}
+
+// --- Struct of Arrays ---
+typedef struct {
+    int x;
+    int y;
+    double weight;
+} _____Particle;
+
+#define PARTICLE_FIELDS(F) F(int, x) F(int, y) F(double, weight)
+SOA_DECLARE(particle_soa, _____Particle, PARTICLE_FIELDS)
+SOA_DEFINE(particle_soa, _____Particle, PARTICLE_FIELDS)
+
+TEST_CASE("SoA Push and Get", "[soa macro]") {
+    particle_soa soa = particle_soa_new(0);
+    REQUIRE(soa.len == 0);
+    REQUIRE(soa.capacity == 0);
+    REQUIRE(soa.x == nullptr);
+
+    for (int i = 0; i < 100; i++) {
+        particle_soa_push(&soa, (_____Particle){i, -i, i * 0.5});
+    }
+    REQUIRE(soa.len == 100);
+    REQUIRE(soa.capacity >= 100);
+    for (int i = 0; i < 100; i++) {
+        _____Particle p = particle_soa_get(&soa, i);
+        REQUIRE(p.x == i);
+        REQUIRE(p.y == -i);
+        REQUIRE(p.weight == i * 0.5);
+    }
+
+    // every column is its own aligned array
+    REQUIRE(reinterpret_cast<uintptr_t>(soa.x) % SOA_ALIGNMENT == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(soa.y) % SOA_ALIGNMENT == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(soa.weight) % SOA_ALIGNMENT == 0);
+    double total = 0;
+    for (size_t i = 0; i < soa.len; i++) {
+        total += soa.weight[i];
+    }
+    REQUIRE(total == 2475.0);
+
+    particle_soa_set(&soa, 3, (_____Particle){7, 8, 9.0});
+    REQUIRE(soa.x[3] == 7);
+    REQUIRE(soa.y[3] == 8);
+    REQUIRE(soa.weight[3] == 9.0);
+
+    particle_soa_free(&soa);
+    REQUIRE(soa.len == 0);
+    REQUIRE(soa.x == nullptr);
+}
+
+TEST_CASE("SoA Erase and Swap Remove", "[soa macro]") {
+    particle_soa soa = particle_soa_new(10);
+    REQUIRE(soa.capacity == 10);
+    for (int i = 0; i < 10; i++) {
+        particle_soa_push(&soa, (_____Particle){i, i * 10, (double)i});
+    }
+
+    particle_soa_erase(&soa, 2);
+    REQUIRE(soa.len == 9);
+    REQUIRE(soa.x[2] == 3);
+    REQUIRE(soa.y[2] == 30);
+    REQUIRE(soa.weight[8] == 9.0);
+
+    particle_soa_swap_remove(&soa, 0);
+    REQUIRE(soa.len == 8);
+    REQUIRE(soa.x[0] == 9);
+    REQUIRE(soa.y[0] == 90);
+    REQUIRE(soa.weight[0] == 9.0);
+    REQUIRE(soa.x[1] == 1);
+
+    // removing the last row
+    particle_soa_swap_remove(&soa, 7);
+    particle_soa_erase(&soa, 6);
+    REQUIRE(soa.len == 6);
+    REQUIRE(particle_soa_get(&soa, 5).x == 6);
+
+    particle_soa_reserve(&soa, 1000);
+    REQUIRE(soa.capacity == 1000);
+    REQUIRE(soa.x[0] == 9);
+    REQUIRE(soa.weight[5] == 6.0);
+    particle_soa_free(&soa);
+}
+
+// --- Bit Vectors ---
+TEST_CASE("BitVec Push Get Set", "[bitvec macro]") {
+    BitVec bits = bitvec_new(0);
+    REQUIRE(bitvec_len(&bits) == 0);
+    REQUIRE(bitvec_capacity(&bits) == 0);
+
+    vector<bool> model;
+    for (int i = 0; i < 1000; i++) {
+        bool bit = (i * 7) % 3 == 0;
+        bitvec_push(&bits, bit);
+        model.push_back(bit);
+    }
+    REQUIRE(bitvec_len(&bits) == 1000);
+    REQUIRE(bitvec_capacity(&bits) >= 1000);
+    REQUIRE(reinterpret_cast<uintptr_t>(bits.words) % VECTOR_ALIGNMENT == 0);
+
+    bitvec_set(&bits, 0, false);
+    bitvec_set(&bits, 999, true);
+    model[0] = false;
+    model[999] = true;
+    for (size_t i = 0; i < 1000; i++) {
+        REQUIRE(bitvec_get(&bits, i) == model[i]);
+    }
+
+    size_t ones = 0;
+    for (size_t i = 0; i <= 1000; i++) {
+        REQUIRE(bitvec_rank(&bits, i) == ones);
+        ones += i < 1000 && model[i];
+    }
+    for (size_t begin = 0; begin < 1000; begin += 37) {
+        for (size_t end = begin; end <= 1000; end += 61) {
+            size_t expected = count(model.begin() + begin, model.begin() + end, true);
+            REQUIRE(bitvec_popcount(&bits, begin, end) == expected);
+        }
+    }
+
+    bitvec_resize(&bits, 5000);
+    REQUIRE(bitvec_capacity(&bits) >= 5000);
+    REQUIRE(bitvec_get(&bits, 999));
+
+    bitvec_clear(&bits);
+    REQUIRE(bitvec_len(&bits) == 0);
+    bitvec_push(&bits, false);
+    REQUIRE(bitvec_popcount(&bits, 0, 1) == 0);
+    bitvec_destroy(&bits);
+    REQUIRE(bits.words == nullptr);
+}
+
+TEST_CASE("BitVec And Or Xor", "[bitvec macro]") {
+    const size_t n = 700;
+    BitVec a = bitvec_new(n);
+    BitVec b = bitvec_new(n);
+    for (size_t i = 0; i < n; i++) {
+        bitvec_push(&a, i % 3 == 0);
+        bitvec_push(&b, i % 5 == 0);
+    }
+
+    size_t ranges[][2] = {{0, n}, {3, 10}, {64, 128}, {5, 650}, {100, 100}};
+    for (auto& r : ranges) {
+        BitVec x = bitvec_new(0);
+        BitVec y = bitvec_new(0);
+        BitVec z = bitvec_new(0);
+        for (size_t i = 0; i < n; i++) {
+            bitvec_push(&x, bitvec_get(&a, i));
+            bitvec_push(&y, bitvec_get(&a, i));
+            bitvec_push(&z, bitvec_get(&a, i));
+        }
+        bitvec_and(&x, &b, r[0], r[1]);
+        bitvec_or(&y, &b, r[0], r[1]);
+        bitvec_xor(&z, &b, r[0], r[1]);
+        for (size_t i = 0; i < n; i++) {
+            bool in = i >= r[0] && i < r[1];
+            bool p = i % 3 == 0;
+            bool q = i % 5 == 0;
+            REQUIRE(bitvec_get(&x, i) == (in ? p && q : p));
+            REQUIRE(bitvec_get(&y, i) == (in ? p || q : p));
+            REQUIRE(bitvec_get(&z, i) == (in ? p != q : p));
+        }
+        bitvec_destroy(&x);
+        bitvec_destroy(&y);
+        bitvec_destroy(&z);
+    }
+
+    // with itself, xor clears the range
+    bitvec_xor(&a, &a, 0, n);
+    REQUIRE(bitvec_popcount(&a, 0, n) == 0);
+    bitvec_destroy(&a);
+    bitvec_destroy(&b);
+}
+
+TEST_CASE("PackedVec Widths", "[bitvec macro]") {
+    for (unsigned width = 1; width <= PACKVEC_MAX_WIDTH; width++) {
+        PackedVec v = packvec_new(width, 10);
+        REQUIRE(packvec_capacity(&v) >= 10);
+        uint64_t mask = (uint64_t{1} << width) - 1;
+        vector<uint32_t> model;
+        for (uint64_t i = 0; i < 300; i++) {
+            uint32_t value = static_cast<uint32_t>((i * 2654435761U) & mask);
+            packvec_push(&v, value);
+            model.push_back(value);
+        }
+        REQUIRE(packvec_len(&v) == 300);
+        packvec_set(&v, 17, static_cast<uint32_t>(mask));
+        model[17] = static_cast<uint32_t>(mask);
+        for (size_t i = 0; i < 300; i++) {
+            REQUIRE(packvec_get(&v, i) == model[i]);
+        }
+
+        size_t bits = 0;
+        for (size_t i = 20; i < 250; i++) {
+            bits += static_cast<size_t>(__builtin_popcount(model[i]));
+        }
+        REQUIRE(packvec_popcount(&v, 20, 250) == bits);
+
+        for (uint32_t value : {model[0], model[17], uint32_t{0}}) {
+            for (size_t index : {size_t{0}, size_t{1}, size_t{64}, size_t{299}, size_t{300}}) {
+                size_t expected = count(model.begin(), model.begin() + index, value);
+                REQUIRE(packvec_rank(&v, index, value) == expected);
+            }
+        }
+
+        packvec_clear(&v);
+        REQUIRE(packvec_len(&v) == 0);
+        packvec_destroy(&v);
+    }
+}
+
+// --- Vector Files ---
+TEST_CASE("Save and Load a Vector", "[file macro]") {
+    char path[] = "/tmp/test_vector_file_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+
+    vector(_____Point) vec = vector_new(_____Point, 0, NULL);
+    for (int i = 0; i < 5000; i++) {
+        vector_push(&vec, (_____Point){i, -i});
+    }
+    REQUIRE(vector_save(&vec, path));
+
+    vector(_____Point) loaded = NULL;
+    REQUIRE(vector_load(&loaded, path));
+    REQUIRE(loaded != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(loaded) % VECTOR_ALIGNMENT == 0);
+    REQUIRE(vector_len(&loaded) == 5000);
+    REQUIRE(vector_capacity(&loaded) == 5000);
+    for (int i = 0; i < 5000; i++) {
+        REQUIRE(vector_get(&loaded, i).x == i);
+        REQUIRE(loaded[i].y == -i);
+    }
+    REQUIRE(vector_file_verify(loaded));
+
+    // saving over the file leaves the loaded vector intact
+    vector_set(&vec, 0, ((_____Point){7, 7}));
+    REQUIRE(vector_save(&vec, path));
+    REQUIRE(loaded[0].x == 0);
+    vector(_____Point) reloaded = NULL;
+    REQUIRE(vector_load(&reloaded, path));
+    REQUIRE(reloaded[0].x == 7);
+
+    vector_free(&loaded);
+    REQUIRE(loaded == nullptr);
+    vector_free(&reloaded);
+    vector_free(&vec);
+    unlink(path);
+}
+
+TEST_CASE("Load Rejects Bad Files", "[file macro]") {
+    char path[] = "/tmp/test_vector_file_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    close(fd);
+
+    vector(int) loaded = NULL;
+    errno = 0;
+    REQUIRE_FALSE(vector_load(&loaded, path));  // empty file
+    REQUIRE(errno == EINVAL);
+
+    vector(int) empty = NULL;
+    REQUIRE(vector_save(&empty, path));
+    REQUIRE(vector_load(&loaded, path));
+    REQUIRE(vector_len(&loaded) == 0);
+    REQUIRE(vector_file_verify(loaded));
+    vector_free(&loaded);
+
+    vector(int) ints = vector_new(int, 0, NULL);
+    for (int i = 0; i < 100; i++) {
+        vector_push(&ints, i);
+    }
+    REQUIRE(vector_save(&ints, path));
+
+    // a different element type
+    vector(double) doubles = NULL;
+    REQUIRE_FALSE(vector_load(&doubles, path));
+    REQUIRE(errno == EINVAL);
+    REQUIRE(doubles == nullptr);
+
+    // a flipped element byte is only caught by verify
+    fd = open(path, O_WRONLY);
+    REQUIRE(fd >= 0);
+    unsigned char junk = 0xff;
+    REQUIRE(pwrite(fd, &junk, 1, VECTOR_FILE_DATA_OFFSET + 40) == 1);
+    close(fd);
+    REQUIRE(vector_load(&loaded, path));
+    REQUIRE_FALSE(vector_file_verify(loaded));
+    vector_free(&loaded);
+
+    // a truncated file
+    REQUIRE(truncate(path, VECTOR_FILE_DATA_OFFSET + 10) == 0);
+    REQUIRE_FALSE(vector_load(&loaded, path));
+
+    unlink(path);
+    errno = 0;
+    REQUIRE_FALSE(vector_load(&loaded, path));
+    REQUIRE(errno == ENOENT);
+    REQUIRE(loaded == nullptr);
+    vector_free(&ints);
+}
+
+TEST_CASE("Concurrent Saves to One Path", "[file macro]") {
+    char dir[] = "/tmp/test_vector_file_XXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    std::string path = std::string(dir) + "/saved.vec";
+
+    // every writer saves its own value over and over, a file that mixes
+    // two writers would fail verify or hold more than one value
+    const int writers = 4;
+    pid_t pids[writers];
+    for (int w = 0; w < writers; w++) {
+        pids[w] = fork();
+        REQUIRE(pids[w] >= 0);
+        if (pids[w] == 0) {
+            vector(int) vec = vector_new(int, 0, NULL);
+            int* elems = vector_push_n_uninit(&vec, 1 << 18);
+            std::fill(elems, elems + vector_len(&vec), w);
+            bool ok = true;
+            for (int round = 0; round < 20; round++) {
+                ok = vector_save(&vec, path.c_str()) && ok;
+            }
+            _exit(ok ? 0 : 1);
+        }
+    }
+    for (int w = 0; w < writers; w++) {
+        int status = 0;
+        REQUIRE(waitpid(pids[w], &status, 0) == pids[w]);
+        REQUIRE(WIFEXITED(status));
+        REQUIRE(WEXITSTATUS(status) == 0);
+    }
+
+    vector(int) loaded = NULL;
+    REQUIRE(vector_load(&loaded, path.c_str()));
+    REQUIRE(vector_len(&loaded) == (1 << 18));
+    REQUIRE(vector_file_verify(loaded));
+    REQUIRE(std::count(loaded, loaded + vector_len(&loaded), loaded[0]) ==
+            (1 << 18));
+    vector_free(&loaded);
+
+    // no temporary files are left behind
+    DIR* entries = opendir(dir);
+    REQUIRE(entries != nullptr);
+    int files = 0;
+    for (struct dirent* e = readdir(entries); e != nullptr;
+         e = readdir(entries)) {
+        files += e->d_name[0] != '.';
+    }
+    closedir(entries);
+    REQUIRE(files == 1);
+
+    unlink(path.c_str());
+    rmdir(dir);
+}
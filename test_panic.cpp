@@ -7,6 +7,11 @@
 
 extern "C" {
   #include "./Vec.h"
+  #include "./concurrent_vec.h"
+  #include "./tree_vec.h"
+  #include "./soa.h"
+  #include "./delta_vec.h"
+  #include "./disk_vec.h"
 }
 
 using namespace std;
@@ -111,3 +116,136 @@ TEST_CASE("Panic on Access After Clear", "[panic]") {
   REQUIRE(check_panics(vec_set, &v, 0, kTwo)); 
   vec_destroy(&v);
 }
+
+TEST_CASE("Panic on Small Vec Out of Bounds", "[panic]") {
+  SmallVec v = svec_new(nullptr);
+  svec_push_back(&v, kOne);
+
+  REQUIRE(check_panics(svec_get, &v, 1));
+  REQUIRE(check_panics(svec_set, &v, 1, kTwo));
+  svec_destroy(&v);
+}
+
+TEST_CASE("Panic on Range Out of Bounds", "[panic]") {
+  ptr_t elems[] = {kOne, kTwo};
+  Vec v = vec_new(3, nullptr);
+  vec_extend(&v, elems, 2);
+
+  REQUIRE(check_panics(vec_insert_range, &v, 3, elems, 2));
+  REQUIRE(check_panics(vec_erase_range, &v, 1, 2));
+  REQUIRE(check_panics(vec_erase_range, &v, 3, 0));
+  REQUIRE(check_panics(vec_erase_range, &v, 1, SIZE_MAX));
+  vec_destroy(&v);
+}
+
+TEST_CASE("Panic on Deque Out of Bounds", "[panic]") {
+  VecDeque d = vdq_new(4, nullptr);
+  vdq_push_back(&d, kOne);
+  vdq_push_front(&d, kTwo);
+
+  REQUIRE(check_panics(vdq_get, &d, 2));
+  REQUIRE(check_panics(vdq_set, &d, 2, kThree));
+  vdq_destroy(&d);
+}
+
+TEST_CASE("Panic on Swap Remove Out of Bounds", "[panic]") {
+  Vec v = vec_new(3, nullptr);
+  vec_push_back(&v, kOne);
+
+  REQUIRE(check_panics(vec_swap_remove, &v, 1));
+  vec_destroy(&v);
+}
+
+TEST_CASE("Panic on Concurrent Vec Out of Bounds", "[panic]") {
+  ConcurrentVec* cv = cvec_new(0, nullptr);
+  cvec_reserve(cv, 100);  // allocated slots are still out of bounds
+  cvec_push_back(cv, kOne);
+  REQUIRE(check_panics(cvec_get, cv, 1));
+  REQUIRE(check_panics(cvec_get, cv, 50));
+  REQUIRE(check_panics(cvec_extend, cv, static_cast<const ptr_t*>(nullptr),
+                       SIZE_MAX));
+  cvec_destroy(cv);
+}
+
+TEST_CASE("Panic on SegVec Out of Bounds", "[panic]") {
+  SegVec v = segvec_new(16, nullptr);
+  segvec_push_back(&v, kOne);
+
+  REQUIRE(check_panics(segvec_get, &v, 1));
+  REQUIRE(check_panics(segvec_at, &v, 15));
+  REQUIRE(check_panics(segvec_set, &v, 1, kTwo));
+  segvec_destroy(&v);
+}
+
+TEST_CASE("Panic on GapBuf Out of Bounds", "[panic]") {
+  GapBuf b = gbuf_new(16, nullptr);
+  gbuf_insert(&b, kOne);
+
+  REQUIRE(check_panics(gbuf_get, &b, 1));
+  REQUIRE(check_panics(gbuf_set, &b, 1, kTwo));
+  REQUIRE(check_panics(gbuf_move_to, &b, 2));
+  gbuf_destroy(&b);
+}
+
+TEST_CASE("Panic on TreeVec Out of Bounds", "[panic]") {
+  TreeVec* t = tvec_new(nullptr);
+  REQUIRE(check_panics(tvec_get, t, 0));
+  REQUIRE(check_panics(tvec_erase, t, 0));
+  tvec_push_back(t, kOne);
+
+  REQUIRE(check_panics(tvec_get, t, 1));
+  REQUIRE(check_panics(tvec_set, t, 1, kTwo));
+  REQUIRE(check_panics(tvec_insert, t, 2, kTwo));
+  REQUIRE(check_panics(tvec_erase, t, 1));
+  REQUIRE(check_panics(tvec_iter, t, 2));
+  tvec_destroy(t);
+}
+
+typedef struct {
+  int key;
+  double value;
+} KeyValue;
+
+#define KEY_VALUE_FIELDS(F) F(int, key) F(double, value)
+SOA_DECLARE(kv_soa, KeyValue, KEY_VALUE_FIELDS)
+SOA_DEFINE(kv_soa, KeyValue, KEY_VALUE_FIELDS)
+
+TEST_CASE("Panic on SoA Out of Bounds", "[panic]") {
+  kv_soa soa = kv_soa_new(0);
+  REQUIRE(check_panics(kv_soa_get, &soa, 0));
+  REQUIRE(check_panics(kv_soa_erase, &soa, 0));
+  kv_soa_push(&soa, KeyValue{1, 1.0});
+
+  REQUIRE(check_panics(kv_soa_get, &soa, 1));
+  REQUIRE(check_panics(kv_soa_set, &soa, 1, KeyValue{2, 2.0}));
+  REQUIRE(check_panics(kv_soa_erase, &soa, 1));
+  REQUIRE(check_panics(kv_soa_swap_remove, &soa, 1));
+  kv_soa_free(&soa);
+}
+
+TEST_CASE("Panic on DeltaVec Out of Bounds", "[panic]") {
+  DeltaVec* d = dvec_new();
+  int64_t out[2];
+  REQUIRE(check_panics(dvec_get, d, 0));
+  REQUIRE(check_panics(dvec_decode, d, 0, 1, out));
+  for (int64_t i = 0; i < DVEC_BLOCK_LEN + 1; i++) {
+    dvec_push_back(d, i);
+  }
+
+  REQUIRE(check_panics(dvec_get, d, DVEC_BLOCK_LEN + 1));
+  REQUIRE(check_panics(dvec_decode, d, DVEC_BLOCK_LEN, 2, out));
+  REQUIRE(check_panics(dvec_decode, d, DVEC_BLOCK_LEN + 2, 0, out));
+  dvec_destroy(d);
+}
+
+TEST_CASE("Panic on DiskVec Out of Bounds", "[panic]") {
+  DiskVec* d = diskvec_new(nullptr, 0, nullptr);
+  REQUIRE(check_panics(diskvec_get, d, 0));
+  diskvec_push_back(d, kOne);
+
+  REQUIRE(check_panics(diskvec_get, d, 1));
+  REQUIRE(check_panics(diskvec_at, d, 1));
+  REQUIRE(check_panics(diskvec_set, d, 1, kTwo));
+  REQUIRE(check_panics(diskvec_new, "/nonexistent/dir", 0, nullptr));
+  diskvec_destroy(d);
+}
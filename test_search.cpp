@@ -0,0 +1,82 @@
+#include "catch.hpp"
+#include <stdint.h>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./vec_search.h"
+}
+
+using namespace std;
+
+static ptr_t value(uintptr_t x) {
+  return reinterpret_cast<ptr_t>(x);
+}
+
+// Runs the checks once per kernel available on this machine.
+static void for_each_kernel(void (*check)()) {
+  for (vec_search_kernel kernel :
+       {VEC_SEARCH_SCALAR, VEC_SEARCH_SSE2, VEC_SEARCH_AVX2}) {
+    if (vec_search_use(kernel)) {
+      INFO("kernel " << kernel);
+      REQUIRE(vec_search_active() == kernel);
+      check();
+    }
+  }
+  REQUIRE(vec_search_use(VEC_SEARCH_AUTO));
+  REQUIRE(vec_search_active() != VEC_SEARCH_AUTO);
+}
+
+TEST_CASE("Search Empty Vec", "[search]") {
+  for_each_kernel([] {
+    Vec v = vec_new(0, nullptr);
+    REQUIRE(vec_find(&v, nullptr) == VEC_NOT_FOUND);
+    REQUIRE(vec_rfind(&v, nullptr) == VEC_NOT_FOUND);
+    REQUIRE_FALSE(vec_contains(&v, nullptr));
+    REQUIRE(vec_count_eq(&v, nullptr) == 0);
+    vec_destroy(&v);
+  });
+}
+
+TEST_CASE("Search Every Position and Length", "[search]") {
+  // lengths around the block sizes, needle at every position, so both the
+  // vector loops and the scalar tails are covered
+  for_each_kernel([] {
+    for (uintptr_t n = 1; n <= 40; n++) {
+      Vec v = vec_new(n, nullptr);
+      for (uintptr_t i = 0; i < n; i++) {
+        vec_push_back(&v, value(i + 1));
+      }
+      for (uintptr_t i = 0; i < n; i++) {
+        REQUIRE(vec_find(&v, value(i + 1)) == i);
+        REQUIRE(vec_rfind(&v, value(i + 1)) == i);
+        REQUIRE(vec_count_eq(&v, value(i + 1)) == 1);
+      }
+      REQUIRE(vec_find(&v, value(0)) == VEC_NOT_FOUND);
+      REQUIRE(vec_rfind(&v, value(n + 1)) == VEC_NOT_FOUND);
+      REQUIRE(vec_count_eq(&v, nullptr) == 0);
+      vec_destroy(&v);
+    }
+  });
+}
+
+TEST_CASE("Search Duplicates and Half Matches", "[search]") {
+  for_each_kernel([] {
+    Vec v = vec_new(0, nullptr);
+    for (uintptr_t i = 0; i < 1000; i++) {
+      vec_push_back(&v, value(i % 7));
+    }
+    REQUIRE(vec_find(&v, value(3)) == 3);
+    REQUIRE(vec_rfind(&v, value(3)) == 997);
+    REQUIRE(vec_count_eq(&v, value(3)) == 143);
+    REQUIRE(vec_count_eq(&v, value(6)) == 142);
+    REQUIRE(vec_contains(&v, value(0)));
+
+    // equal low 32 bits or equal high 32 bits alone must not match
+    vec_push_back(&v, value(0x100000003ULL));
+    vec_push_back(&v, value(0x500000000ULL));
+    REQUIRE(vec_count_eq(&v, value(3)) == 143);
+    REQUIRE(vec_find(&v, value(0x500000003ULL)) == VEC_NOT_FOUND);
+    REQUIRE(vec_find(&v, value(0x100000003ULL)) == 1000);
+    vec_destroy(&v);
+  });
+}
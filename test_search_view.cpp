@@ -0,0 +1,105 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./search_view.h"
+}
+
+using namespace std;
+
+static int cmp_intptr(ptr_t a, ptr_t b, [[maybe_unused]] void* ctx) {
+  intptr_t x = reinterpret_cast<intptr_t>(a);
+  intptr_t y = reinterpret_cast<intptr_t>(b);
+  return (x > y) - (x < y);
+}
+
+// Sorted keys with duplicates and gaps, so there are keys to miss.
+static vector<intptr_t> sorted_keys(size_t n) {
+  mt19937_64 rng(n);
+  vector<intptr_t> keys;
+  for (size_t i = 0; i < n; i++) {
+    keys.push_back(static_cast<intptr_t>(rng() % (n * 3 + 1)) - static_cast<intptr_t>(n));
+  }
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+static Vec vec_from(const vector<intptr_t>& keys) {
+  Vec v = vec_new(keys.size(), nullptr);
+  for (intptr_t key : keys) {
+    vec_push_back(&v, reinterpret_cast<ptr_t>(key));
+  }
+  return v;
+}
+
+// sizes around full trees of both layouts (2^k - 1 and 8 * 9^k)
+static const size_t kSizes[] = {0, 1, 2, 7, 8, 9, 15, 16, 17, 72, 73, 100, 647, 648, 1000, 5833};
+
+TEST_CASE("Eytzinger View Finds Every Key", "[search view]") {
+  for (size_t n : kSizes) {
+    vector<intptr_t> keys = sorted_keys(n);
+    Vec v = vec_from(keys);
+    EytzView* view = eytz_from_vec(&v, cmp_intptr, nullptr);
+
+    intptr_t lo = keys.empty() ? 0 : keys.front() - 2;
+    intptr_t hi = keys.empty() ? 0 : keys.back() + 2;
+    for (intptr_t key = lo; key <= hi; key++) {
+      ptr_t found = nullptr;
+      bool expected = std::binary_search(keys.begin(), keys.end(), key);
+      REQUIRE(eytz_find(view, reinterpret_cast<ptr_t>(key), &found) == expected);
+      if (expected) {
+        REQUIRE(reinterpret_cast<intptr_t>(found) == key);
+      }
+    }
+    eytz_destroy(view);
+    vec_destroy(&v);
+  }
+}
+
+TEST_CASE("B+ Tree View Lower Bound and Find", "[search view]") {
+  for (size_t n : kSizes) {
+    vector<intptr_t> keys = sorted_keys(n);
+    Vec v = vec_from(keys);
+    BTreeView* view = btv_from_vec(&v);
+
+    intptr_t lo = keys.empty() ? 0 : keys.front() - 2;
+    intptr_t hi = keys.empty() ? 0 : keys.back() + 2;
+    for (intptr_t key = lo; key <= hi; key++) {
+      size_t lower = static_cast<size_t>(
+          std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+      REQUIRE(btv_lower_bound(view, key) == lower);
+      bool present = lower < n && keys[lower] == key;
+      REQUIRE(btv_find(view, key) == (present ? lower : VEC_NOT_FOUND));
+    }
+    btv_destroy(view);
+    vec_destroy(&v);
+  }
+}
+
+TEST_CASE("B+ Tree View Extreme Keys", "[search view]") {
+  vector<intptr_t> keys = {INTPTR_MIN, -1, 0, 1, INTPTR_MAX, INTPTR_MAX};
+  BTreeView* view = btv_new(keys.data(), keys.size());
+  REQUIRE(btv_find(view, INTPTR_MIN) == 0);
+  REQUIRE(btv_find(view, INTPTR_MAX) == 4);
+  REQUIRE(btv_lower_bound(view, 2) == 4);
+  REQUIRE(btv_find(view, 2) == VEC_NOT_FOUND);
+  btv_destroy(view);
+}
+
+TEST_CASE("Eytzinger View of a Raw Array", "[search view]") {
+  vector<ptr_t> sorted;
+  for (intptr_t i = 0; i < 1000; i++) {
+    sorted.push_back(reinterpret_cast<ptr_t>(i * 2));
+  }
+  EytzView* view = eytz_new(sorted.data(), sorted.size(), cmp_intptr, nullptr);
+  ptr_t found = nullptr;
+  REQUIRE(eytz_find(view, reinterpret_cast<ptr_t>(500), &found));
+  REQUIRE(reinterpret_cast<intptr_t>(found) == 500);
+  REQUIRE_FALSE(eytz_find(view, reinterpret_cast<ptr_t>(501), &found));
+  REQUIRE_FALSE(eytz_find(view, reinterpret_cast<ptr_t>(-1), &found));
+  eytz_destroy(view);
+}
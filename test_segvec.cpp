@@ -0,0 +1,120 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+}
+
+using namespace std;
+
+static ptr_t kOne   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(1U)));
+static ptr_t kTwo   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(2U)));
+
+static uintptr_t counter = 0;
+static int invocations = 0;
+
+static void count_constants(ptr_t input) {
+  counter += reinterpret_cast<uintptr_t>(input);
+  invocations += 1;
+}
+
+TEST_CASE("SegVec Construction", "[segvec]") {
+  SegVec empty = segvec_new(0, nullptr);
+  REQUIRE(segvec_capacity(&empty) == 0);
+  REQUIRE(empty.num_segments == 0);
+  REQUIRE(segvec_is_empty(&empty));
+  segvec_destroy(&empty);
+
+  // 8 + 16 + 32 is the first sum of segments reaching 50
+  SegVec v = segvec_new(50, nullptr);
+  REQUIRE(v.num_segments == 3);
+  REQUIRE(segvec_capacity(&v) == 56);
+  REQUIRE(segvec_len(&v) == 0);
+  segvec_destroy(&v);
+  REQUIRE(segvec_capacity(&v) == 0);
+  REQUIRE(v.segments[0] == nullptr);
+}
+
+TEST_CASE("SegVec Segment Boundaries", "[segvec]") {
+  SegVec v = segvec_new(0, nullptr);
+  for (uintptr_t i = 0; i < 1000; i++) {
+    segvec_push_back(&v, reinterpret_cast<ptr_t>(i));
+    REQUIRE(segvec_len(&v) == i + 1);
+  }
+  // 8 + 16 + ... + 512 = 1016
+  REQUIRE(v.num_segments == 7);
+  REQUIRE(segvec_capacity(&v) == 1016);
+
+  // the first and last slot of each segment
+  REQUIRE(segvec_at(&v, 0) == &v.segments[0][0]);
+  REQUIRE(segvec_at(&v, 7) == &v.segments[0][7]);
+  REQUIRE(segvec_at(&v, 8) == &v.segments[1][0]);
+  REQUIRE(segvec_at(&v, 23) == &v.segments[1][15]);
+  REQUIRE(segvec_at(&v, 24) == &v.segments[2][0]);
+  REQUIRE(segvec_at(&v, 504) == &v.segments[6][0]);
+
+  for (uintptr_t i = 0; i < 1000; i++) {
+    REQUIRE(reinterpret_cast<uintptr_t>(segvec_get(&v, i)) == i);
+  }
+  segvec_destroy(&v);
+}
+
+TEST_CASE("SegVec Addresses are Stable Across Growth", "[segvec]") {
+  SegVec v = segvec_new(0, nullptr);
+  vector<ptr_t*> addresses;
+  for (uintptr_t i = 0; i < 5000; i++) {
+    segvec_push_back(&v, reinterpret_cast<ptr_t>(i));
+    addresses.push_back(segvec_at(&v, i));
+  }
+  for (uintptr_t i = 0; i < 5000; i++) {
+    REQUIRE(segvec_at(&v, i) == addresses[i]);
+    REQUIRE(reinterpret_cast<uintptr_t>(*addresses[i]) == i);
+  }
+
+  // writes through a saved address are seen by segvec_get
+  *addresses[100] = kTwo;
+  REQUIRE(segvec_get(&v, 100) == kTwo);
+  segvec_destroy(&v);
+}
+
+TEST_CASE("SegVec Set Pop Clear with Dtor", "[segvec]") {
+  counter = 0;
+  invocations = 0;
+  SegVec v = segvec_new(0, count_constants);
+  for (int i = 0; i < 30; i++) {
+    segvec_push_back(&v, kOne);
+  }
+
+  segvec_set(&v, 29, kTwo);
+  REQUIRE(invocations == 1);
+  REQUIRE(segvec_pop_back(&v));
+  REQUIRE(counter == 3);
+  REQUIRE(invocations == 2);
+  REQUIRE(segvec_len(&v) == 29);
+  REQUIRE(segvec_capacity(&v) == 56);
+
+  // clear spans the first three segments
+  segvec_clear(&v);
+  REQUIRE(invocations == 31);
+  REQUIRE(counter == 32);
+  REQUIRE(segvec_capacity(&v) == 56);
+  REQUIRE_FALSE(segvec_pop_back(&v));
+
+  segvec_push_back(&v, kTwo);
+  segvec_destroy(&v);
+  REQUIRE(invocations == 32);
+  REQUIRE(counter == 34);
+}
+
+TEST_CASE("SegVec of Heap Elements", "[segvec]") {
+  SegVec v = segvec_new(0, free);
+  for (int i = 0; i < 2000; i++) {
+    segvec_push_back(&v, malloc(16));
+  }
+  segvec_reserve(&v, 100000);
+  REQUIRE(segvec_capacity(&v) >= 100000);
+  REQUIRE(segvec_len(&v) == 2000);
+  segvec_destroy(&v);
+}
@@ -0,0 +1,239 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./vec_sort.h"
+}
+
+using namespace std;
+
+static int cmp_intptr(ptr_t a, ptr_t b, [[maybe_unused]] void* ctx) {
+  intptr_t x = reinterpret_cast<intptr_t>(a);
+  intptr_t y = reinterpret_cast<intptr_t>(b);
+  return (x > y) - (x < y);
+}
+
+static int cmp_strings(ptr_t a, ptr_t b, [[maybe_unused]] void* ctx) {
+  return strcmp(static_cast<char*>(a), static_cast<char*>(b));
+}
+
+// Sorts descending when ctx points to true, to check ctx is passed through.
+static int cmp_maybe_reversed(ptr_t a, ptr_t b, void* ctx) {
+  int order = cmp_intptr(a, b, nullptr);
+  return *static_cast<bool*>(ctx) ? -order : order;
+}
+
+static Vec vec_from(const vector<intptr_t>& values) {
+  Vec v = vec_new(values.size(), nullptr);
+  for (intptr_t value : values) {
+    vec_push_back(&v, reinterpret_cast<ptr_t>(value));
+  }
+  return v;
+}
+
+static void require_matches(Vec* v, vector<intptr_t> expected) {
+  sort(expected.begin(), expected.end());
+  REQUIRE(v->length == expected.size());
+  for (size_t i = 0; i < v->length; i++) {
+    REQUIRE(reinterpret_cast<intptr_t>(vec_get(v, i)) == expected[i]);
+  }
+}
+
+// Inputs that tend to break quicksorts: sorted, reversed, all equal, few
+// distinct values, organ pipe, plus random with negatives.
+static vector<vector<intptr_t>> sort_inputs(size_t n) {
+  mt19937_64 rng(n);
+  vector<vector<intptr_t>> inputs(6, vector<intptr_t>(n));
+  for (size_t i = 0; i < n; i++) {
+    inputs[0][i] = static_cast<intptr_t>(i);
+    inputs[1][i] = static_cast<intptr_t>(n - i);
+    inputs[2][i] = 7;
+    inputs[3][i] = static_cast<intptr_t>(rng() % 3) - 1;
+    inputs[4][i] = static_cast<intptr_t>(i < n / 2 ? i : n - i);
+    inputs[5][i] = static_cast<intptr_t>(rng());
+  }
+  return inputs;
+}
+
+TEST_CASE("Sort Empty and Tiny Vecs", "[sort]") {
+  Vec v = vec_new(0, nullptr);
+  vec_sort(&v, cmp_intptr, nullptr);
+  vec_par_sort(&v, cmp_intptr, nullptr, 4);
+  vec_sort_intptr(&v);
+  REQUIRE(v.length == 0);
+
+  vec_push_back(&v, reinterpret_cast<ptr_t>(2));
+  vec_push_back(&v, reinterpret_cast<ptr_t>(-1));
+  vec_sort(&v, cmp_intptr, nullptr);
+  require_matches(&v, {2, -1});
+  vec_destroy(&v);
+}
+
+TEST_CASE("vec_sort", "[sort]") {
+  for (size_t n : {17UL, 100UL, 5000UL}) {
+    for (const vector<intptr_t>& input : sort_inputs(n)) {
+      Vec v = vec_from(input);
+      vec_sort(&v, cmp_intptr, nullptr);
+      require_matches(&v, input);
+      vec_destroy(&v);
+    }
+  }
+}
+
+TEST_CASE("vec_sort Passes ctx and Sorts Strings", "[sort]") {
+  bool reversed = true;
+  Vec v = vec_from({3, 1, 2, 5, 4});
+  vec_sort(&v, cmp_maybe_reversed, &reversed);
+  REQUIRE(reinterpret_cast<intptr_t>(vec_get(&v, 0)) == 5);
+  REQUIRE(reinterpret_cast<intptr_t>(vec_get(&v, 4)) == 1);
+  vec_destroy(&v);
+
+  Vec words = vec_new(0, free);
+  for (const char* word : {"pear", "apple", "fig", "banana", "cherry"}) {
+    vec_push_back(&words, strdup(word));
+  }
+  vec_sort(&words, cmp_strings, nullptr);
+  REQUIRE(strcmp(static_cast<char*>(vec_get(&words, 0)), "apple") == 0);
+  REQUIRE(strcmp(static_cast<char*>(vec_get(&words, 4)), "pear") == 0);
+  vec_destroy(&words);
+}
+
+TEST_CASE("vec_par_sort", "[sort]") {
+  // long enough to be split into several runs
+  size_t n = VEC_PAR_SORT_MIN_LENGTH * 8 + 3;
+  for (size_t threads : {0UL, 1UL, 3UL, 8UL}) {
+    for (const vector<intptr_t>& input : sort_inputs(n)) {
+      Vec v = vec_from(input);
+      vec_par_sort(&v, cmp_intptr, nullptr, threads);
+      require_matches(&v, input);
+      vec_destroy(&v);
+    }
+  }
+}
+
+TEST_CASE("vec_sort_intptr", "[sort]") {
+  for (size_t n : {2UL, 100UL, 100000UL}) {
+    for (const vector<intptr_t>& input : sort_inputs(n)) {
+      Vec v = vec_from(input);
+      vec_sort_intptr(&v);
+      require_matches(&v, input);
+      vec_destroy(&v);
+    }
+  }
+
+  Vec extremes = vec_from({INTPTR_MAX, 0, INTPTR_MIN, -1, 1});
+  vec_sort_intptr(&extremes);
+  require_matches(&extremes, {INTPTR_MAX, 0, INTPTR_MIN, -1, 1});
+  vec_destroy(&extremes);
+}
+
+// Orders pairs by their first member only, so ties can be told apart.
+typedef struct {
+  intptr_t key;
+  intptr_t tag;
+} tagged;
+
+static int cmp_tagged(ptr_t a, ptr_t b, [[maybe_unused]] void* ctx) {
+  return cmp_intptr(reinterpret_cast<ptr_t>(static_cast<tagged*>(a)->key),
+                    reinterpret_cast<ptr_t>(static_cast<tagged*>(b)->key),
+                    nullptr);
+}
+
+TEST_CASE("Lower and Upper Bound", "[sorted]") {
+  Vec empty = vec_new(0, nullptr);
+  REQUIRE(vec_lower_bound(&empty, reinterpret_cast<ptr_t>(1), cmp_intptr, nullptr) == 0);
+  REQUIRE(vec_upper_bound(&empty, reinterpret_cast<ptr_t>(1), cmp_intptr, nullptr) == 0);
+  vec_destroy(&empty);
+
+  // every length up to 20 and every key in and around the values, checked
+  // against std::lower_bound / std::upper_bound
+  for (size_t n = 1; n <= 20; n++) {
+    vector<intptr_t> values;
+    for (size_t i = 0; i < n; i++) {
+      values.push_back(static_cast<intptr_t>(i / 3 * 2));  // runs of 3
+    }
+    Vec v = vec_from(values);
+    for (intptr_t key = -1; key <= values.back() + 1; key++) {
+      ptr_t k = reinterpret_cast<ptr_t>(key);
+      size_t lower = static_cast<size_t>(
+          std::lower_bound(values.begin(), values.end(), key) - values.begin());
+      size_t upper = static_cast<size_t>(
+          std::upper_bound(values.begin(), values.end(), key) - values.begin());
+      REQUIRE(vec_lower_bound(&v, k, cmp_intptr, nullptr) == lower);
+      REQUIRE(vec_upper_bound(&v, k, cmp_intptr, nullptr) == upper);
+    }
+    vec_destroy(&v);
+  }
+}
+
+TEST_CASE("Sorted Insert", "[sorted]") {
+  Vec v = vec_new(0, nullptr);
+  vector<intptr_t> inserted;
+  mt19937_64 rng(42);
+  for (int i = 0; i < 500; i++) {
+    intptr_t value = static_cast<intptr_t>(rng() % 100) - 50;
+    size_t index = vec_sorted_insert(&v, reinterpret_cast<ptr_t>(value), cmp_intptr, nullptr);
+    REQUIRE(reinterpret_cast<intptr_t>(vec_get(&v, index)) == value);
+    inserted.push_back(value);
+  }
+  require_matches(&v, inserted);
+  vec_destroy(&v);
+
+  // ties go after the existing equal elements
+  tagged first = {5, 1};
+  tagged second = {5, 2};
+  tagged smaller = {4, 3};
+  Vec t = vec_new(0, nullptr);
+  REQUIRE(vec_sorted_insert(&t, &first, cmp_tagged, nullptr) == 0);
+  REQUIRE(vec_sorted_insert(&t, &second, cmp_tagged, nullptr) == 1);
+  REQUIRE(vec_sorted_insert(&t, &smaller, cmp_tagged, nullptr) == 0);
+  REQUIRE(vec_get(&t, 1) == &first);
+  REQUIRE(vec_get(&t, 2) == &second);
+  vec_destroy(&t);
+}
+
+TEST_CASE("Sorted Insert Batch", "[sorted]") {
+  mt19937_64 rng(7);
+  for (size_t n : {0UL, 1UL, 10UL, 1000UL}) {
+    for (size_t k : {0UL, 1UL, 5UL, 1000UL, 3000UL}) {
+      vector<intptr_t> values;
+      for (size_t i = 0; i < n; i++) {
+        values.push_back(static_cast<intptr_t>(rng() % 500));
+      }
+      std::sort(values.begin(), values.end());
+      Vec v = vec_from(values);
+
+      vector<ptr_t> batch;
+      for (size_t i = 0; i < k; i++) {
+        intptr_t value = static_cast<intptr_t>(rng() % 600) - 50;
+        batch.push_back(reinterpret_cast<ptr_t>(value));
+        values.push_back(value);
+      }
+      vec_sorted_insert_batch(&v, batch.data(), batch.size(), cmp_intptr, nullptr);
+      require_matches(&v, values);
+      vec_destroy(&v);
+    }
+  }
+
+  // batch elements go after existing equal ones
+  tagged old_a = {1, 0};
+  tagged old_b = {3, 0};
+  tagged new_a = {3, 1};
+  tagged new_b = {0, 1};
+  Vec t = vec_new(0, nullptr);
+  vec_push_back(&t, &old_a);
+  vec_push_back(&t, &old_b);
+  ptr_t batch[] = {&new_a, &new_b};
+  vec_sorted_insert_batch(&t, batch, 2, cmp_tagged, nullptr);
+  REQUIRE(vec_get(&t, 0) == &new_b);
+  REQUIRE(vec_get(&t, 1) == &old_a);
+  REQUIRE(vec_get(&t, 2) == &old_b);
+  REQUIRE(vec_get(&t, 3) == &new_a);
+  vec_destroy(&t);
+}
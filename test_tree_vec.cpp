@@ -0,0 +1,178 @@
+#include "catch.hpp"
+#include <stdint.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+extern "C" {
+  #include "./Vec.h"
+  #include "./tree_vec.h"
+}
+
+using namespace std;
+
+static ptr_t kOne   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(1U)));
+static ptr_t kTwo   = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(2U)));
+static ptr_t kThree = reinterpret_cast<ptr_t>((static_cast<uintptr_t>(3U)));
+
+static uintptr_t counter = 0;
+static int invocations = 0;
+
+static void count_constants(ptr_t input) {
+  counter += reinterpret_cast<uintptr_t>(input);
+  invocations += 1;
+}
+
+static ptr_t as_ptr(uintptr_t value) {
+  return reinterpret_cast<ptr_t>(value);
+}
+
+// Checks every element through both tvec_get and an iterator.
+static void require_contents(TreeVec* t, const vector<ptr_t>& expected) {
+  REQUIRE(tvec_len(t) == expected.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    REQUIRE(tvec_get(t, i) == expected[i]);
+  }
+
+  TreeVecIter it = tvec_iter(t, 0);
+  ptr_t ele = nullptr;
+  size_t visited = 0;
+  while (tvec_iter_next(&it, &ele)) {
+    REQUIRE(ele == expected[visited]);
+    visited++;
+  }
+  REQUIRE(visited == expected.size());
+}
+
+TEST_CASE("TreeVec Basic Operations", "[treevec]") {
+  TreeVec* t = tvec_new(nullptr);
+  REQUIRE(tvec_len(t) == 0);
+  REQUIRE_FALSE(tvec_pop_back(t));
+
+  tvec_push_back(t, kOne);
+  tvec_push_back(t, kThree);
+  tvec_insert(t, 1, kTwo);
+  require_contents(t, {kOne, kTwo, kThree});
+
+  tvec_set(t, 0, kThree);
+  tvec_erase(t, 1);
+  require_contents(t, {kThree, kThree});
+
+  REQUIRE(tvec_pop_back(t));
+  REQUIRE(tvec_pop_back(t));
+  REQUIRE(tvec_len(t) == 0);
+  REQUIRE_FALSE(tvec_pop_back(t));
+
+  // the tree can be refilled after being emptied
+  tvec_insert(t, 0, kTwo);
+  require_contents(t, {kTwo});
+  tvec_destroy(t);
+}
+
+TEST_CASE("TreeVec Many Levels", "[treevec]") {
+  TreeVec* t = tvec_new(nullptr);
+  vector<ptr_t> model;
+  for (uintptr_t i = 0; i < 100000; i++) {
+    tvec_push_back(t, as_ptr(i));
+    model.push_back(as_ptr(i));
+  }
+  require_contents(t, model);
+
+  // insert at the front and in the middle, then erase it all from the front
+  for (uintptr_t i = 0; i < 2000; i++) {
+    tvec_insert(t, 0, as_ptr(200000 + i));
+    model.insert(model.begin(), as_ptr(200000 + i));
+    tvec_insert(t, model.size() / 2, as_ptr(300000 + i));
+    model.insert(model.begin() + static_cast<long>(model.size() / 2),
+                 as_ptr(300000 + i));
+  }
+  require_contents(t, model);
+
+  while (tvec_len(t) > 0) {
+    REQUIRE(tvec_get(t, 0) == model[model.size() - tvec_len(t)]);
+    tvec_erase(t, 0);
+  }
+  tvec_destroy(t);
+}
+
+TEST_CASE("TreeVec Matches a Vector Under Random Edits", "[treevec]") {
+  mt19937 rng(17);
+  TreeVec* t = tvec_new(nullptr);
+  vector<ptr_t> model;
+  uintptr_t next = 0;
+
+  for (int step = 0; step < 60000; step++) {
+    // grow for the first half, shrink for the second
+    unsigned grow = step < 30000 ? 3 : 1;
+    unsigned op = rng() % (grow + 3);
+    if (op < grow || model.empty()) {
+      size_t index = rng() % (model.size() + 1);
+      tvec_insert(t, index, as_ptr(next));
+      model.insert(model.begin() + static_cast<long>(index), as_ptr(next));
+      next++;
+    } else if (op < grow + 2) {
+      size_t index = rng() % model.size();
+      tvec_erase(t, index);
+      model.erase(model.begin() + static_cast<long>(index));
+    } else {
+      size_t index = rng() % model.size();
+      REQUIRE(tvec_get(t, index) == model[index]);
+      tvec_set(t, index, as_ptr(next));
+      model[index] = as_ptr(next++);
+    }
+    REQUIRE(tvec_len(t) == model.size());
+    if (step % 10000 == 0) {
+      require_contents(t, model);
+    }
+  }
+  require_contents(t, model);
+  tvec_destroy(t);
+}
+
+TEST_CASE("TreeVec Iterator From an Index", "[treevec]") {
+  TreeVec* t = tvec_new(nullptr);
+  for (uintptr_t i = 0; i < 1000; i++) {
+    tvec_push_back(t, as_ptr(i));
+  }
+
+  ptr_t ele = nullptr;
+  TreeVecIter it = tvec_iter(t, 995);
+  for (uintptr_t i = 995; i < 1000; i++) {
+    REQUIRE(tvec_iter_next(&it, &ele));
+    REQUIRE(ele == as_ptr(i));
+  }
+  REQUIRE_FALSE(tvec_iter_next(&it, &ele));
+
+  TreeVecIter end = tvec_iter(t, 1000);
+  REQUIRE_FALSE(tvec_iter_next(&end, &ele));
+  tvec_destroy(t);
+}
+
+TEST_CASE("TreeVec Element Destructor", "[treevec]") {
+  counter = 0;
+  invocations = 0;
+  TreeVec* t = tvec_new(count_constants);
+  for (int i = 0; i < 100; i++) {
+    tvec_push_back(t, kOne);
+  }
+  tvec_insert(t, 50, kTwo);
+  REQUIRE(invocations == 0);  // splitting leaves destroys nothing
+
+  tvec_set(t, 50, kThree);
+  REQUIRE(counter == 2);
+  tvec_erase(t, 50);
+  REQUIRE(counter == 5);
+  REQUIRE(tvec_pop_back(t));
+  REQUIRE(counter == 6);
+  REQUIRE(invocations == 3);
+
+  tvec_clear(t);
+  REQUIRE(counter == 105);
+  REQUIRE(invocations == 102);
+  REQUIRE(tvec_len(t) == 0);
+
+  tvec_push_back(t, kTwo);
+  tvec_destroy(t);
+  REQUIRE(counter == 107);
+  REQUIRE(invocations == 103);
+}
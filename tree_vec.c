@@ -0,0 +1,476 @@
+#include "./tree_vec.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./panic.h"
+
+// A node other than the root is refilled from a sibling once it drops below
+// half full.
+#define TVEC_LEAF_MIN (TVEC_LEAF_SLOTS / 2)
+#define TVEC_INNER_MIN (TVEC_FANOUT / 2)
+
+typedef struct tvec_leaf_st {
+  size_t count;
+  struct tvec_leaf_st* next;  // the leaf to the right, NULL for the last one
+  ptr_t elems[TVEC_LEAF_SLOTS];
+} TvecLeaf;
+
+typedef struct tvec_inner_st {
+  size_t count;  // children in use
+  size_t sizes[TVEC_FANOUT];  // elements under each child
+  void* children[TVEC_FANOUT];  // inner nodes or leaves, see height
+} TvecInner;
+
+_Static_assert(sizeof(TvecLeaf) == 256, "a leaf should be four cache lines");
+
+struct tree_vec_st {
+  void* root;  // NULL while empty
+  size_t height;  // inner levels above the leaves, 0 if root is a leaf
+  size_t length;
+  ptr_dtor_fn ele_dtor_fn;
+};
+
+static void* tvec_alloc(size_t size) {
+  void* node = malloc(size);
+  if (node == NULL) {
+    panic("Memory allocation failed in TreeVec");
+  }
+  return node;
+}
+
+static TvecLeaf* tvec_new_leaf(void) {
+  TvecLeaf* leaf = (TvecLeaf*)tvec_alloc(sizeof(TvecLeaf));
+  leaf->count = 0;
+  leaf->next = NULL;
+  return leaf;
+}
+
+static TvecInner* tvec_new_inner(void) {
+  TvecInner* inner = (TvecInner*)tvec_alloc(sizeof(TvecInner));
+  inner->count = 0;
+  return inner;
+}
+
+// Number of elements under a node `height` levels above the leaves.
+static size_t tvec_node_size(const void* node, size_t height) {
+  if (height == 0) {
+    return ((const TvecLeaf*)node)->count;
+  }
+  const TvecInner* inner = (const TvecInner*)node;
+  size_t size = 0;
+  for (size_t i = 0; i < inner->count; i++) {
+    size += inner->sizes[i];
+  }
+  return size;
+}
+
+static size_t tvec_node_count(const void* node, size_t height) {
+  return height == 0 ? ((const TvecLeaf*)node)->count
+                     : ((const TvecInner*)node)->count;
+}
+
+// Picks the child of `inner` that holds *index and makes *index relative to
+// that child.
+static size_t tvec_child_of(const TvecInner* inner, size_t* index) {
+  size_t i = 0;
+  while (i + 1 < inner->count && *index >= inner->sizes[i]) {
+    *index -= inner->sizes[i];
+    i++;
+  }
+  return i;
+}
+
+// Walks down to the leaf holding `index` and makes *index relative to it.
+static TvecLeaf* tvec_find_leaf(const TreeVec* self, size_t* index) {
+  void* node = self->root;
+  for (size_t h = self->height; h > 0; h--) {
+    const TvecInner* inner = (const TvecInner*)node;
+    node = inner->children[tvec_child_of(inner, index)];
+  }
+  return (TvecLeaf*)node;
+}
+
+// --- insert ---
+
+// Inserts into a leaf. If the leaf is full it is split and the new right
+// half is returned, otherwise NULL. `append` is set when inserting past the
+// last element of the whole sequence.
+static TvecLeaf* tvec_leaf_insert(TvecLeaf* leaf,
+                                  size_t index,
+                                  ptr_t ele,
+                                  bool append) {
+  if (leaf->count < TVEC_LEAF_SLOTS) {
+    memmove(&leaf->elems[index + 1], &leaf->elems[index],
+            (leaf->count - index) * sizeof(ptr_t));
+    leaf->elems[index] = ele;
+    leaf->count++;
+    return NULL;
+  }
+
+  TvecLeaf* right = tvec_new_leaf();
+  right->next = leaf->next;
+  leaf->next = right;
+  if (append) {
+    // leave this leaf full and start a new one, as a bulk load would
+    right->elems[0] = ele;
+    right->count = 1;
+    return right;
+  }
+
+  size_t keep = TVEC_LEAF_SLOTS / 2;
+  right->count = TVEC_LEAF_SLOTS - keep;
+  memcpy(right->elems, &leaf->elems[keep], right->count * sizeof(ptr_t));
+  leaf->count = keep;
+  if (index <= keep) {
+    tvec_leaf_insert(leaf, index, ele, false);
+  } else {
+    tvec_leaf_insert(right, index - keep, ele, false);
+  }
+  return right;
+}
+
+// Inserts `child`, which holds `size` elements, at position `pos` of an
+// inner node. Splits the node like tvec_leaf_insert if it is full.
+static TvecInner* tvec_inner_insert(TvecInner* inner,
+                                    size_t pos,
+                                    void* child,
+                                    size_t size,
+                                    bool append) {
+  if (inner->count < TVEC_FANOUT) {
+    memmove(&inner->children[pos + 1], &inner->children[pos],
+            (inner->count - pos) * sizeof(void*));
+    memmove(&inner->sizes[pos + 1], &inner->sizes[pos],
+            (inner->count - pos) * sizeof(size_t));
+    inner->children[pos] = child;
+    inner->sizes[pos] = size;
+    inner->count++;
+    return NULL;
+  }
+
+  TvecInner* right = tvec_new_inner();
+  if (append) {
+    right->children[0] = child;
+    right->sizes[0] = size;
+    right->count = 1;
+    return right;
+  }
+
+  size_t keep = TVEC_FANOUT / 2;
+  right->count = TVEC_FANOUT - keep;
+  memcpy(right->children, &inner->children[keep],
+         right->count * sizeof(void*));
+  memcpy(right->sizes, &inner->sizes[keep], right->count * sizeof(size_t));
+  inner->count = keep;
+  if (pos <= keep) {
+    tvec_inner_insert(inner, pos, child, size, false);
+  } else {
+    tvec_inner_insert(right, pos - keep, child, size, false);
+  }
+  return right;
+}
+
+// Inserts under `node`. Returns the new right sibling of `node` if it had to
+// be split, otherwise NULL.
+static void* tvec_insert_at(void* node,
+                            size_t height,
+                            size_t index,
+                            ptr_t ele,
+                            bool append) {
+  if (height == 0) {
+    return tvec_leaf_insert((TvecLeaf*)node, index, ele, append);
+  }
+
+  TvecInner* inner = (TvecInner*)node;
+  // unlike a lookup, an index equal to a child's size goes to the end of
+  // that child
+  size_t i = 0;
+  while (i + 1 < inner->count && index > inner->sizes[i]) {
+    index -= inner->sizes[i];
+    i++;
+  }
+
+  inner->sizes[i]++;
+  void* split =
+      tvec_insert_at(inner->children[i], height - 1, index, ele, append);
+  if (split == NULL) {
+    return NULL;
+  }
+  size_t split_size = tvec_node_size(split, height - 1);
+  inner->sizes[i] -= split_size;
+  return tvec_inner_insert(inner, i + 1, split, split_size, append);
+}
+
+// --- erase ---
+
+// Moves `n` elements or children from the front of `from` to the back of
+// `to`, or from the back of `from` to the front of `to` if to_front is set.
+static void tvec_shift(void* to,
+                       void* from,
+                       size_t height,
+                       size_t n,
+                       bool to_front) {
+  if (height == 0) {
+    TvecLeaf* dst = (TvecLeaf*)to;
+    TvecLeaf* src = (TvecLeaf*)from;
+    if (to_front) {
+      memmove(&dst->elems[n], dst->elems, dst->count * sizeof(ptr_t));
+      memcpy(dst->elems, &src->elems[src->count - n], n * sizeof(ptr_t));
+    } else {
+      memcpy(&dst->elems[dst->count], src->elems, n * sizeof(ptr_t));
+      memmove(src->elems, &src->elems[n], (src->count - n) * sizeof(ptr_t));
+    }
+    dst->count += n;
+    src->count -= n;
+    return;
+  }
+
+  TvecInner* dst = (TvecInner*)to;
+  TvecInner* src = (TvecInner*)from;
+  if (to_front) {
+    memmove(&dst->children[n], dst->children, dst->count * sizeof(void*));
+    memmove(&dst->sizes[n], dst->sizes, dst->count * sizeof(size_t));
+    memcpy(dst->children, &src->children[src->count - n], n * sizeof(void*));
+    memcpy(dst->sizes, &src->sizes[src->count - n], n * sizeof(size_t));
+  } else {
+    memcpy(&dst->children[dst->count], src->children, n * sizeof(void*));
+    memcpy(&dst->sizes[dst->count], src->sizes, n * sizeof(size_t));
+    memmove(src->children, &src->children[n],
+            (src->count - n) * sizeof(void*));
+    memmove(src->sizes, &src->sizes[n], (src->count - n) * sizeof(size_t));
+  }
+  dst->count += n;
+  src->count -= n;
+}
+
+// Child i of `parent` has dropped below half full. Merges it with a
+// neighbour if both fit in one node, otherwise evens the two out.
+static void tvec_rebalance(TvecInner* parent, size_t i, size_t height) {
+  if (parent->count < 2) {
+    // only an unbalanced root can get here, its parent collapses it
+    return;
+  }
+
+  size_t l = i > 0 ? i - 1 : i;
+  void* left = parent->children[l];
+  void* right = parent->children[l + 1];
+  size_t left_count = tvec_node_count(left, height);
+  size_t right_count = tvec_node_count(right, height);
+  size_t slots = height == 0 ? TVEC_LEAF_SLOTS : TVEC_FANOUT;
+
+  if (left_count + right_count <= slots) {
+    tvec_shift(left, right, height, right_count, false);
+    if (height == 0) {
+      ((TvecLeaf*)left)->next = ((TvecLeaf*)right)->next;
+    }
+    free(right);
+    parent->sizes[l] += parent->sizes[l + 1];
+    memmove(&parent->children[l + 1], &parent->children[l + 2],
+            (parent->count - l - 2) * sizeof(void*));
+    memmove(&parent->sizes[l + 1], &parent->sizes[l + 2],
+            (parent->count - l - 2) * sizeof(size_t));
+    parent->count--;
+    return;
+  }
+
+  size_t half = (left_count + right_count) / 2;
+  if (left_count < half) {
+    tvec_shift(left, right, height, half - left_count, false);
+  } else {
+    tvec_shift(right, left, height, left_count - half, true);
+  }
+  size_t total = parent->sizes[l] + parent->sizes[l + 1];
+  parent->sizes[l] = tvec_node_size(left, height);
+  parent->sizes[l + 1] = total - parent->sizes[l];
+}
+
+// Removes the element at `index` under `node` and returns it.
+static ptr_t tvec_erase_at(void* node, size_t height, size_t index) {
+  if (height == 0) {
+    TvecLeaf* leaf = (TvecLeaf*)node;
+    ptr_t ele = leaf->elems[index];
+    memmove(&leaf->elems[index], &leaf->elems[index + 1],
+            (leaf->count - index - 1) * sizeof(ptr_t));
+    leaf->count--;
+    return ele;
+  }
+
+  TvecInner* inner = (TvecInner*)node;
+  size_t i = tvec_child_of(inner, &index);
+  inner->sizes[i]--;
+  void* child = inner->children[i];
+  ptr_t ele = tvec_erase_at(child, height - 1, index);
+  size_t min = height - 1 == 0 ? TVEC_LEAF_MIN : TVEC_INNER_MIN;
+  if (tvec_node_count(child, height - 1) < min) {
+    tvec_rebalance(inner, i, height - 1);
+  }
+  return ele;
+}
+
+// --- public ---
+
+static void tvec_free_node(TreeVec* self, void* node, size_t height);
+
+TreeVec* tvec_new(ptr_dtor_fn ele_dtor_fn) {
+  TreeVec* self = (TreeVec*)malloc(sizeof(TreeVec));
+  if (self == NULL) {
+    panic("Memory allocation failed in tvec_new");
+    return NULL;
+  }
+
+  self->root = NULL;
+  self->height = 0;
+  self->length = 0;
+  self->ele_dtor_fn = ele_dtor_fn;
+  return self;
+}
+
+size_t tvec_len(const TreeVec* self) {
+  return self->length;
+}
+
+ptr_t tvec_get(const TreeVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in tvec_get");
+  }
+
+  TvecLeaf* leaf = tvec_find_leaf(self, &index);
+  return leaf->elems[index];
+}
+
+void tvec_set(TreeVec* self, size_t index, ptr_t new_ele) {
+  if (index >= self->length) {
+    panic("Index out of bounds in tvec_set");
+  }
+
+  TvecLeaf* leaf = tvec_find_leaf(self, &index);
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(leaf->elems[index]);
+  }
+  leaf->elems[index] = new_ele;
+}
+
+void tvec_insert(TreeVec* self, size_t index, ptr_t new_ele) {
+  if (index > self->length) {
+    panic("Index out of bounds in tvec_insert");
+  }
+
+  if (self->root == NULL) {
+    self->root = tvec_new_leaf();
+    self->height = 0;
+  }
+
+  void* split = tvec_insert_at(self->root, self->height, index, new_ele,
+                               index == self->length);
+  self->length++;
+  if (split != NULL) {
+    // the root was split, grow the tree by one level
+    TvecInner* root = tvec_new_inner();
+    size_t split_size = tvec_node_size(split, self->height);
+    root->children[0] = self->root;
+    root->sizes[0] = self->length - split_size;
+    root->children[1] = split;
+    root->sizes[1] = split_size;
+    root->count = 2;
+    self->root = root;
+    self->height++;
+  }
+}
+
+void tvec_erase(TreeVec* self, size_t index) {
+  if (index >= self->length) {
+    panic("Index out of bounds in tvec_erase");
+  }
+
+  ptr_t ele = tvec_erase_at(self->root, self->height, index);
+  self->length--;
+
+  // drop roots that are left with a single child
+  while (self->height > 0 && ((TvecInner*)self->root)->count == 1) {
+    void* old = self->root;
+    self->root = ((TvecInner*)old)->children[0];
+    self->height--;
+    free(old);
+  }
+  if (self->length == 0) {
+    tvec_clear(self);
+  }
+
+  if (self->ele_dtor_fn != NULL) {
+    self->ele_dtor_fn(ele);
+  }
+}
+
+void tvec_push_back(TreeVec* self, ptr_t new_ele) {
+  tvec_insert(self, self->length, new_ele);
+}
+
+bool tvec_pop_back(TreeVec* self) {
+  if (self->length == 0) {
+    return false;
+  }
+
+  tvec_erase(self, self->length - 1);
+  return true;
+}
+
+TreeVecIter tvec_iter(const TreeVec* self, size_t index) {
+  if (index > self->length) {
+    panic("Index out of bounds in tvec_iter");
+  }
+
+  TreeVecIter iter;
+  iter.leaf = NULL;
+  iter.offset = 0;
+  if (index < self->length) {
+    iter.leaf = tvec_find_leaf(self, &index);
+    iter.offset = index;
+  }
+  return iter;
+}
+
+bool tvec_iter_next(TreeVecIter* iter, ptr_t* out) {
+  while (iter->leaf != NULL && iter->offset == iter->leaf->count) {
+    iter->leaf = iter->leaf->next;
+    iter->offset = 0;
+  }
+  if (iter->leaf == NULL) {
+    return false;
+  }
+
+  *out = iter->leaf->elems[iter->offset++];
+  return true;
+}
+
+static void tvec_free_node(TreeVec* self, void* node, size_t height) {
+  if (height == 0) {
+    TvecLeaf* leaf = (TvecLeaf*)node;
+    if (self->ele_dtor_fn != NULL) {
+      for (size_t i = 0; i < leaf->count; i++) {
+        self->ele_dtor_fn(leaf->elems[i]);
+      }
+    }
+  } else {
+    TvecInner* inner = (TvecInner*)node;
+    for (size_t i = 0; i < inner->count; i++) {
+      tvec_free_node(self, inner->children[i], height - 1);
+    }
+  }
+  free(node);
+}
+
+void tvec_clear(TreeVec* self) {
+  if (self->root != NULL) {
+    tvec_free_node(self, self->root, self->height);
+  }
+  self->root = NULL;
+  self->height = 0;
+  self->length = 0;
+}
+
+void tvec_destroy(TreeVec* self) {
+  if (self == NULL) {
+    return;
+  }
+  tvec_clear(self);
+  free(self);
+}
@@ -0,0 +1,124 @@
+#ifndef TREE_VEC_H_
+#define TREE_VEC_H_
+
+/*!
+ * An indexed sequence stored in a B+ tree, for very long vectors that get
+ * inserts and erases at arbitrary positions. A Vec shifts every element
+ * after the position on each of those, a TreeVec only touches one leaf and
+ * the nodes above it:
+ *
+ *                      Vec      TreeVec
+ *   get / set          O(1)     O(log n)
+ *   insert / erase     O(n)     O(log n)
+ *   push / pop back    O(1)*    O(log n)
+ *   iterate            O(n)     O(n)
+ *
+ * Elements live in leaves of TVEC_LEAF_SLOTS slots (256 bytes, four cache
+ * lines, with the header). Each inner node has up to TVEC_FANOUT children and
+ * keeps the number of elements under each of them, so an index is found by
+ * walking down and subtracting the counts of the subtrees it skips. The
+ * leaves are linked left to right for iteration.
+ *
+ * The functions mirror their vec_ counterparts, including when they panic.
+ * Any operation that modifies the sequence invalidates pointers to its
+ * elements and any TreeVecIter.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include "./Vec.h"
+
+/* Element slots per leaf. */
+#define TVEC_LEAF_SLOTS 30
+
+/* Maximum number of children of an inner node. */
+#define TVEC_FANOUT 16
+
+typedef struct tree_vec_st TreeVec;
+
+/* An in-order cursor over a TreeVec, see tvec_iter. */
+typedef struct tree_vec_iter_st {
+  struct tvec_leaf_st* leaf;
+  size_t offset;
+} TreeVecIter;
+
+/*!
+ * Creates a new empty TreeVec.
+ *
+ * @param ele_dtor_fn the element destructor, same as in vec_new
+ * @returns a pointer to the new sequence, destroy it with tvec_destroy.
+ * @post if memory allocation fails, the function will panic.
+ */
+TreeVec* tvec_new(ptr_dtor_fn ele_dtor_fn);
+
+/* Returns the number of elements in the TreeVec. */
+size_t tvec_len(const TreeVec* self);
+
+/* Gets the element at the specified index
+ * Same as vec_get, panics if index >= tvec_len(self)
+ */
+ptr_t tvec_get(const TreeVec* self, size_t index);
+
+/* Sets the element at the specified index
+ * Same as vec_set: the replaced element is destructed and this panics if
+ * index >= tvec_len(self)
+ */
+void tvec_set(TreeVec* self, size_t index, ptr_t new_ele);
+
+/* Inserts an element at the specified index. Elements at this index and
+ * after it move up one position.
+ *
+ * @pre If the index is > tvec_len(self) then this function will panic().
+ * @post If a full leaf has to be split and the allocation fails, then this
+ * function will panic().
+ */
+void tvec_insert(TreeVec* self, size_t index, ptr_t new_ele);
+
+/* Erases and destructs the element at the specified index. Elements after
+ * it move down one position.
+ *
+ * @pre If the index is >= tvec_len(self) then this function will panic().
+ */
+void tvec_erase(TreeVec* self, size_t index);
+
+/* Appends the given element to the end of the TreeVec.
+ * A leaf that fills up from the back is split as in a bulk load, so appends
+ * leave every leaf but the last one full.
+ *
+ * @post If the allocation of a new leaf fails, then this function will
+ * panic().
+ */
+void tvec_push_back(TreeVec* self, ptr_t new_ele);
+
+/* Removes and destroys the last element of the TreeVec
+ *
+ * @returns true iff an element was removed.
+ */
+bool tvec_pop_back(TreeVec* self);
+
+/* Returns an iterator positioned before the element at `index`, so that the
+ * first call to tvec_iter_next yields that element. Finding the position is
+ * O(log n), every step after it is O(1).
+ *
+ * @pre If the index is > tvec_len(self) then this function will panic().
+ */
+TreeVecIter tvec_iter(const TreeVec* self, size_t index);
+
+/* Advances the iterator.
+ *
+ * @param out set to the next element, if there is one
+ * @returns false once every element has been visited.
+ */
+bool tvec_iter_next(TreeVecIter* iter, ptr_t* out);
+
+/* Erases all elements from the TreeVec, destructing them, and frees every
+ * node.
+ */
+void tvec_clear(TreeVec* self);
+
+/* Destructs every element and frees the sequence. Does nothing if self is
+ * NULL.
+ */
+void tvec_destroy(TreeVec* self);
+
+#endif  // TREE_VEC_H_
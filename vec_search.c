@@ -0,0 +1,256 @@
+#include "./vec_search.h"
+#include <stdint.h>
+
+#if defined(__x86_64__) && !defined(VEC_DISABLE_SIMD)
+#define VEC_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+// Elements checked per iteration of the vector loops: four vectors of two
+// (SSE2) or four (AVX2) elements, so loads from several cache lines are in
+// flight at once.
+#define SSE2_BLOCK 8
+#define AVX2_BLOCK 16
+
+static vec_search_kernel forced_kernel = VEC_SEARCH_AUTO;
+
+// --- scalar ---
+
+static size_t find_scalar(const ptr_t* data, size_t n, ptr_t needle) {
+  for (size_t i = 0; i < n; i++) {
+    if (data[i] == needle) {
+      return i;
+    }
+  }
+  return VEC_NOT_FOUND;
+}
+
+static size_t rfind_scalar(const ptr_t* data, size_t n, ptr_t needle) {
+  for (size_t i = n; i > 0; i--) {
+    if (data[i - 1] == needle) {
+      return i - 1;
+    }
+  }
+  return VEC_NOT_FOUND;
+}
+
+static size_t count_scalar(const ptr_t* data, size_t n, ptr_t needle) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; i++) {
+    count += data[i] == needle;
+  }
+  return count;
+}
+
+#ifdef VEC_SEARCH_X86
+
+// --- SSE2 ---
+
+// SSE2 has no 64 bit compare (that came with SSE4.1): compare the 32 bit
+// halves and a lane is equal iff both of its halves are.
+static __m128i sse2_eq64(const ptr_t* data, __m128i key) {
+  __m128i eq32 = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)data), key);
+  return _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+static bool sse2_block_has(const ptr_t* data, __m128i key) {
+  __m128i any = _mm_or_si128(
+      _mm_or_si128(sse2_eq64(data, key), sse2_eq64(data + 2, key)),
+      _mm_or_si128(sse2_eq64(data + 4, key), sse2_eq64(data + 6, key)));
+  return _mm_movemask_epi8(any) != 0;
+}
+
+static size_t find_sse2(const ptr_t* data, size_t n, ptr_t needle) {
+  __m128i key = _mm_set1_epi64x((long long)(uintptr_t)needle);
+  size_t i = 0;
+  for (; i + SSE2_BLOCK <= n; i += SSE2_BLOCK) {
+    if (sse2_block_has(&data[i], key)) {
+      return i + find_scalar(&data[i], SSE2_BLOCK, needle);
+    }
+  }
+  size_t tail = find_scalar(&data[i], n - i, needle);
+  return tail == VEC_NOT_FOUND ? VEC_NOT_FOUND : i + tail;
+}
+
+static size_t rfind_sse2(const ptr_t* data, size_t n, ptr_t needle) {
+  __m128i key = _mm_set1_epi64x((long long)(uintptr_t)needle);
+  size_t end = n;
+  for (; end >= SSE2_BLOCK; end -= SSE2_BLOCK) {
+    const ptr_t* block = &data[end - SSE2_BLOCK];
+    if (sse2_block_has(block, key)) {
+      return end - SSE2_BLOCK + rfind_scalar(block, SSE2_BLOCK, needle);
+    }
+  }
+  return rfind_scalar(data, end, needle);
+}
+
+static size_t count_sse2(const ptr_t* data, size_t n, ptr_t needle) {
+  __m128i key = _mm_set1_epi64x((long long)(uintptr_t)needle);
+  // equal lanes are all ones, i.e. -1, so subtracting them counts them
+  __m128i acc = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + SSE2_BLOCK <= n; i += SSE2_BLOCK) {
+    acc = _mm_sub_epi64(acc, sse2_eq64(&data[i], key));
+    acc = _mm_sub_epi64(acc, sse2_eq64(&data[i + 2], key));
+    acc = _mm_sub_epi64(acc, sse2_eq64(&data[i + 4], key));
+    acc = _mm_sub_epi64(acc, sse2_eq64(&data[i + 6], key));
+  }
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i*)lanes, acc);
+  return (size_t)(lanes[0] + lanes[1]) + count_scalar(&data[i], n - i, needle);
+}
+
+// --- AVX2 ---
+
+__attribute__((target("avx2"))) static __m256i avx2_eq64(const ptr_t* data,
+                                                         __m256i key) {
+  return _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)data), key);
+}
+
+__attribute__((target("avx2"))) static bool avx2_block_has(const ptr_t* data,
+                                                           __m256i key) {
+  __m256i any = _mm256_or_si256(
+      _mm256_or_si256(avx2_eq64(data, key), avx2_eq64(data + 4, key)),
+      _mm256_or_si256(avx2_eq64(data + 8, key), avx2_eq64(data + 12, key)));
+  return !_mm256_testz_si256(any, any);
+}
+
+__attribute__((target("avx2"))) static size_t find_avx2(const ptr_t* data,
+                                                        size_t n,
+                                                        ptr_t needle) {
+  __m256i key = _mm256_set1_epi64x((long long)(uintptr_t)needle);
+  size_t i = 0;
+  for (; i + AVX2_BLOCK <= n; i += AVX2_BLOCK) {
+    if (avx2_block_has(&data[i], key)) {
+      return i + find_scalar(&data[i], AVX2_BLOCK, needle);
+    }
+  }
+  size_t tail = find_scalar(&data[i], n - i, needle);
+  return tail == VEC_NOT_FOUND ? VEC_NOT_FOUND : i + tail;
+}
+
+__attribute__((target("avx2"))) static size_t rfind_avx2(const ptr_t* data,
+                                                         size_t n,
+                                                         ptr_t needle) {
+  __m256i key = _mm256_set1_epi64x((long long)(uintptr_t)needle);
+  size_t end = n;
+  for (; end >= AVX2_BLOCK; end -= AVX2_BLOCK) {
+    const ptr_t* block = &data[end - AVX2_BLOCK];
+    if (avx2_block_has(block, key)) {
+      return end - AVX2_BLOCK + rfind_scalar(block, AVX2_BLOCK, needle);
+    }
+  }
+  return rfind_scalar(data, end, needle);
+}
+
+__attribute__((target("avx2"))) static size_t count_avx2(const ptr_t* data,
+                                                         size_t n,
+                                                         ptr_t needle) {
+  __m256i key = _mm256_set1_epi64x((long long)(uintptr_t)needle);
+  __m256i acc = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + AVX2_BLOCK <= n; i += AVX2_BLOCK) {
+    acc = _mm256_sub_epi64(acc, avx2_eq64(&data[i], key));
+    acc = _mm256_sub_epi64(acc, avx2_eq64(&data[i + 4], key));
+    acc = _mm256_sub_epi64(acc, avx2_eq64(&data[i + 8], key));
+    acc = _mm256_sub_epi64(acc, avx2_eq64(&data[i + 12], key));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256((__m256i*)lanes, acc);
+  return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) +
+         count_scalar(&data[i], n - i, needle);
+}
+
+#endif  // VEC_SEARCH_X86
+
+static bool kernel_supported(vec_search_kernel kernel) {
+  switch (kernel) {
+    case VEC_SEARCH_AUTO:
+    case VEC_SEARCH_SCALAR:
+      return true;
+#ifdef VEC_SEARCH_X86
+    case VEC_SEARCH_SSE2:
+      return __builtin_cpu_supports("sse2");
+    case VEC_SEARCH_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+vec_search_kernel vec_search_active(void) {
+  if (forced_kernel != VEC_SEARCH_AUTO) {
+    return forced_kernel;
+  }
+  if (kernel_supported(VEC_SEARCH_AVX2)) {
+    return VEC_SEARCH_AVX2;
+  }
+  if (kernel_supported(VEC_SEARCH_SSE2)) {
+    return VEC_SEARCH_SSE2;
+  }
+  return VEC_SEARCH_SCALAR;
+}
+
+bool vec_search_use(vec_search_kernel kernel) {
+  if (!kernel_supported(kernel)) {
+    return false;
+  }
+  forced_kernel = kernel;
+  return true;
+}
+
+size_t vec_find(Vec* self, ptr_t needle) {
+  if (self->length == 0) {
+    return VEC_NOT_FOUND;
+  }
+
+  switch (vec_search_active()) {
+#ifdef VEC_SEARCH_X86
+    case VEC_SEARCH_AVX2:
+      return find_avx2(self->data, self->length, needle);
+    case VEC_SEARCH_SSE2:
+      return find_sse2(self->data, self->length, needle);
+#endif
+    default:
+      return find_scalar(self->data, self->length, needle);
+  }
+}
+
+size_t vec_rfind(Vec* self, ptr_t needle) {
+  if (self->length == 0) {
+    return VEC_NOT_FOUND;
+  }
+
+  switch (vec_search_active()) {
+#ifdef VEC_SEARCH_X86
+    case VEC_SEARCH_AVX2:
+      return rfind_avx2(self->data, self->length, needle);
+    case VEC_SEARCH_SSE2:
+      return rfind_sse2(self->data, self->length, needle);
+#endif
+    default:
+      return rfind_scalar(self->data, self->length, needle);
+  }
+}
+
+bool vec_contains(Vec* self, ptr_t needle) {
+  return vec_find(self, needle) != VEC_NOT_FOUND;
+}
+
+size_t vec_count_eq(Vec* self, ptr_t needle) {
+  if (self->length == 0) {
+    return 0;
+  }
+
+  switch (vec_search_active()) {
+#ifdef VEC_SEARCH_X86
+    case VEC_SEARCH_AVX2:
+      return count_avx2(self->data, self->length, needle);
+    case VEC_SEARCH_SSE2:
+      return count_sse2(self->data, self->length, needle);
+#endif
+    default:
+      return count_scalar(self->data, self->length, needle);
+  }
+}
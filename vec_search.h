@@ -0,0 +1,58 @@
+#ifndef VEC_SEARCH_H_
+#define VEC_SEARCH_H_
+
+/*!
+ * Searching a Vec for an element by value (pointer equality).
+ *
+ * The scans compare several elements per instruction. On x86-64 the kernel
+ * is picked at run time: AVX2 when the CPU has it, SSE2 otherwise (every
+ * x86-64 CPU has SSE2). Other architectures, and builds with
+ * -DVEC_DISABLE_SIMD, use a plain scalar loop.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for SIZE_MAX
+#include "./Vec.h"
+
+/* Returned by vec_find and vec_rfind when the element is not in the Vec. */
+#define VEC_NOT_FOUND SIZE_MAX
+
+/* The search kernels, see vec_search_use. */
+typedef enum vec_search_kernel_e {
+  VEC_SEARCH_AUTO,  // the best one the CPU supports
+  VEC_SEARCH_SCALAR,
+  VEC_SEARCH_SSE2,
+  VEC_SEARCH_AVX2,
+} vec_search_kernel;
+
+/* Returns the index of the first element equal to needle, or VEC_NOT_FOUND.
+ */
+size_t vec_find(Vec* self, ptr_t needle);
+
+/* Returns the index of the last element equal to needle, or VEC_NOT_FOUND.
+ */
+size_t vec_rfind(Vec* self, ptr_t needle);
+
+/* Returns true iff some element is equal to needle.
+ */
+bool vec_contains(Vec* self, ptr_t needle);
+
+/* Returns the number of elements equal to needle.
+ */
+size_t vec_count_eq(Vec* self, ptr_t needle);
+
+/* Forces every later search to use the given kernel, VEC_SEARCH_AUTO goes
+ * back to picking the best one. Meant for tests and benchmarks. Not thread
+ * safe, call it before searching from several threads.
+ *
+ * @returns false, and changes nothing, if the kernel is not available on
+ * this CPU or in this build.
+ */
+bool vec_search_use(vec_search_kernel kernel);
+
+/* Returns the kernel searches currently run with, never VEC_SEARCH_AUTO.
+ */
+vec_search_kernel vec_search_active(void);
+
+#endif  // VEC_SEARCH_H_
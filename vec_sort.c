@@ -0,0 +1,385 @@
+#include "./vec_sort.h"
+#include <limits.h>  // for CHAR_BIT
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "./panic.h"
+
+// Runs at most this long are finished with insertion sort.
+#define SORT_INSERTION_THRESHOLD 16
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1U << RADIX_BITS)
+#define RADIX_PASSES (sizeof(uintptr_t) * CHAR_BIT / RADIX_BITS)
+
+// --- introsort ---
+
+static void sort_swap(ptr_t* a, ptr_t* b) {
+  ptr_t tmp = *a;
+  *a = *b;
+  *b = tmp;
+}
+
+static void insertion_sort(ptr_t* data, size_t n, ptr_cmp_fn cmp, void* ctx) {
+  for (size_t i = 1; i < n; i++) {
+    ptr_t ele = data[i];
+    size_t j = i;
+    while (j > 0 && cmp(ele, data[j - 1], ctx) < 0) {
+      data[j] = data[j - 1];
+      j--;
+    }
+    data[j] = ele;
+  }
+}
+
+static void sift_down(ptr_t* data,
+                      size_t root,
+                      size_t n,
+                      ptr_cmp_fn cmp,
+                      void* ctx) {
+  while (2 * root + 1 < n) {
+    size_t child = 2 * root + 1;
+    if (child + 1 < n && cmp(data[child], data[child + 1], ctx) < 0) {
+      child++;
+    }
+    if (cmp(data[root], data[child], ctx) >= 0) {
+      return;
+    }
+    sort_swap(&data[root], &data[child]);
+    root = child;
+  }
+}
+
+static void heap_sort(ptr_t* data, size_t n, ptr_cmp_fn cmp, void* ctx) {
+  for (size_t i = n / 2; i > 0; i--) {
+    sift_down(data, i - 1, n, cmp, ctx);
+  }
+  for (size_t end = n - 1; end > 0; end--) {
+    sort_swap(&data[0], &data[end]);
+    sift_down(data, 0, end, cmp, ctx);
+  }
+}
+
+// Hoare partition around the median of the first, middle and last element.
+// Returns j such that data[0..j] <= pivot <= data[j+1..n), with 0 <= j < n-1.
+static size_t partition(ptr_t* data, size_t n, ptr_cmp_fn cmp, void* ctx) {
+  size_t mid = (n - 1) / 2;
+  if (cmp(data[mid], data[0], ctx) < 0) {
+    sort_swap(&data[mid], &data[0]);
+  }
+  if (cmp(data[n - 1], data[mid], ctx) < 0) {
+    sort_swap(&data[n - 1], &data[mid]);
+    if (cmp(data[mid], data[0], ctx) < 0) {
+      sort_swap(&data[mid], &data[0]);
+    }
+  }
+
+  ptr_t pivot = data[mid];
+  size_t i = 0;
+  size_t j = n - 1;
+  while (true) {
+    while (cmp(data[i], pivot, ctx) < 0) {
+      i++;
+    }
+    while (cmp(pivot, data[j], ctx) < 0) {
+      j--;
+    }
+    if (i >= j) {
+      return j;
+    }
+    sort_swap(&data[i], &data[j]);
+    i++;
+    j--;
+  }
+}
+
+static void intro_sort(ptr_t* data,
+                       size_t n,
+                       size_t depth,
+                       ptr_cmp_fn cmp,
+                       void* ctx) {
+  while (n > SORT_INSERTION_THRESHOLD) {
+    if (depth == 0) {
+      heap_sort(data, n, cmp, ctx);
+      return;
+    }
+    depth--;
+
+    // recurse into the smaller side, loop on the bigger one, so the stack
+    // stays O(log n) deep
+    size_t left = partition(data, n, cmp, ctx) + 1;
+    if (left < n - left) {
+      intro_sort(data, left, depth, cmp, ctx);
+      data += left;
+      n -= left;
+    } else {
+      intro_sort(data + left, n - left, depth, cmp, ctx);
+      n = left;
+    }
+  }
+  insertion_sort(data, n, cmp, ctx);
+}
+
+static void sort_elems(ptr_t* data, size_t n, ptr_cmp_fn cmp, void* ctx) {
+  if (n < 2) {
+    return;
+  }
+
+  size_t depth = 0;
+  for (size_t m = n; m > 1; m >>= 1U) {
+    depth += 2;
+  }
+  intro_sort(data, n, depth, cmp, ctx);
+}
+
+void vec_sort(Vec* self, ptr_cmp_fn cmp, void* ctx) {
+  sort_elems(self->data, self->length, cmp, ctx);
+}
+
+// --- parallel merge sort ---
+
+typedef struct sort_task_st {
+  ptr_t* src;  // run(s) to sort or merge
+  ptr_t* dst;  // where merged output goes, NULL when sorting
+  size_t left;  // length of the first run
+  size_t right;  // length of the second run when merging
+  ptr_cmp_fn cmp;
+  void* ctx;
+} sort_task;
+
+static void* sort_task_run(void* arg) {
+  sort_task* task = (sort_task*)arg;
+  if (task->dst == NULL) {
+    sort_elems(task->src, task->left, task->cmp, task->ctx);
+    return NULL;
+  }
+
+  ptr_t* a = task->src;
+  ptr_t* a_end = a + task->left;
+  ptr_t* b = a_end;
+  ptr_t* b_end = b + task->right;
+  ptr_t* out = task->dst;
+  while (a < a_end && b < b_end) {
+    *out++ = task->cmp(*b, *a, task->ctx) < 0 ? *b++ : *a++;
+  }
+  memcpy(out, a, (size_t)(a_end - a) * sizeof(ptr_t));
+  out += a_end - a;
+  memcpy(out, b, (size_t)(b_end - b) * sizeof(ptr_t));
+  return NULL;
+}
+
+// Runs every task, tasks[1..n) on threads of their own and tasks[0] on the
+// calling thread. If a thread can't be started its task runs here instead.
+static void sort_tasks_run(sort_task* tasks, pthread_t* ids, size_t n) {
+  bool* started = (bool*)calloc(n, sizeof(bool));
+  for (size_t i = 1; i < n; i++) {
+    if (started != NULL &&
+        pthread_create(&ids[i], NULL, sort_task_run, &tasks[i]) == 0) {
+      started[i] = true;
+    } else {
+      sort_task_run(&tasks[i]);
+    }
+  }
+  sort_task_run(&tasks[0]);
+  for (size_t i = 1; i < n; i++) {
+    if (started != NULL && started[i]) {
+      pthread_join(ids[i], NULL);
+    }
+  }
+  free(started);
+}
+
+void vec_par_sort(Vec* self, ptr_cmp_fn cmp, void* ctx, size_t threads) {
+  size_t n = self->length;
+  if (threads == 0) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cores > 0 ? (size_t)cores : 1;
+  }
+  size_t runs = 1;
+  while (runs * 2 <= threads && n / (runs * 2) >= VEC_PAR_SORT_MIN_LENGTH) {
+    runs *= 2;
+  }
+  if (runs == 1) {
+    vec_sort(self, cmp, ctx);
+    return;
+  }
+
+  ptr_t* scratch = (ptr_t*)malloc(n * sizeof(ptr_t));
+  size_t* bounds = (size_t*)malloc((runs + 1) * sizeof(size_t));
+  sort_task* tasks = (sort_task*)malloc(runs * sizeof(sort_task));
+  pthread_t* ids = (pthread_t*)malloc(runs * sizeof(pthread_t));
+  if (scratch == NULL || bounds == NULL || tasks == NULL || ids == NULL) {
+    panic("Memory allocation failed in vec_par_sort");
+    return;
+  }
+
+  for (size_t i = 0; i <= runs; i++) {
+    bounds[i] = n / runs * i;
+  }
+  bounds[runs] = n;
+
+  for (size_t i = 0; i < runs; i++) {
+    tasks[i] = (sort_task){&self->data[bounds[i]], NULL,
+                           bounds[i + 1] - bounds[i], 0, cmp, ctx};
+  }
+  sort_tasks_run(tasks, ids, runs);
+
+  // merge neighbouring runs, ping-ponging between data and scratch
+  ptr_t* src = self->data;
+  ptr_t* dst = scratch;
+  for (size_t width = 1; width < runs; width *= 2) {
+    size_t merges = runs / (width * 2);
+    for (size_t i = 0; i < merges; i++) {
+      size_t lo = bounds[i * width * 2];
+      size_t mid = bounds[(i * 2 + 1) * width];
+      size_t hi = bounds[(i + 1) * width * 2];
+      tasks[i] = (sort_task){&src[lo], &dst[lo], mid - lo, hi - mid, cmp, ctx};
+    }
+    sort_tasks_run(tasks, ids, merges);
+
+    ptr_t* tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  if (src != self->data) {
+    memcpy(self->data, src, n * sizeof(ptr_t));
+  }
+
+  free(scratch);
+  free(bounds);
+  free(tasks);
+  free(ids);
+}
+
+// --- radix sort ---
+
+// Maps an intptr_t stored in a ptr_t to an unsigned key with the same order.
+static uintptr_t radix_key(ptr_t ele) {
+  return (uintptr_t)ele ^ ((uintptr_t)1 << (sizeof(uintptr_t) * CHAR_BIT - 1));
+}
+
+void vec_sort_intptr(Vec* self) {
+  size_t n = self->length;
+  if (n < 2) {
+    return;
+  }
+
+  // one histogram per byte, all filled in a single pass
+  size_t(*counts)[RADIX_BUCKETS] =
+      calloc(RADIX_PASSES, sizeof(size_t[RADIX_BUCKETS]));
+  ptr_t* scratch = (ptr_t*)malloc(n * sizeof(ptr_t));
+  if (counts == NULL || scratch == NULL) {
+    panic("Memory allocation failed in vec_sort_intptr");
+    return;
+  }
+  for (size_t i = 0; i < n; i++) {
+    uintptr_t key = radix_key(self->data[i]);
+    for (size_t pass = 0; pass < RADIX_PASSES; pass++) {
+      counts[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+  }
+
+  ptr_t* src = self->data;
+  ptr_t* dst = scratch;
+  for (size_t pass = 0; pass < RADIX_PASSES; pass++) {
+    size_t shift = pass * RADIX_BITS;
+    size_t* count = counts[pass];
+    if (count[(radix_key(src[0]) >> shift) & (RADIX_BUCKETS - 1)] == n) {
+      continue;  // every element has the same byte here
+    }
+
+    size_t offset = 0;
+    for (size_t b = 0; b < RADIX_BUCKETS; b++) {
+      size_t c = count[b];
+      count[b] = offset;
+      offset += c;
+    }
+    for (size_t i = 0; i < n; i++) {
+      dst[count[(radix_key(src[i]) >> shift) & (RADIX_BUCKETS - 1)]++] =
+          src[i];
+    }
+
+    ptr_t* tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  if (src != self->data) {
+    memcpy(self->data, src, n * sizeof(ptr_t));
+  }
+
+  free(counts);
+  free(scratch);
+}
+
+// --- sorted vectors ---
+
+size_t vec_lower_bound(Vec* self, ptr_t key, ptr_cmp_fn cmp, void* ctx) {
+  if (self->length == 0) {
+    return 0;
+  }
+
+  // base[0 .. len) always holds the answer, halve it without branching
+  const ptr_t* base = self->data;
+  size_t len = self->length;
+  while (len > 1) {
+    size_t half = len / 2;
+    base = cmp(base[half], key, ctx) < 0 ? base + half : base;
+    len -= half;
+  }
+  return (size_t)(base - self->data) + (cmp(*base, key, ctx) < 0);
+}
+
+size_t vec_upper_bound(Vec* self, ptr_t key, ptr_cmp_fn cmp, void* ctx) {
+  if (self->length == 0) {
+    return 0;
+  }
+
+  const ptr_t* base = self->data;
+  size_t len = self->length;
+  while (len > 1) {
+    size_t half = len / 2;
+    base = cmp(key, base[half], ctx) >= 0 ? base + half : base;
+    len -= half;
+  }
+  return (size_t)(base - self->data) + (cmp(key, *base, ctx) >= 0);
+}
+
+size_t vec_sorted_insert(Vec* self, ptr_t new_ele, ptr_cmp_fn cmp, void* ctx) {
+  size_t index = vec_upper_bound(self, new_ele, cmp, ctx);
+  vec_insert(self, index, new_ele);
+  return index;
+}
+
+void vec_sorted_insert_batch(Vec* self,
+                             ptr_t* elems,
+                             size_t n,
+                             ptr_cmp_fn cmp,
+                             void* ctx) {
+  if (n == 0) {
+    return;
+  }
+
+  sort_elems(elems, n, cmp, ctx);
+
+  // grow (through the growth policy) by appending the batch, then merge
+  // the old elements with elems from the back. The write position never
+  // passes the next old element to read, so nothing is overwritten early.
+  size_t old_length = self->length;
+  vec_extend(self, elems, n);
+  ptr_t* data = self->data;
+  size_t a = old_length;
+  size_t b = n;
+  size_t out = old_length + n;
+  while (a > 0 && b > 0) {
+    // on ties the batch element goes last, after the existing equal ones
+    if (cmp(elems[b - 1], data[a - 1], ctx) >= 0) {
+      data[--out] = elems[--b];
+    } else {
+      data[--out] = data[--a];
+    }
+  }
+  // whatever is left of the old elements is already in place
+  memcpy(data, elems, b * sizeof(ptr_t));
+}
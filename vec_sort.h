@@ -0,0 +1,124 @@
+#ifndef VEC_SORT_H_
+#define VEC_SORT_H_
+
+/*!
+ * Sorting for Vec.
+ *
+ *   vec_sort         introsort with a comparator, single threaded
+ *   vec_par_sort     the same, with the work split over several threads
+ *   vec_sort_intptr  LSD radix sort for elements that are integers packed
+ *                    into ptr_t, e.g. vec_push_back(&v, (ptr_t)(intptr_t)x)
+ *
+ * None of them are stable. They only permute the elements, no element
+ * destructor is called.
+ *
+ * It also has functions for keeping a Vec sorted: binary searches and
+ * inserts that keep the order. They assume the Vec is already sorted by the
+ * same comparator. Newly inserted elements go after existing equal ones.
+ */
+
+#include <stddef.h>  // for size_t
+#include "./Vec.h"
+
+/* Compares two elements, with the same contract as a qsort comparator:
+ * negative if a sorts before b, positive if after, 0 if they are equal.
+ * ctx is passed through unchanged.
+ */
+typedef int (*ptr_cmp_fn)(ptr_t a, ptr_t b, void* ctx);
+
+/* vec_par_sort sorts vectors shorter than this on the calling thread. */
+#define VEC_PAR_SORT_MIN_LENGTH ((size_t)1 << 14)
+
+/*!
+ * Sorts the elements of the vector in ascending order according to cmp.
+ * Quicksort with median of three pivots, falling back to heapsort if the
+ * recursion gets too deep and to insertion sort for short runs, so it is
+ * O(n log n) in the worst case. Does not allocate.
+ *
+ * @param self a pointer to the vector to sort
+ * @param cmp  the comparator
+ * @param ctx  passed to every call of cmp
+ */
+void vec_sort(Vec* self, ptr_cmp_fn cmp, void* ctx);
+
+/*!
+ * Sorts the elements of the vector in ascending order according to cmp,
+ * using up to `threads` threads. The vector is split into one run per
+ * thread, the runs are sorted with vec_sort in parallel and then merged
+ * pairwise, again in parallel.
+ *
+ * cmp is called concurrently from several threads, so it and ctx must be
+ * safe for that.
+ *
+ * @param self    a pointer to the vector to sort
+ * @param cmp     the comparator
+ * @param ctx     passed to every call of cmp
+ * @param threads the maximum number of threads to use, 0 for one per online
+ *                core. Rounded down to a power of two.
+ * @post if allocating the merge buffer fails, the function will panic.
+ */
+void vec_par_sort(Vec* self, ptr_cmp_fn cmp, void* ctx, size_t threads);
+
+/*!
+ * Sorts a vector whose elements are integers stored as
+ * (ptr_t)(intptr_t)value in ascending order of value, without calling a
+ * comparator. LSD radix sort over the bytes of the value, passes over bytes
+ * that are the same in every element are skipped.
+ *
+ * @param self a pointer to the vector to sort
+ * @post if allocating the scratch buffer fails, the function will panic.
+ */
+void vec_sort_intptr(Vec* self);
+
+/*!
+ * Returns the index of the first element that is not less than key, i.e.
+ * where key would be inserted before any equal elements. self->length if
+ * every element is less than key.
+ *
+ * The binary search has no data dependent branches, the halving step
+ * compiles to a conditional move.
+ *
+ * @pre the vector is sorted according to cmp
+ */
+size_t vec_lower_bound(Vec* self, ptr_t key, ptr_cmp_fn cmp, void* ctx);
+
+/*!
+ * Returns the index of the first element that is greater than key, i.e.
+ * where key would be inserted after any equal elements. self->length if no
+ * element is greater than key.
+ *
+ * @pre the vector is sorted according to cmp
+ */
+size_t vec_upper_bound(Vec* self, ptr_t key, ptr_cmp_fn cmp, void* ctx);
+
+/*!
+ * Inserts new_ele after every element that is not greater than it, so the
+ * vector stays sorted. O(log n) comparisons plus one move of the elements
+ * after it.
+ *
+ * @pre the vector is sorted according to cmp
+ * @returns the index new_ele was inserted at.
+ * @post If a resize is needed and it fails, then this function will panic()
+ */
+size_t vec_sorted_insert(Vec* self, ptr_t new_ele, ptr_cmp_fn cmp, void* ctx);
+
+/*!
+ * Inserts n elements so that the vector stays sorted. The batch is sorted
+ * and then merged into the vector in one pass from the back, so inserting k
+ * elements into a vector of length n takes O(n + k log k) instead of the
+ * O(n * k) of k calls to vec_sorted_insert.
+ *
+ * Inserted elements go after existing equal ones, like vec_sorted_insert.
+ *
+ * @param elems the elements to insert. The array is sorted in place.
+ * @param n     the number of elements in elems
+ * @pre the vector is sorted according to cmp
+ * @post If a resize is needed and it fails, then this function will panic()
+ */
+void vec_sorted_insert_batch(Vec* self,
+                             ptr_t* elems,
+                             size_t n,
+                             ptr_cmp_fn cmp,
+                             void* ctx);
+
+#endif  // VEC_SORT_H_
@@ -55,22 +55,286 @@
  *
  */
 
+#include <malloc.h>  // malloc_usable_size
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>  // malloc, realloc, free
+#include <string.h>  // memmove
+#include "./allocator.h"
+#include "./growth_policy.h"
 #include "./panic.h"
 
 // the destroy function takes in a pointer
 // to an element of the vector.
 typedef void (*destroy_fn)(void*);
 
+// Element 0 of a vector created with vector_new_aligned starts on a
+// boundary of this many bytes, a cache line and enough for any AVX load.
+#define VECTOR_ALIGNMENT ((size_t)64)
+
 typedef struct vector_info_st {
   size_t len;
   size_t capacity;
   destroy_fn ele_dtor;
+  growth_policy policy;
+  const Allocator* allocator;  // NULL for malloc/realloc/free
 } vector_info;
 
 #define vector(T) T*
 
+// Not part of the public interface, the functions of
+// vector_aligned_allocator below. `ctx` is the inner allocator, NULL for
+// malloc, and each block is carved out of an inner block this much bigger.
+#define VECTOR_IMPL_ALIGNED_LEAD (sizeof(size_t) + VECTOR_ALIGNMENT - 1)
+
+static inline void* vector_impl_aligned_alloc(void* ctx, size_t size) {
+  const Allocator* inner = (const Allocator*)ctx;
+  if (size > SIZE_MAX - VECTOR_IMPL_ALIGNED_LEAD) {
+    return NULL;
+  }
+  size_t total = size + VECTOR_IMPL_ALIGNED_LEAD;
+  char* base = inner != NULL ? (char*)inner->alloc_fn(inner->ctx, total)
+                             : (char*)malloc(total);
+  if (base == NULL) {
+    return NULL;
+  }
+
+  uintptr_t elems = (uintptr_t)base + sizeof(size_t) + sizeof(vector_info);
+  size_t pad = sizeof(size_t) +
+               (VECTOR_ALIGNMENT - elems % VECTOR_ALIGNMENT) % VECTOR_ALIGNMENT;
+  size_t* block = (size_t*)(base + pad);
+  block[-1] = pad;
+  return block;
+}
+
+static inline void vector_impl_aligned_free(void* ctx,
+                                            void* ptr,
+                                            size_t size) {
+  const Allocator* inner = (const Allocator*)ctx;
+  if (ptr == NULL) {
+    return;
+  }
+  char* base = (char*)ptr - ((size_t*)ptr)[-1];
+  if (inner != NULL) {
+    inner->free_fn(inner->ctx, base, size + VECTOR_IMPL_ALIGNED_LEAD);
+  } else {
+    free(base);
+  }
+}
+
+static inline void* vector_impl_aligned_realloc(void* ctx,
+                                                void* ptr,
+                                                size_t old_size,
+                                                size_t new_size) {
+  void* block = vector_impl_aligned_alloc(ctx, new_size);
+  if (block == NULL || ptr == NULL) {
+    return block;
+  }
+  memcpy(block, ptr, old_size < new_size ? old_size : new_size);
+  vector_impl_aligned_free(ctx, ptr, old_size);
+  return block;
+}
+
+// Synopsis:
+//   const Allocator* vector_aligned_allocator(Allocator* self,
+//                                             const Allocator* inner);
+//
+// Description:
+// Sets up `self` as an allocator for vector(T) that keeps element 0 on a
+// VECTOR_ALIGNMENT boundary, getting its memory from `inner` (malloc if
+// NULL). vector_new_aligned uses one over malloc; pass one to
+// vector_new_with_allocator to have aligned vectors in a Pool or any other
+// allocator. Both `self` and `inner` must outlive the vectors.
+//
+// Each block it returns (a vector_info followed by the elements) sits
+// inside a larger block from `inner`, placed so that the elements start on
+// the boundary. How far it is from the start of the inner block is kept in
+// a size_t just before it, so an aligned vector has the same header as any
+// other. Reallocating could move a block to a differently aligned address,
+// so growing allocates a new block and copies.
+//
+// returns:
+// - self
+//
+// example:
+// Allocator aligned;
+// vector(double) v = vector_new_with_allocator(
+//     double, 0, NULL, vector_aligned_allocator(&aligned, pool_allocator(p)));
+static inline const Allocator* vector_aligned_allocator(
+    Allocator* self,
+    const Allocator* inner) {
+  self->alloc_fn = vector_impl_aligned_alloc;
+  self->realloc_fn = vector_impl_aligned_realloc;
+  self->free_fn = vector_impl_aligned_free;
+  self->ctx = (void*)inner;
+  return self;
+}
+
+// Synopsis:
+//   const Allocator* vector_impl_aligned_allocator(void);
+//
+// Description:
+// Not part of the public interface, used by vector_new_aligned.
+// The aligned allocator over malloc.
+static inline const Allocator* vector_impl_aligned_allocator(void) {
+  static const Allocator aligned = {
+      vector_impl_aligned_alloc,
+      vector_impl_aligned_realloc,
+      vector_impl_aligned_free,
+      NULL,
+  };
+  return &aligned;
+}
+
+// Synopsis:
+//   void vector_impl_take_slack(vector_info* info, size_t ele_size);
+//
+// Description:
+// Not part of the public interface, used by the functions below.
+// If the policy of `info` uses usable size and the vector uses the default
+// allocator, turns any slack malloc left at the end of the block into
+// capacity.
+static inline void vector_impl_take_slack(vector_info* info,
+                                          size_t ele_size) {
+  if (info->policy.use_usable_size && info->allocator == NULL) {
+    size_t usable =
+        (malloc_usable_size(info) - sizeof(vector_info)) / ele_size;
+    if (usable > info->capacity) {
+      info->capacity = usable;
+    }
+  }
+}
+
+// Synopsis:
+//   vector_info* vector_impl_realloc(vector_info* info, size_t ele_size,
+//                                    size_t new_capacity);
+//
+// Description:
+// Not part of the public interface, used by the macros below.
+// Reallocates the header and element storage of a vector so that it can hold
+// `new_capacity` elements of `ele_size` bytes and updates the stored capacity.
+// `info` must not be NULL and its policy and allocator must be set. If the
+// policy uses usable size and the vector uses the default allocator, any
+// slack in the block returned by realloc becomes capacity.
+//
+// returns:
+// - the new header, or NULL if the allocation failed (info is then untouched)
+static inline vector_info* vector_impl_realloc(vector_info* info,
+                                               size_t ele_size,
+                                               size_t new_capacity) {
+  if (new_capacity > (SIZE_MAX - sizeof(vector_info)) / ele_size) {
+    return NULL;
+  }
+
+  const Allocator* alloc = info->allocator;
+  size_t new_size = sizeof(vector_info) + (new_capacity * ele_size);
+  vector_info* new_info = NULL;
+  if (alloc != NULL) {
+    size_t old_size = sizeof(vector_info) + (info->capacity * ele_size);
+    new_info =
+        (vector_info*)alloc->realloc_fn(alloc->ctx, info, old_size, new_size);
+  } else {
+    new_info = (vector_info*)realloc(info, new_size);
+  }
+  if (new_info == NULL) {
+    return NULL;
+  }
+
+  new_info->capacity = new_capacity;
+  vector_impl_take_slack(new_info, ele_size);
+  return new_info;
+}
+
+// Synopsis:
+//   vector_info* vector_impl_create(size_t ele_size, size_t init_capacity,
+//                                   destroy_fn dtor, growth_policy policy,
+//                                   const Allocator* alloc);
+//
+// Description:
+// Not part of the public interface, used by the macros below.
+// Allocates the header of a new empty vector from `alloc` (malloc if NULL)
+// with room for `init_capacity` elements of `ele_size` bytes, in a single
+// allocation.
+//
+// returns:
+// - the new header, or NULL if the allocation failed
+static inline vector_info* vector_impl_create(size_t ele_size,
+                                              size_t init_capacity,
+                                              destroy_fn dtor,
+                                              growth_policy policy,
+                                              const Allocator* alloc) {
+  if (init_capacity > (SIZE_MAX - sizeof(vector_info)) / ele_size) {
+    return NULL;
+  }
+
+  size_t size = sizeof(vector_info) + (init_capacity * ele_size);
+  vector_info* info = alloc != NULL
+                          ? (vector_info*)alloc->alloc_fn(alloc->ctx, size)
+                          : (vector_info*)malloc(size);
+  if (info == NULL) {
+    return NULL;
+  }
+
+  info->len = 0;
+  info->capacity = init_capacity;
+  info->ele_dtor = dtor;
+  info->policy = policy;
+  info->allocator = alloc;
+  vector_impl_take_slack(info, ele_size);
+  return info;
+}
+
+// Synopsis:
+//   void vector_impl_release(vector_info* info, size_t ele_size);
+//
+// Description:
+// Not part of the public interface, used by the macros below.
+// Returns the header and element storage of a vector to its allocator.
+// Elements are not destroyed.
+static inline void vector_impl_release(vector_info* info, size_t ele_size) {
+  const Allocator* alloc = info->allocator;
+  if (alloc != NULL) {
+    alloc->free_fn(alloc->ctx, info,
+                   sizeof(vector_info) + (info->capacity * ele_size));
+  } else {
+    free(info);
+  }
+}
+
+// Synopsis:
+//   void* vector_impl_grow_to(void* data, size_t ele_size, size_t needed);
+//
+// Description:
+// Not part of the public interface, used by vector_impl_grow.
+// Grows the vector whose elements start at `data` (NULL for an empty vector
+// without a header) according to its growth policy so that at least `needed`
+// elements of `ele_size` bytes fit, and panics if that fails. Kept out of
+// line: it is only reached when a vector is full.
+//
+// returns:
+// - the new start of the elements
+static inline __attribute__((noinline)) void* vector_impl_grow_to(
+    void* data,
+    size_t ele_size,
+    size_t needed) {
+  vector_info* info = data != NULL ? (vector_info*)data - 1 : NULL;
+  growth_policy policy = info != NULL ? info->policy : GROWTH_DOUBLE;
+  size_t capacity = info != NULL ? info->capacity : 0;
+  size_t new_capacity =
+      growth_next_capacity(&policy, capacity, needed, ele_size);
+
+  if (info == NULL) {
+    info = vector_impl_create(ele_size, new_capacity, NULL, GROWTH_DOUBLE,
+                              NULL);
+  } else {
+    info = vector_impl_realloc(info, ele_size, new_capacity);
+  }
+  if (info == NULL) {
+    panic("Memory allocation failed in vector_resize\n");
+  }
+  return info + 1;
+}
+
 // Synopsis:
 //  vector_info* get_vector_header(vector(T)* vec);
 //
@@ -113,9 +377,112 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = vector_new(int, 10, NULL);
 #define vector_new(T, init_capacity, dtor) \
-  ({                                       \
-    /* TODO */                             \
-    NULL;                                  \
+  vector_new_with_policy(T, init_capacity, dtor, GROWTH_DOUBLE)
+
+// Synopsis:
+//   vector(T) vector_new_with_policy(T, size_t initial_capacity,
+//                                    destroy_fn element_destroy_fn,
+//                                    growth_policy growth);
+//
+// Description:
+//
+// Same as vector_new, but the vector grows according to `growth` (see
+// growth_policy.h) instead of doubling. The policy is stored in the header
+// and used by every later vector_push, vector_insert and vector_resize.
+//
+// args:
+// - T: the type of the vector being created.
+// - init_capacity: the initial capacity of the vector. If the policy uses
+//                  usable size, the capacity may end up larger.
+// - dtor: the element destroy fn
+// - growth: the growth_policy of the vector
+//
+// returns:
+// - a newly allocated vector
+//
+// example:
+// vector(int) v = vector_new_with_policy(int, 0, NULL, GROWTH_1_5X);
+#define vector_new_with_policy(T, init_capacity, dtor, growth) \
+  ({                                                           \
+    vector_info* __impl_vn_info = vector_impl_create(          \
+        sizeof(T), (init_capacity), (dtor), (growth), NULL);   \
+    if (__impl_vn_info == NULL) {                              \
+      panic("Memory allocation failed in vector_new\n");       \
+    }                                                          \
+    (T*)(__impl_vn_info + 1);                                  \
+  })
+
+// Synopsis:
+//   vector(T) vector_new_with_allocator(T, size_t initial_capacity,
+//                                       destroy_fn element_destroy_fn,
+//                                       const Allocator* alloc);
+//
+// Description:
+//
+// Same as vector_new, but the header and elements are allocated from `alloc`
+// (see allocator.h) instead of malloc. The allocator is stored in the header,
+// every later reallocation and vector_free goes through it. It must outlive
+// the vector.
+//
+// args:
+// - T: the type of the vector being created.
+// - init_capacity: the initial capacity of the vector
+// - dtor: the element destroy fn
+// - alloc: the allocator to use, NULL means malloc
+//
+// returns:
+// - a newly allocated vector
+//
+// example:
+// Pool* pool = pool_new();
+// const Allocator* alloc = pool_allocator(pool);
+// vector(int) v = vector_new_with_allocator(int, 0, NULL, alloc);
+#define vector_new_with_allocator(T, init_capacity, dtor, alloc)     \
+  ({                                                                 \
+    vector_info* __impl_vna_info = vector_impl_create(               \
+        sizeof(T), (init_capacity), (dtor), GROWTH_DOUBLE, (alloc)); \
+    if (__impl_vna_info == NULL) {                                   \
+      panic("Memory allocation failed in vector_new\n");             \
+    }                                                                \
+    (T*)(__impl_vna_info + 1);                                       \
+  })
+
+// Synopsis:
+//   vector(T) vector_new_aligned(T, size_t initial_capacity,
+//                                destroy_fn element_destroy_fn);
+//
+// Description:
+//
+// Same as vector_new, but element 0 starts on a VECTOR_ALIGNMENT (64 byte)
+// boundary, and stays on one across every later reallocation. The block
+// is padded in front of the header to get there, which costs up to
+// VECTOR_ALIGNMENT + 7 bytes per vector, and growing always copies instead
+// of using realloc. The memory comes from malloc: for an aligned vector in
+// another allocator, use vector_new_with_allocator with a
+// vector_aligned_allocator. In return SIMD code can use aligned loads, and no
+// element of 64 bytes or a power of two smaller than that straddles a
+// cache line.
+//
+// args:
+// - T: the type of the vector being created.
+// - init_capacity: the initial capacity of the vector
+// - dtor: the element destroy fn
+//
+// returns:
+// - a newly allocated vector
+//
+// example:
+// vector(double) v = vector_new_aligned(double, 1024, NULL);
+// // (uintptr_t)v % VECTOR_ALIGNMENT == 0
+#define vector_new_aligned(T, init_capacity, dtor)                          \
+  ({                                                                        \
+    vector_info* __impl_vnal_info =                                         \
+        vector_impl_create(sizeof(T), (init_capacity), (dtor),              \
+                           GROWTH_DOUBLE, vector_impl_aligned_allocator()); \
+    if (__impl_vnal_info == NULL) {                                         \
+      panic("Memory allocation failed in vector_new\n");                    \
+    }                                                                       \
+    (T*)(__impl_vnal_info + 1);                                             \
   })
 
 // Synopsis:
@@ -134,10 +501,10 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // size_t len = vector_len(&v);
-#define vector_len(self) \
-  ({                     \
-    /* TODO */           \
-    0U;                  \
+#define vector_len(self)                                   \
+  ({                                                       \
+    vector_info* __impl_vl_info = get_vector_header(self); \
+    __impl_vl_info ? __impl_vl_info->len : (size_t)0;      \
   })
 
 // Synopsis:
@@ -156,10 +523,10 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // size_t len = vector_capacity(&v);
-#define vector_capacity(self) \
-  ({                          \
-    /* TODO */                \
-    0U;                       \
+#define vector_capacity(self)                              \
+  ({                                                       \
+    vector_info* __impl_vc_info = get_vector_header(self); \
+    __impl_vc_info ? __impl_vc_info->capacity : (size_t)0; \
   })
 
 // Synopsis:
@@ -179,7 +546,7 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // size_t ele_size = vector_element_size(&v); // same as sizeof(int)
-#define vector_element_size(self) (4 /* TODO */)
+#define vector_element_size(self) (sizeof(**(self)))
 
 // Synopsis:
 //   void vector_resize(vector(T)* self, size_t new_capacity);
@@ -191,6 +558,11 @@ typedef struct vector_info_st {
 // needed to hold more.
 //
 // If `new_capacity` is <= the current capacity, nothing is done.
+// If the vector's growth policy uses usable size, the resulting capacity can
+// be larger than `new_capacity`.
+//
+// A NULL vector gets a header with no element destructor and the default
+// growth policy.
 //
 // args:
 // - self: a pointer to the vector we want to resize
@@ -199,10 +571,44 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // vector_resize(&v, vector_capacity(&v) * 2);
-#define vector_resize(self, n)                   \
-  ({                                             \
-    /* TODO */                                   \
-    ((void)0); /* (optional) return "nothing" */ \
+#define vector_resize(self, n)                                              \
+  ({                                                                        \
+    typeof(self) __impl_vr_self = (self);                                   \
+    size_t __impl_vr_n = (n);                                               \
+    vector_info* __impl_vr_info = get_vector_header(__impl_vr_self);        \
+    if (__impl_vr_info == NULL || __impl_vr_n > __impl_vr_info->capacity) { \
+      if (__impl_vr_info == NULL) {                                         \
+        __impl_vr_info =                                                    \
+            vector_impl_create(vector_element_size(__impl_vr_self),         \
+                               __impl_vr_n, NULL, GROWTH_DOUBLE, NULL);     \
+      } else {                                                              \
+        __impl_vr_info = vector_impl_realloc(                               \
+            __impl_vr_info, vector_element_size(__impl_vr_self),            \
+            __impl_vr_n);                                                   \
+      }                                                                     \
+      if (__impl_vr_info == NULL) {                                         \
+        panic("Memory allocation failed in vector_resize\n");               \
+      }                                                                     \
+      *__impl_vr_self = (typeof(*__impl_vr_self))(__impl_vr_info + 1);      \
+    }                                                                       \
+    ((void)0);                                                              \
+  })
+
+// Synopsis:
+//   void vector_impl_grow(vector(T)* self, size_t needed);
+//
+// Description:
+// Not part of the public interface, used by the macros below.
+// Grows the capacity of the vector according to its growth policy so that
+// at least `needed` elements fit. The work is done out of line by
+// vector_impl_grow_to, so the push and insert macros only expand to a call
+// on their (rare) growing path.
+#define vector_impl_grow(self, needed)                                     \
+  ({                                                                       \
+    typeof(self) __impl_vgr_self = (self);                                 \
+    *__impl_vgr_self = (typeof(*__impl_vgr_self))vector_impl_grow_to(      \
+        *__impl_vgr_self, vector_element_size(__impl_vgr_self), (needed)); \
+    ((void)0);                                                             \
   })
 
 // Synopsis:
@@ -220,9 +626,14 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // vector_get(&v, 0); // Same thing as doing: v[0]; but with bounds checking
-#define vector_get(self, index) \
-  ({                            \
-      /* TODO */                \
+#define vector_get(self, index)                          \
+  ({                                                     \
+    typeof(self) __impl_vg_self = (self);                \
+    size_t __impl_vg_index = (index);                    \
+    if (__impl_vg_index >= vector_len(__impl_vg_self)) { \
+      panic("Index out of bounds in vector_get\n");      \
+    }                                                    \
+    (*__impl_vg_self)[__impl_vg_index];                  \
   })
 
 // Synopsis:
@@ -243,10 +654,19 @@ typedef struct vector_info_st {
 // vector_set(&v, 0, 3);
 //
 // // Same thing as doing: v[0] = 3; but with bounds checking
-#define vector_set(self, index, ...)             \
-  ({                                             \
-    /* TODO */                                   \
-    ((void)0); /* (optional) return "nothing" */ \
+#define vector_set(self, index, ...)                                 \
+  ({                                                                 \
+    typeof(self) __impl_vs_self = (self);                            \
+    size_t __impl_vs_index = (index);                                \
+    if (__impl_vs_index >= vector_len(__impl_vs_self)) {             \
+      panic("Index out of bounds in vector_set\n");                  \
+    }                                                                \
+    vector_info* __impl_vs_info = get_vector_header(__impl_vs_self); \
+    if (__impl_vs_info->ele_dtor != NULL) {                          \
+      __impl_vs_info->ele_dtor(&(*__impl_vs_self)[__impl_vs_index]); \
+    }                                                                \
+    (*__impl_vs_self)[__impl_vs_index] = (__VA_ARGS__);              \
+    ((void)0);                                                       \
   })
 
 // Synopsis:
@@ -258,6 +678,8 @@ typedef struct vector_info_st {
 // If after the operation the new length is greater than the old capacity
 // then a reallocation takes place and all elements are copied over. Any
 // pointers to elements prior to this reallocation are invalid..
+// Capacity grows as specified by the vector's growth policy (doubled by
+// default).
 //
 // args:
 // - self: a pointer to the vector we want to push onto
@@ -266,12 +688,80 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // vector_push(&v, 3);
-#define vector_push(self, ...)                   \
-  ({                                             \
-    /* TODO */                                   \
-    ((void)0); /* (optional) return "nothing" */ \
+#define vector_push(self, ...)                                  \
+  ({                                                            \
+    typeof(self) __impl_vp_self = (self);                       \
+    size_t __impl_vp_len = vector_len(__impl_vp_self);          \
+    if (__impl_vp_len == vector_capacity(__impl_vp_self)) {     \
+      vector_impl_grow(__impl_vp_self, __impl_vp_len + 1);      \
+    }                                                           \
+    (*__impl_vp_self)[__impl_vp_len] = (__VA_ARGS__);           \
+    get_vector_header(__impl_vp_self)->len = __impl_vp_len + 1; \
+    ((void)0);                                                  \
+  })
+
+// Synopsis:
+//   T* vector_push_n_uninit(vector(T)* self, size_t n);
+//
+// Description:
+// Appends n uninitialized elements to the end of the vector and returns a
+// pointer to the first of them, so they can be filled in place (e.g. by
+// read() or memcpy) instead of being built elsewhere and copied in. Grows
+// the vector like vector_push, at most once.
+// The new elements count towards the length right away: they must be set
+// before anything reads them or destroys them (vector_pop, vector_erase,
+// vector_set, vector_free). The pointer is valid until the next operation
+// that can reallocate the vector.
+// panic()'s if the new length would overflow or a needed resize fails.
+//
+// args:
+// - self: a pointer to the vector we want to append to
+// - n: the number of elements to append
+//
+// returns:
+// - a pointer to the first new element, NULL if n is 0 and the vector has
+//   no storage
+//
+// example:
+// vector(char) buf = ...;
+// char* dst = vector_push_n_uninit(&buf, 4096);
+// ssize_t got = read(fd, dst, 4096);
+#define vector_push_n_uninit(self, n)                                          \
+  ({                                                                           \
+    typeof(self) __impl_vpn_self = (self);                                     \
+    size_t __impl_vpn_n = (n);                                                 \
+    size_t __impl_vpn_len = vector_len(__impl_vpn_self);                       \
+    if (__impl_vpn_n > SIZE_MAX - __impl_vpn_len) {                            \
+      panic("Length overflow in vector_push_n_uninit\n");                      \
+    }                                                                          \
+    if (__impl_vpn_len + __impl_vpn_n > vector_capacity(__impl_vpn_self)) {    \
+      vector_impl_grow(__impl_vpn_self, __impl_vpn_len + __impl_vpn_n);        \
+    }                                                                          \
+    if (*__impl_vpn_self != NULL) {                                            \
+      get_vector_header(__impl_vpn_self)->len = __impl_vpn_len + __impl_vpn_n; \
+    }                                                                          \
+    *__impl_vpn_self == NULL ? *__impl_vpn_self                                \
+                             : &(*__impl_vpn_self)[__impl_vpn_len];            \
   })
 
+// Synopsis:
+//   T* vector_emplace_back(vector(T)* self);
+//
+// Description:
+// Appends one uninitialized element to the end of the vector and returns a
+// pointer to it, to be filled in place. Same as vector_push_n_uninit(self,
+// 1), see there for when the element has to be set by. Never NULL.
+//
+// args:
+// - self: a pointer to the vector we want to append to
+//
+// example:
+// vector(Record) v = ...;
+// Record* r = vector_emplace_back(&v);
+// r->id = 7;
+// parse_record(line, r);
+#define vector_emplace_back(self) vector_push_n_uninit(self, 1)
+
 // Synopsis:
 //   bool vector_pop(vector(T)* self);
 //
@@ -284,10 +774,20 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // bool success = vector_pop(&v);
-#define vector_pop(self)                         \
-  ({                                             \
-    /* TODO */                                   \
-    ((void)0); /* (optional) return "nothing" */ \
+#define vector_pop(self)                                                 \
+  ({                                                                     \
+    typeof(self) __impl_vpop_self = (self);                              \
+    vector_info* __impl_vpop_info = get_vector_header(__impl_vpop_self); \
+    bool __impl_vpop_res = false;                                        \
+    if (__impl_vpop_info != NULL && __impl_vpop_info->len > 0) {         \
+      __impl_vpop_info->len--;                                           \
+      if (__impl_vpop_info->ele_dtor != NULL) {                          \
+        __impl_vpop_info->ele_dtor(                                      \
+            &(*__impl_vpop_self)[__impl_vpop_info->len]);                \
+      }                                                                  \
+      __impl_vpop_res = true;                                            \
+    }                                                                    \
+    __impl_vpop_res;                                                     \
   })
 
 // Synopsis:
@@ -314,10 +814,24 @@ typedef struct vector_info_st {
 // /* if v = {3, 2, 4}; */
 // vector_insert(&v, 1, 6);
 // /* after: v = {3, 6, 2, 4}; */
-#define vector_insert(vec, index, ...)           \
-  ({                                             \
-    /* TODO */                                   \
-    ((void)0); /* (optional) return "nothing" */ \
+#define vector_insert(vec, index, ...)                          \
+  ({                                                            \
+    typeof(vec) __impl_vi_self = (vec);                         \
+    size_t __impl_vi_index = (index);                           \
+    size_t __impl_vi_len = vector_len(__impl_vi_self);          \
+    if (__impl_vi_index > __impl_vi_len) {                      \
+      panic("Index out of bounds in vector_insert\n");          \
+    }                                                           \
+    if (__impl_vi_len == vector_capacity(__impl_vi_self)) {     \
+      vector_impl_grow(__impl_vi_self, __impl_vi_len + 1);      \
+    }                                                           \
+    memmove(&(*__impl_vi_self)[__impl_vi_index + 1],            \
+            &(*__impl_vi_self)[__impl_vi_index],                \
+            (__impl_vi_len - __impl_vi_index) *                 \
+                vector_element_size(__impl_vi_self));           \
+    (*__impl_vi_self)[__impl_vi_index] = (__VA_ARGS__);         \
+    get_vector_header(__impl_vi_self)->len = __impl_vi_len + 1; \
+    ((void)0);                                                  \
   })
 
 // Synopsis:
@@ -338,10 +852,23 @@ typedef struct vector_info_st {
 // /* if v = {3, 2, 4}; */
 // vector_erase(&v, 2);
 // /* after: v = {3, 2}; */
-#define vector_erase(vec, index)                 \
-  ({                                             \
-    /* TODO */                                   \
-    ((void)0); /* (optional) return "nothing" */ \
+#define vector_erase(vec, index)                                     \
+  ({                                                                 \
+    typeof(vec) __impl_ve_self = (vec);                              \
+    size_t __impl_ve_index = (index);                                \
+    if (__impl_ve_index >= vector_len(__impl_ve_self)) {             \
+      panic("Index out of bounds in vector_erase\n");                \
+    }                                                                \
+    vector_info* __impl_ve_info = get_vector_header(__impl_ve_self); \
+    if (__impl_ve_info->ele_dtor != NULL) {                          \
+      __impl_ve_info->ele_dtor(&(*__impl_ve_self)[__impl_ve_index]); \
+    }                                                                \
+    memmove(&(*__impl_ve_self)[__impl_ve_index],                     \
+            &(*__impl_ve_self)[__impl_ve_index + 1],                 \
+            (__impl_ve_info->len - __impl_ve_index - 1) *            \
+                vector_element_size(__impl_ve_self));                \
+    __impl_ve_info->len--;                                           \
+    ((void)0);                                                       \
   })
 
 // Synopsis:
@@ -357,9 +884,96 @@ typedef struct vector_info_st {
 // example:
 // vector(int) v = ...;
 // vector_free(&v);
-#define vector_free(self) \
-  ({                      \
-      /* TODO */          \
+#define vector_free(self)                                               \
+  ({                                                                    \
+    typeof(self) __impl_vf_self = (self);                               \
+    vector_info* __impl_vf_info = get_vector_header(__impl_vf_self);    \
+    if (__impl_vf_info != NULL) {                                       \
+      if (__impl_vf_info->ele_dtor != NULL) {                           \
+        for (size_t __impl_vf_i = 0; __impl_vf_i < __impl_vf_info->len; \
+             __impl_vf_i++) {                                           \
+          __impl_vf_info->ele_dtor(&(*__impl_vf_self)[__impl_vf_i]);    \
+        }                                                               \
+      }                                                                 \
+      vector_impl_release(__impl_vf_info,                               \
+                          vector_element_size(__impl_vf_self));         \
+      *__impl_vf_self = NULL;                                           \
+    }                                                                   \
+    ((void)0);                                                          \
   })
 
+// Synopsis:
+//   VECTOR_DECLARE(T, name)
+//   VECTOR_DEFINE(T, name)
+//
+// Description:
+// Generates out of line functions for vectors of one element type. Every
+// macro above expands in full at each call site, which adds up in big
+// translation units. The generated functions hold the only expansion for T,
+// with sizeof(T) a constant, and each call site is a plain call:
+//
+//   void name_push(vector(T)* self, T new_element);
+//   T* name_emplace_back(vector(T)* self);
+//   T* name_push_n_uninit(vector(T)* self, size_t n);
+//   bool name_pop(vector(T)* self);
+//   void name_insert(vector(T)* self, size_t index, T new_element);
+//   void name_erase(vector(T)* self, size_t index);
+//   void name_resize(vector(T)* self, size_t new_capacity);
+//   void name_free(vector(T)* self);
+//
+// They behave exactly like the macros of the same name (vector_push, ...)
+// and work on the same vectors, so the two can be mixed freely.
+// VECTOR_DECLARE goes in a header, VECTOR_DEFINE in exactly one source file.
+// T has to be a type name that can be followed by `*`, use a typedef for
+// arrays and function pointers.
+//
+// args:
+// - T: the element type
+// - name: the prefix of the generated functions
+//
+// example:
+// // point_vec.h
+// VECTOR_DECLARE(Point, point_vec)
+// // point_vec.c
+// VECTOR_DEFINE(Point, point_vec)
+// // anywhere
+// vector(Point) v = vector_new(Point, 0, NULL);
+// point_vec_push(&v, (Point){1, 2});
+// point_vec_free(&v);
+#define VECTOR_DECLARE(T, name)                              \
+  void name##_push(T** self, T new_element);                 \
+  T* name##_emplace_back(T** self);                          \
+  T* name##_push_n_uninit(T** self, size_t n);               \
+  bool name##_pop(T** self);                                 \
+  void name##_insert(T** self, size_t index, T new_element); \
+  void name##_erase(T** self, size_t index);                 \
+  void name##_resize(T** self, size_t new_capacity);         \
+  void name##_free(T** self);
+
+#define VECTOR_DEFINE(T, name)                                \
+  void name##_push(T** self, T new_element) {                 \
+    vector_push(self, new_element);                           \
+  }                                                           \
+  T* name##_emplace_back(T** self) {                          \
+    return vector_emplace_back(self);                         \
+  }                                                           \
+  T* name##_push_n_uninit(T** self, size_t n) {               \
+    return vector_push_n_uninit(self, n);                     \
+  }                                                           \
+  bool name##_pop(T** self) {                                 \
+    return vector_pop(self);                                  \
+  }                                                           \
+  void name##_insert(T** self, size_t index, T new_element) { \
+    vector_insert(self, index, new_element);                  \
+  }                                                           \
+  void name##_erase(T** self, size_t index) {                 \
+    vector_erase(self, index);                                \
+  }                                                           \
+  void name##_resize(T** self, size_t new_capacity) {         \
+    vector_resize(self, new_capacity);                        \
+  }                                                           \
+  void name##_free(T** self) {                                \
+    vector_free(self);                                        \
+  }
+
 #endif  // VECTOR_H_
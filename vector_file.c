@@ -0,0 +1,258 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE  // for mkostemp
+#endif
+#include "./vector_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "./panic.h"
+
+#define HEADER_SIZE sizeof(vector_file_header)
+// mkostemp template appended to the path being saved
+#define TMP_SUFFIX ".XXXXXX"
+#define FILE_MODE 0644
+
+// multiplier of the 64 bit FNV hash, used per word instead of per byte
+#define CHECKSUM_PRIME 0x100000001b3ULL
+#define CHECKSUM_SEED 0xcbf29ce484222325ULL
+
+_Static_assert(sizeof(vector_file_header) == 64,
+               "the file header should be 64 bytes");
+_Static_assert(VECTOR_FILE_DATA_OFFSET % VECTOR_ALIGNMENT == 0,
+               "elements in a file should be aligned like vector_new_aligned");
+_Static_assert(VECTOR_FILE_DATA_OFFSET - HEADER_SIZE >= sizeof(vector_info),
+               "a vector_info should fit between the header and elements");
+
+// --- the allocator of mapped vectors ---
+
+// The block a vector's allocator sees starts at its vector_info, the
+// mapping starts VECTOR_FILE_DATA_OFFSET - sizeof(vector_info) before it.
+static void vector_file_unmap(void* ctx, void* ptr, size_t size) {
+  (void)ctx;
+  if (ptr == NULL) {
+    return;
+  }
+  size_t lead = VECTOR_FILE_DATA_OFFSET - sizeof(vector_info);
+  munmap((char*)ptr - lead, size + lead);
+}
+
+static void* vector_file_no_alloc(void* ctx, size_t size) {
+  (void)ctx;
+  (void)size;
+  panic("Cannot grow a vector loaded from a file\n");
+  return NULL;
+}
+
+static void* vector_file_no_realloc(void* ctx,
+                                    void* ptr,
+                                    size_t old_size,
+                                    size_t new_size) {
+  (void)ctx;
+  (void)ptr;
+  (void)old_size;
+  (void)new_size;
+  panic("Cannot grow a vector loaded from a file\n");
+  return NULL;
+}
+
+static const Allocator mapped_allocator = {
+    vector_file_no_alloc,
+    vector_file_no_realloc,
+    vector_file_unmap,
+    NULL,
+};
+
+// --- checksum ---
+
+uint64_t vector_file_checksum(const void* data, size_t size) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t hash = CHECKSUM_SEED ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    memcpy(&word, &bytes[i], sizeof(word));
+    hash = (hash ^ word) * CHECKSUM_PRIME;
+    hash ^= hash >> 32;
+  }
+  if (i < size) {
+    uint64_t word = 0;
+    memcpy(&word, &bytes[i], size - i);
+    hash = (hash ^ word) * CHECKSUM_PRIME;
+    hash ^= hash >> 32;
+  }
+  return hash;
+}
+
+// --- writing ---
+
+// Writes every iovec, retrying after short writes and interrupts.
+static bool write_all(int fd, struct iovec* iov, int count) {
+  while (count > 0) {
+    ssize_t written = writev(fd, iov, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    size_t left = (size_t)written;
+    while (count > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0) {
+      iov->iov_base = (char*)iov->iov_base + left;
+      iov->iov_len -= left;
+    }
+  }
+  return true;
+}
+
+bool vector_file_write(const char* path,
+                       const void* data,
+                       size_t len,
+                       size_t ele_size) {
+  if (ele_size == 0 || len > SIZE_MAX / ele_size) {
+    errno = EINVAL;
+    return false;
+  }
+  size_t size = len * ele_size;
+
+  unsigned char head[VECTOR_FILE_DATA_OFFSET] = {0};
+  vector_file_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, VECTOR_FILE_MAGIC, sizeof(VECTOR_FILE_MAGIC));
+  header.version = VECTOR_FILE_VERSION;
+  header.data_offset = VECTOR_FILE_DATA_OFFSET;
+  header.ele_size = ele_size;
+  header.length = len;
+  header.checksum = vector_file_checksum(data, size);
+  memcpy(head, &header, sizeof(header));
+
+  size_t path_len = strlen(path);
+  char* tmp_path = (char*)malloc(path_len + sizeof(TMP_SUFFIX));
+  if (tmp_path == NULL) {
+    panic("Memory allocation failed in vector_file_write\n");
+    return false;
+  }
+  memcpy(tmp_path, path, path_len);
+  memcpy(tmp_path + path_len, TMP_SUFFIX, sizeof(TMP_SUFFIX));
+
+  // a name of its own, so concurrent saves to one path never share a file
+  int fd = mkostemp(tmp_path, O_CLOEXEC);
+  if (fd < 0) {
+    free(tmp_path);
+    return false;
+  }
+
+  struct iovec iov[2] = {
+      {head, sizeof(head)},
+      {(void*)data, size},
+  };
+  // mkostemp creates the file 0600
+  bool ok = fchmod(fd, FILE_MODE) == 0;
+  ok = ok && write_all(fd, iov, 2);
+  // on disk before the rename, or a crash could leave a truncated file
+  ok = ok && fsync(fd) == 0;
+  ok = close(fd) == 0 && ok;
+  ok = ok && rename(tmp_path, path) == 0;
+  if (!ok) {
+    int saved = errno;
+    unlink(tmp_path);
+    errno = saved;
+  }
+  free(tmp_path);
+  return ok;
+}
+
+// --- loading ---
+
+static bool header_matches(const vector_file_header* header,
+                           size_t file_size,
+                           size_t ele_size) {
+  if (memcmp(header->magic, VECTOR_FILE_MAGIC, sizeof(VECTOR_FILE_MAGIC)) !=
+          0 ||
+      header->version != VECTOR_FILE_VERSION ||
+      header->data_offset != VECTOR_FILE_DATA_OFFSET ||
+      header->ele_size != ele_size) {
+    return false;
+  }
+  size_t data_size = file_size - VECTOR_FILE_DATA_OFFSET;
+  return header->length <= data_size / ele_size &&
+         header->length * ele_size == data_size;
+}
+
+bool vector_file_map(const char* path, size_t ele_size, void** out) {
+  if (ele_size == 0) {
+    errno = EINVAL;
+    return false;
+  }
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return false;
+  }
+  if ((uint64_t)st.st_size < VECTOR_FILE_DATA_OFFSET ||
+      (uint64_t)st.st_size > SIZE_MAX) {
+    close(fd);
+    errno = EINVAL;
+    return false;
+  }
+
+  // private and writable so the vector_info can be written into the
+  // mapping, which copies just that page
+  size_t size = (size_t)st.st_size;
+  char* base = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                           fd, 0);
+  int saved = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    errno = saved;
+    return false;
+  }
+
+  const vector_file_header* header = (const vector_file_header*)base;
+  if (!header_matches(header, size, ele_size)) {
+    munmap(base, size);
+    errno = EINVAL;
+    return false;
+  }
+
+  vector_info* info =
+      (vector_info*)(base + VECTOR_FILE_DATA_OFFSET - sizeof(vector_info));
+  memset(info, 0, sizeof(vector_info));
+  info->len = (size_t)header->length;
+  info->capacity = (size_t)header->length;
+  info->ele_dtor = NULL;
+  info->policy = GROWTH_DOUBLE;
+  info->allocator = &mapped_allocator;
+  if (mprotect(base, size, PROT_READ) != 0) {
+    saved = errno;
+    munmap(base, size);
+    errno = saved;
+    return false;
+  }
+
+  *out = base + VECTOR_FILE_DATA_OFFSET;
+  return true;
+}
+
+bool vector_file_verify(const void* elements) {
+  const char* base = (const char*)elements - VECTOR_FILE_DATA_OFFSET;
+  const vector_file_header* header = (const vector_file_header*)base;
+  return vector_file_checksum(elements, header->length * header->ele_size) ==
+         header->checksum;
+}
@@ -0,0 +1,152 @@
+#ifndef VECTOR_FILE_H_
+#define VECTOR_FILE_H_
+
+/*!
+ * Saving a vector(T) (see vector.h) to a file and loading it back without
+ * copying or pushing its elements again.
+ *
+ * A file is laid out as
+ *
+ *   offset 0                         vector_file_header (64 bytes)
+ *   offset 64                        reserved, zero
+ *   offset VECTOR_FILE_DATA_OFFSET   the elements, as they are in memory
+ *
+ * vector_load maps the file with mmap. The reserved bytes sit right before
+ * the elements, where a vector keeps its vector_info, and the loader fills
+ * one in there, so the mapping is a vector(T) that the usual read-only
+ * macros (vector_len, vector_get, indexing) work on. Only the page holding
+ * that header is copied, the elements are read from the page cache as they
+ * are touched, so loading costs the same however long the vector is.
+ *
+ * The loaded vector is read-only:
+ *   - writing to it (v[i] = x, vector_set, vector_pop, vector_erase) faults
+ *     with SIGSEGV
+ *   - anything that grows it (vector_push, vector_insert, vector_resize)
+ *     panics
+ *   - vector_free unmaps it
+ *
+ * Files are written in the byte order and struct layout of the machine, and
+ * only element types without pointers survive a reload. The header has a
+ * checksum of the element bytes, which vector_file_verify checks (reading
+ * every page); vector_load only checks the header.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>  // for size_t
+#include <stdint.h>
+#include "./vector.h"
+
+/* The first 8 bytes of every file. */
+#define VECTOR_FILE_MAGIC "VECFILE"
+
+/* Version of the layout described above. */
+#define VECTOR_FILE_VERSION 1U
+
+/* Offset of element 0 in a file, a multiple of VECTOR_ALIGNMENT. */
+#define VECTOR_FILE_DATA_OFFSET 192U
+
+typedef struct vector_file_header_st {
+  char magic[8];         // VECTOR_FILE_MAGIC, NUL terminated
+  uint32_t version;      // VECTOR_FILE_VERSION
+  uint32_t data_offset;  // VECTOR_FILE_DATA_OFFSET
+  uint64_t ele_size;     // sizeof(T)
+  uint64_t length;       // number of elements
+  uint64_t checksum;     // vector_file_checksum of the element bytes
+  uint8_t reserved[24];  // zero
+} vector_file_header;
+
+// Synopsis:
+//   bool vector_file_write(const char* path, const void* data, size_t len,
+//                          size_t ele_size);
+//
+// Description:
+// Writes `len` elements of `ele_size` bytes starting at `data` to a new
+// file at `path`, use vector_save for a vector(T). The header and the
+// elements go out in one writev call (more only if the kernel writes less
+// than asked). The file is written next to `path` under a unique
+// temporary name (mkostemp), flushed with fsync and renamed over it. Vectors
+// loaded from an older file at `path` stay valid. Concurrent saves to the
+// same path never mix their contents, and the last rename wins.
+//
+// returns:
+// - true on success, false with errno set if the file could not be written
+bool vector_file_write(const char* path,
+                       const void* data,
+                       size_t len,
+                       size_t ele_size);
+
+// Synopsis:
+//   bool vector_file_map(const char* path, size_t ele_size, void** out);
+//
+// Description:
+// Maps a file written by vector_file_write and sets *out to its elements,
+// use vector_load for a vector(T).
+//
+// returns:
+// - true on success. false with errno set if the file can't be opened or
+//   mapped, EINVAL if it isn't a vector file of this version, or its
+//   elements aren't `ele_size` bytes, or its size doesn't match its header.
+bool vector_file_map(const char* path, size_t ele_size, void** out);
+
+// Synopsis:
+//   bool vector_save(vector(T)* self, const char* path);
+//
+// Description:
+// Writes the elements of the vector to a file, see vector_file_write.
+// A NULL vector is saved as an empty one.
+//
+// returns:
+// - true on success, false with errno set otherwise
+//
+// example:
+// vector(Point) v = ...;
+// if (!vector_save(&v, "points.vec")) {
+//   perror("vector_save");
+// }
+#define vector_save(self, path)                        \
+  vector_file_write((path), *(self), vector_len(self), \
+                    vector_element_size(self))
+
+// Synopsis:
+//   bool vector_load(vector(T)* self, const char* path);
+//
+// Description:
+// Maps a file written by vector_save into *self, without reading the
+// elements. The result is read-only, see the top of this file, and must be
+// released with vector_free. *self is not changed if loading fails.
+//
+// returns:
+// - true on success, false with errno set otherwise (see vector_file_map)
+//
+// example:
+// vector(Point) v = NULL;
+// if (!vector_load(&v, "points.vec")) {
+//   ... rebuild v ...
+// }
+#define vector_load(self, path) \
+  vector_file_map((path), vector_element_size(self), (void**)(self))
+
+// Synopsis:
+//   uint64_t vector_file_checksum(const void* data, size_t size);
+//
+// Description:
+// The checksum stored in a file header: a 64 bit multiply-xor hash of
+// `size` bytes, 8 bytes at a time.
+uint64_t vector_file_checksum(const void* data, size_t size);
+
+// Synopsis:
+//   bool vector_file_verify(const void* elements);
+//
+// Description:
+// Checks a vector returned by vector_load against the checksum in its file
+// header. Reads every element, so every page of the file.
+//
+// returns:
+// - true iff the elements match the checksum
+//
+// example:
+// vector(Point) v = NULL;
+// if (vector_load(&v, "points.vec") && !vector_file_verify(v)) { ... }
+bool vector_file_verify(const void* elements);
+
+#endif  // VECTOR_FILE_H_
@@ -0,0 +1,262 @@
+#include "./vector_simd.h"
+#include <math.h>  // for INFINITY
+#include <stdint.h>
+
+#if defined(__x86_64__) && !defined(VEC_DISABLE_SIMD)
+#define VECTOR_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Alignment of a 256 bit load.
+#define AVX_ALIGN 32
+
+typedef enum reduce_op_e {
+  REDUCE_SUM,
+  REDUCE_MIN,
+  REDUCE_MAX,
+} reduce_op;
+
+static size_t vector_simd_len(const void* data) {
+  return data != NULL ? ((const vector_info*)data - 1)->len : 0;
+}
+
+static double identity_f64(reduce_op op) {
+  switch (op) {
+    case REDUCE_MIN:
+      return INFINITY;
+    case REDUCE_MAX:
+      return -INFINITY;
+    default:
+      return 0.0;
+  }
+}
+
+static double apply_f64(reduce_op op, double acc, double x) {
+  switch (op) {
+    case REDUCE_MIN:
+      return x < acc ? x : acc;
+    case REDUCE_MAX:
+      return x > acc ? x : acc;
+    default:
+      return acc + x;
+  }
+}
+
+static float apply_f32(reduce_op op, float acc, float x) {
+  switch (op) {
+    case REDUCE_MIN:
+      return x < acc ? x : acc;
+    case REDUCE_MAX:
+      return x > acc ? x : acc;
+    default:
+      return acc + x;
+  }
+}
+
+// --- scalar ---
+
+static double reduce_scalar_f64(const double* data, size_t n, reduce_op op) {
+  double acc = identity_f64(op);
+  for (size_t i = 0; i < n; i++) {
+    acc = apply_f64(op, acc, data[i]);
+  }
+  return acc;
+}
+
+static float reduce_scalar_f32(const float* data, size_t n, reduce_op op) {
+  float acc = (float)identity_f64(op);
+  for (size_t i = 0; i < n; i++) {
+    acc = apply_f32(op, acc, data[i]);
+  }
+  return acc;
+}
+
+#ifdef VECTOR_SIMD_X86
+
+// --- AVX ---
+
+// Each step reads four vectors, 16 doubles or 32 floats, into four
+// independent accumulators. The kernels are always inlined into the
+// per-operation wrappers below, so `op` is a constant and the switches
+// fold away.
+
+__attribute__((target("avx"), always_inline)) static inline __m256d
+apply_avx_f64(reduce_op op, __m256d acc, __m256d x) {
+  switch (op) {
+    case REDUCE_MIN:
+      return _mm256_min_pd(acc, x);
+    case REDUCE_MAX:
+      return _mm256_max_pd(acc, x);
+    default:
+      return _mm256_add_pd(acc, x);
+  }
+}
+
+__attribute__((target("avx"), always_inline)) static inline __m256
+apply_avx_f32(reduce_op op, __m256 acc, __m256 x) {
+  switch (op) {
+    case REDUCE_MIN:
+      return _mm256_min_ps(acc, x);
+    case REDUCE_MAX:
+      return _mm256_max_ps(acc, x);
+    default:
+      return _mm256_add_ps(acc, x);
+  }
+}
+
+__attribute__((target("avx"), always_inline)) static inline double
+reduce_avx_f64(const double* data, size_t n, reduce_op op) {
+  double acc = identity_f64(op);
+  size_t i = 0;
+  // nothing to do here for an aligned vector
+  for (; i < n && (uintptr_t)&data[i] % AVX_ALIGN != 0; i++) {
+    acc = apply_f64(op, acc, data[i]);
+  }
+
+  __m256d a0 = _mm256_set1_pd(identity_f64(op));
+  __m256d a1 = a0;
+  __m256d a2 = a0;
+  __m256d a3 = a0;
+  for (; i + 16 <= n; i += 16) {
+    a0 = apply_avx_f64(op, a0, _mm256_load_pd(&data[i]));
+    a1 = apply_avx_f64(op, a1, _mm256_load_pd(&data[i + 4]));
+    a2 = apply_avx_f64(op, a2, _mm256_load_pd(&data[i + 8]));
+    a3 = apply_avx_f64(op, a3, _mm256_load_pd(&data[i + 12]));
+  }
+  a0 = apply_avx_f64(op, apply_avx_f64(op, a0, a1),
+                     apply_avx_f64(op, a2, a3));
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, a0);
+  for (size_t l = 0; l < 4; l++) {
+    acc = apply_f64(op, acc, lanes[l]);
+  }
+  for (; i < n; i++) {
+    acc = apply_f64(op, acc, data[i]);
+  }
+  return acc;
+}
+
+__attribute__((target("avx"), always_inline)) static inline float
+reduce_avx_f32(const float* data, size_t n, reduce_op op) {
+  float acc = (float)identity_f64(op);
+  size_t i = 0;
+  for (; i < n && (uintptr_t)&data[i] % AVX_ALIGN != 0; i++) {
+    acc = apply_f32(op, acc, data[i]);
+  }
+
+  __m256 a0 = _mm256_set1_ps((float)identity_f64(op));
+  __m256 a1 = a0;
+  __m256 a2 = a0;
+  __m256 a3 = a0;
+  for (; i + 32 <= n; i += 32) {
+    a0 = apply_avx_f32(op, a0, _mm256_load_ps(&data[i]));
+    a1 = apply_avx_f32(op, a1, _mm256_load_ps(&data[i + 8]));
+    a2 = apply_avx_f32(op, a2, _mm256_load_ps(&data[i + 16]));
+    a3 = apply_avx_f32(op, a3, _mm256_load_ps(&data[i + 24]));
+  }
+  a0 = apply_avx_f32(op, apply_avx_f32(op, a0, a1),
+                     apply_avx_f32(op, a2, a3));
+
+  float lanes[8];
+  _mm256_storeu_ps(lanes, a0);
+  for (size_t l = 0; l < 8; l++) {
+    acc = apply_f32(op, acc, lanes[l]);
+  }
+  for (; i < n; i++) {
+    acc = apply_f32(op, acc, data[i]);
+  }
+  return acc;
+}
+
+__attribute__((target("avx"))) static double sum_avx_f64(const double* data,
+                                                         size_t n) {
+  return reduce_avx_f64(data, n, REDUCE_SUM);
+}
+
+__attribute__((target("avx"))) static double min_avx_f64(const double* data,
+                                                         size_t n) {
+  return reduce_avx_f64(data, n, REDUCE_MIN);
+}
+
+__attribute__((target("avx"))) static double max_avx_f64(const double* data,
+                                                         size_t n) {
+  return reduce_avx_f64(data, n, REDUCE_MAX);
+}
+
+__attribute__((target("avx"))) static float sum_avx_f32(const float* data,
+                                                        size_t n) {
+  return reduce_avx_f32(data, n, REDUCE_SUM);
+}
+
+__attribute__((target("avx"))) static float min_avx_f32(const float* data,
+                                                        size_t n) {
+  return reduce_avx_f32(data, n, REDUCE_MIN);
+}
+
+__attribute__((target("avx"))) static float max_avx_f32(const float* data,
+                                                        size_t n) {
+  return reduce_avx_f32(data, n, REDUCE_MAX);
+}
+
+#endif  // VECTOR_SIMD_X86
+
+double vector_sum_f64(vector(double) * self) {
+  size_t n = vector_simd_len(*self);
+#ifdef VECTOR_SIMD_X86
+  if (__builtin_cpu_supports("avx")) {
+    return sum_avx_f64(*self, n);
+  }
+#endif
+  return reduce_scalar_f64(*self, n, REDUCE_SUM);
+}
+
+double vector_min_f64(vector(double) * self) {
+  size_t n = vector_simd_len(*self);
+#ifdef VECTOR_SIMD_X86
+  if (__builtin_cpu_supports("avx")) {
+    return min_avx_f64(*self, n);
+  }
+#endif
+  return reduce_scalar_f64(*self, n, REDUCE_MIN);
+}
+
+double vector_max_f64(vector(double) * self) {
+  size_t n = vector_simd_len(*self);
+#ifdef VECTOR_SIMD_X86
+  if (__builtin_cpu_supports("avx")) {
+    return max_avx_f64(*self, n);
+  }
+#endif
+  return reduce_scalar_f64(*self, n, REDUCE_MAX);
+}
+
+float vector_sum_f32(vector(float) * self) {
+  size_t n = vector_simd_len(*self);
+#ifdef VECTOR_SIMD_X86
+  if (__builtin_cpu_supports("avx")) {
+    return sum_avx_f32(*self, n);
+  }
+#endif
+  return reduce_scalar_f32(*self, n, REDUCE_SUM);
+}
+
+float vector_min_f32(vector(float) * self) {
+  size_t n = vector_simd_len(*self);
+#ifdef VECTOR_SIMD_X86
+  if (__builtin_cpu_supports("avx")) {
+    return min_avx_f32(*self, n);
+  }
+#endif
+  return reduce_scalar_f32(*self, n, REDUCE_MIN);
+}
+
+float vector_max_f32(vector(float) * self) {
+  size_t n = vector_simd_len(*self);
+#ifdef VECTOR_SIMD_X86
+  if (__builtin_cpu_supports("avx")) {
+    return max_avx_f32(*self, n);
+  }
+#endif
+  return reduce_scalar_f32(*self, n, REDUCE_MAX);
+}
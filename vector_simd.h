@@ -0,0 +1,53 @@
+#ifndef VECTOR_SIMD_H_
+#define VECTOR_SIMD_H_
+
+/*!
+ * Reductions over vector(float) and vector(double) (see vector.h) that
+ * process several elements per instruction.
+ *
+ * On x86-64 CPUs with AVX they use 256 bit loads, four of them in flight per
+ * step. The loads are aligned: elements before the first 32 byte boundary
+ * are handled one at a time, so they are fastest on vectors created with
+ * vector_new_aligned, where there are none. Other CPUs and architectures,
+ * and builds with -DVEC_DISABLE_SIMD, use a plain loop.
+ *
+ * The sums add the elements in a different order than a plain loop, so the
+ * result can differ from one in the last bits. If a vector contains NaN,
+ * its min and max are unspecified.
+ */
+
+#include "./vector.h"
+
+// Synopsis:
+//   double vector_sum_f64(vector(double)* self);
+//   float vector_sum_f32(vector(float)* self);
+//
+// Description:
+// Returns the sum of the elements of the vector, 0 if it is empty.
+//
+// example:
+// vector(double) v = vector_new_aligned(double, 0, NULL);
+// ...
+// double total = vector_sum_f64(&v);
+double vector_sum_f64(vector(double) * self);
+float vector_sum_f32(vector(float) * self);
+
+// Synopsis:
+//   double vector_min_f64(vector(double)* self);
+//   float vector_min_f32(vector(float)* self);
+//
+// Description:
+// Returns the smallest element of the vector, +INFINITY if it is empty.
+double vector_min_f64(vector(double) * self);
+float vector_min_f32(vector(float) * self);
+
+// Synopsis:
+//   double vector_max_f64(vector(double)* self);
+//   float vector_max_f32(vector(float)* self);
+//
+// Description:
+// Returns the largest element of the vector, -INFINITY if it is empty.
+double vector_max_f64(vector(double) * self);
+float vector_max_f32(vector(float) * self);
+
+#endif  // VECTOR_SIMD_H_